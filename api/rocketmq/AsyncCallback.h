@@ -44,6 +44,18 @@ public:
 
   virtual void onSuccess(const PullResult& pull_result) noexcept = 0;
 
+  /**
+   * @brief Invoked in place of the const overload when the result is handed over. Override it to take ownership of
+   * the pulled messages without copying their bodies.
+   *
+   * Adding this overload changed the vtable of PullCallback: subclasses built against earlier headers must be
+   * recompiled. Subclasses overriding the const overload only should declare `using PullCallback::onSuccess;` to keep
+   * this one visible.
+   */
+  virtual void onSuccess(PullResult&& pull_result) noexcept {
+    onSuccess(static_cast<const PullResult&>(pull_result));
+  }
+
   virtual void onFailure(const std::error_code& ec) noexcept = 0;
 };
 
@@ -59,6 +59,24 @@ struct OffsetQuery {
   std::chrono::system_clock::time_point time_point;
 };
 
+/**
+ * @brief Estimated backlog of a message queue, as of the last lag sample.
+ */
+struct QueueLag {
+  MQMessageQueue message_queue;
+
+  // Offset of the next message to consume.
+  int64_t consumed_offset;
+
+  // Offset of the next message to be produced, as reported by broker.
+  int64_t end_offset;
+
+  // Messages yet to consume, that is, end_offset - consumed_offset clamped to zero.
+  int64_t lag;
+
+  std::chrono::system_clock::time_point sampled_at;
+};
+
 struct PullMessageQuery {
   MQMessageQueue message_queue;
   int64_t offset;
@@ -17,7 +17,10 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <system_error>
 #include <vector>
 
@@ -106,8 +109,38 @@ public:
   void sendOneway(MQMessage& message, const MQMessageQueue& message_queue);
   void sendOneway(MQMessage& message, MessageQueueSelector* selector, void* arg);
 
+  /**
+   * Send message once delay elapses. Unlike delivery timestamp and delay level, which broker honors, the message is
+   * held by this producer, to within 10ms of its delay, and is not sent if the producer shuts down first. Requires
+   * setDelayedSendMemoryBudget().
+   * @param message Message to send.
+   * @param delay Time to hold the message before sending it.
+   * @param send_callback Callback to execute on completion of message sending, or on failure to hold the message.
+   */
+  void sendDelayed(const MQMessage& message, std::chrono::milliseconds delay, SendCallback* send_callback);
+
+  /**
+   * Cancel a message held by sendDelayed(). Its callback fails with std::errc::operation_canceled.
+   * @param message_id Id of the message.
+   * @return false if the message is being or has been sent, or is unknown.
+   */
+  bool cancelDelayed(const std::string& message_id);
+
   void setLocalTransactionStateChecker(LocalTransactionStateCheckerPtr checker);
 
+  /**
+   * Local transaction state checks run on dedicated threads, 2 by default, with up to 1024 checks pending. Checks
+   * beyond capacity, or for a transaction being checked already, are dropped and broker asks again later. Must be
+   * called prior to start().
+   */
+  void setTransactionCheckExecutor(uint16_t thread_count, std::size_t capacity);
+
+  /**
+   * Enable sendDelayed(), holding messages whose bodies take up to memory_budget bytes in total. Messages beyond the
+   * budget fail with ErrorCode::TooManyRequest. Must be called prior to start().
+   */
+  void setDelayedSendMemoryBudget(uint64_t memory_budget);
+
   void setNamesrvAddr(const std::string& name_server_address_list);
 
   void setNameServerListDiscoveryEndpoint(const std::string& discovery_endpoint);
@@ -25,6 +25,7 @@
 #include "AsyncCallback.h"
 #include "ConsumeType.h"
 #include "CredentialsProvider.h"
+#include "ExpressionType.h"
 #include "MQMessageExt.h"
 #include "MQMessageQueue.h"
 
@@ -48,6 +49,22 @@ public:
 
   void pull(const PullMessageQuery& request, PullCallback* callback);
 
+  /**
+   * Only return messages of the topic that match the given expression. Pulled messages are filtered on client side
+   * too, so that unfiltered or loosely filtered traffic does not reach application.
+   * @param topic Topic to filter
+   * @param expression Tag expression, like "TagA || TagB", or SQL92 expression over message properties.
+   * @param expression_type Type of the expression.
+   */
+  void subscribe(const std::string& topic, const std::string& expression,
+                 ExpressionType expression_type = ExpressionType::TAG);
+
+  /**
+   * Backlog of each queue pulled from, as of the last lag sample, taken every 30s. Messages before the offset to pull
+   * next are regarded as consumed.
+   */
+  std::vector<QueueLag> queueLags() const;
+
   void setResourceNamespace(const std::string& resource_namespace);
 
   void setNamesrvAddr(const std::string& name_srv);
@@ -16,12 +16,17 @@
  */
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "AsyncCallback.h"
 #include "ConsumeType.h"
 #include "CredentialsProvider.h"
+#include "DuplicateAction.h"
 #include "ExpressionType.h"
 #include "Logger.h"
 #include "MQMessageQueue.h"
@@ -40,8 +45,21 @@ public:
 
   ~DefaultMQPushConsumer() = default;
 
+  /**
+   * Start the consumer, returning once the first round of queue assignments completes or the start-up timeout
+   * elapses, whichever comes first.
+   */
   void start();
 
+  /**
+   * Start the consumer without blocking. Routes of subscribed topics are fetched in parallel and assignment of each
+   * topic is queried as soon as its route arrives, so messages start flowing from the first assigned queues while
+   * others are still being resolved. A start-latency breakdown is logged when ready.
+   * @return Future that becomes ready once every subscribed topic completes, or fails, its first assignment round.
+   * Failed topics are retried in the background.
+   */
+  std::future<void> startAsync();
+
   void shutdown();
 
   void subscribe(const std::string& topic, const std::string& expression,
@@ -59,6 +77,90 @@ public:
 
   void setConsumeThreadCount(int thread_count);
 
+  /**
+   * Enable elastic consume thread pool. The pool starts with the consume thread count and grows up to
+   * max_thread_count when consumption falls behind, then shrinks back after idling for a while.
+   * @param max_thread_count Upper bound of the consume thread pool size.
+   */
+  void setMaxConsumeThreadCount(int max_thread_count);
+
+  /**
+   * Retry messages that the listener fails to consume locally, with exponential backoff, before returning them to
+   * broker. Local retries never exceed the invisible duration of the message; exhausted messages are redelivered by
+   * broker as usual.
+   * @param max_local_attempts Maximum number of local attempts per message. 0, the default, disables local retry.
+   * @param initial_backoff Backoff before the first local attempt, doubled for each subsequent one.
+   */
+  void setLocalRetry(int max_local_attempts,
+                     std::chrono::milliseconds initial_backoff = std::chrono::milliseconds(100));
+
+  /**
+   * Suppress redeliveries of messages already consumed successfully by this consumer, which follow expiry of invisible
+   * duration or rebalance. Ids of consumed messages are remembered within the given window and capacity, and hit-rate
+   * is logged periodically. Disabled by default.
+   * @param window How long ids of consumed messages are remembered; zero disables deduplication.
+   * @param capacity Maximum number of ids remembered, bounding memory footprint.
+   * @param action DROP acknowledges duplicates without consuming them; FLAG hands them to the listener with property
+   * DUPLICATE_PROPERTY_KEY set.
+   */
+  void setDeduplication(std::chrono::milliseconds window, std::size_t capacity = 65536,
+                        DuplicateAction action = DuplicateAction::DROP);
+
+  /**
+   * Duration that received messages stay invisible to other consumers of the group. Messages not acked within it are
+   * redelivered. Invisible duration of messages being consumed is extended automatically, so a shorter one mainly
+   * speeds up redelivery of messages held by a crashed consumer.
+   * @param invisible_duration Invisible duration, 30s by default.
+   */
+  void setInvisibleDuration(std::chrono::milliseconds invisible_duration);
+
+  /**
+   * Bound the time shutdown() spends draining. While draining, listener calls in progress and their acknowledgements
+   * are allowed to complete, and messages received but not yet consumed are released back to broker for immediate
+   * redelivery instead of waiting for their invisible duration to elapse.
+   * @param drain_timeout Maximum drain time, 5s by default; zero shuts down without draining.
+   */
+  void setDrainTimeout(std::chrono::milliseconds drain_timeout);
+
+  /**
+   * Bound the time start() blocks. Once it elapses, start() returns and logs which routes and assignments are still
+   * pending; they keep being resolved in the background.
+   * @param startup_timeout Maximum time start() blocks, 10s by default.
+   */
+  void setStartupTimeout(std::chrono::milliseconds startup_timeout);
+
+  /**
+   * Stop receiving messages of the topic, e.g. while a downstream system recovers, without blocking consume threads.
+   * Assignments and messages already received are kept; the latter are still consumed.
+   * @param topic Topic to pause.
+   */
+  void pause(const std::string& topic);
+
+  /**
+   * Stop receiving messages from the given queue.
+   * @param message_queue Queue to pause.
+   */
+  void pause(const MQMessageQueue& message_queue);
+
+  /**
+   * Resume receiving messages of the topic immediately, including queues of it paused individually.
+   * @param topic Topic to resume.
+   */
+  void resume(const std::string& topic);
+
+  /**
+   * Resume receiving messages from the given queue immediately, unless its topic remains paused.
+   * @param message_queue Queue to resume.
+   */
+  void resume(const MQMessageQueue& message_queue);
+
+  /**
+   * Backlog of each queue as of the last lag sample, taken every 30s. Consumed offset of a queue is estimated on client
+   * side, from offsets of messages pulled, in broadcasting mode, or received, in clustering mode, less those not yet
+   * consumed.
+   */
+  std::vector<QueueLag> queueLags() const;
+
   void setInstanceName(const std::string& instance_name);
 
   int getProcessQueueTableSize();
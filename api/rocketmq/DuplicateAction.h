@@ -0,0 +1,43 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief What a push consumer does with a redelivered message that it has already consumed successfully.
+ */
+enum class DuplicateAction : int8_t
+{
+  /**
+   * @brief Acknowledge the message without handing it to the listener.
+   */
+  DROP = 0,
+
+  /**
+   * @brief Hand the message to the listener with property DUPLICATE_PROPERTY_KEY set to "true".
+   */
+  FLAG = 1,
+};
+
+const char* const DUPLICATE_PROPERTY_KEY = "__RMQ_DUPLICATE";
+
+ROCKETMQ_NAMESPACE_END
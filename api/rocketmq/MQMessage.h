@@ -46,6 +46,12 @@ public:
   MQMessage(const MQMessage& other);
   MQMessage& operator=(const MQMessage& other);
 
+  /**
+   * @brief Steal the content of other. A moved-from message may only be assigned to or destroyed.
+   */
+  MQMessage(MQMessage&& other) noexcept;
+  MQMessage& operator=(MQMessage&& other) noexcept;
+
   const std::string& getMsgId() const;
 
   void setProperty(const std::string& name, const std::string& value);
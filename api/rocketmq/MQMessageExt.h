@@ -32,6 +32,10 @@ public:
 
   MQMessageExt& operator=(const MQMessageExt& other);
 
+  MQMessageExt(MQMessageExt&& other) noexcept;
+
+  MQMessageExt& operator=(MQMessageExt&& other) noexcept;
+
   int32_t getQueueId() const;
 
   /**
@@ -29,6 +29,14 @@ Status AdminClient::changeLogLevel(const rmq::ChangeLogLevelRequest& request, rm
   return status;
 }
 
+Status AdminClient::dumpLockContention(const rmq::DumpLockContentionRequest& request,
+                                       rmq::DumpLockContentionResponse& response) {
+  grpc::ClientContext context;
+  auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(3);
+  context.set_deadline(deadline);
+  return stub_->DumpLockContention(&context, request, &response);
+}
+
 } // namespace admin
 
 ROCKETMQ_NAMESPACE_END
@@ -67,6 +75,7 @@ void wrapChangeLogLevelRequest(rmq::ChangeLogLevelRequest& request, const std::s
 int main(int argc, char* argv[]) {
   if (argc <= 1) {
     std::cerr << "Usage: 'admin_client level [port]' where level is among trace/debug/info/warn/error.\n";
+    std::cerr << "       'admin_client contention [port]' to dump lock contention, enabling profiling if needed.\n";
     return EXIT_SUCCESS;
   }
 
@@ -96,6 +105,20 @@ int main(int argc, char* argv[]) {
   auto channel = grpc::CreateChannel(target, grpc::InsecureChannelCredentials());
   rocketmq::admin::AdminClient client(channel);
 
+  if (std::string("contention") == argv[1]) {
+    rmq::DumpLockContentionRequest request;
+    request.set_enable(true);
+    rmq::DumpLockContentionResponse response;
+    auto status = client.dumpLockContention(request, response);
+    if (status.ok()) {
+      std::cout << response.report() << std::endl;
+    } else {
+      std::cerr << "Failed to dump lock contention. GRPC error code: " << status.error_code()
+                << ", GRPC error message: " << status.error_message() << "\n";
+    }
+    return EXIT_SUCCESS;
+  }
+
   rmq::ChangeLogLevelRequest request;
   wrapChangeLogLevelRequest(request, argv[1]);
   rmq::ChangeLogLevelResponse response;
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "AdminServiceImpl.h"
+#include "LockContention.h"
 #include "spdlog/spdlog.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
@@ -60,6 +61,16 @@ Status AdminServiceImpl::ChangeLogLevel(ServerContext* context, const rmq::Chang
   return status;
 }
 
+Status AdminServiceImpl::DumpLockContention(ServerContext* context, const rmq::DumpLockContentionRequest* request,
+                                            rmq::DumpLockContentionResponse* reply) {
+  LockContention& lock_contention = LockContention::instance();
+  if (request->enable() && !lock_contention.enabled()) {
+    lock_contention.enable();
+  }
+  lock_contention.report(*reply->mutable_report(), request->reset());
+  return grpc::Status::OK;
+}
+
 } // namespace admin
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
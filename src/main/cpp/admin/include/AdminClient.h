@@ -36,6 +36,8 @@ public:
 
   Status changeLogLevel(const rmq::ChangeLogLevelRequest& request, rmq::ChangeLogLevelResponse& response);
 
+  Status dumpLockContention(const rmq::DumpLockContentionRequest& request, rmq::DumpLockContentionResponse& response);
+
 private:
   std::unique_ptr<rmq::Admin::Stub> stub_;
 };
@@ -30,6 +30,9 @@ class AdminServiceImpl final : public rmq::Admin::Service {
 public:
   Status ChangeLogLevel(ServerContext* context, const rmq::ChangeLogLevelRequest* request,
                         rmq::ChangeLogLevelResponse* reply) override;
+
+  Status DumpLockContention(ServerContext* context, const rmq::DumpLockContentionRequest* request,
+                            rmq::DumpLockContentionResponse* reply) override;
 };
 } // namespace admin
 
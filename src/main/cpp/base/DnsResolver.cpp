@@ -88,9 +88,11 @@ void DnsResolver::resolve(const std::vector<std::string>& list) {
 }
 
 absl::optional<std::string> DnsResolver::lookupIP(absl::string_view ip) {
-  absl::MutexLock lk(&ip_domain_map_mtx_);
-  if (ip_domain_map_.contains(ip)) {
-    return {ip_domain_map_[ip]};
+  lookups_.fetch_add(1, std::memory_order_relaxed);
+  absl::ReaderMutexLock lk(&ip_domain_map_mtx_);
+  auto search = ip_domain_map_.find(ip);
+  if (ip_domain_map_.end() != search) {
+    return {search->second};
   }
   return {};
 }
@@ -0,0 +1,283 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LockContention.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/cycleclock.h"
+#include "absl/strings/str_format.h"
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+const std::size_t LockContention::MAX_SITES = 64;
+
+const std::size_t LockContention::MAX_TRACKED_MUTEXES = 8192;
+
+namespace {
+
+const std::uintptr_t EMPTY_SLOT = 0;
+
+const std::uintptr_t DELETED_SLOT = 1;
+
+const std::uint32_t OTHER_SITE = 0;
+
+// Tombstones lengthen every probe passing them, notably those of untracked mutexes, which run to an empty slot.
+const std::size_t MAX_DELETED_SLOTS = 1024;
+
+std::size_t slotOf(std::uintptr_t address) {
+  return std::hash<std::uintptr_t>()(address >> 3) % LockContention::MAX_TRACKED_MUTEXES;
+}
+
+} // namespace
+
+LockContention::Site::Site(const char* name) : name(name), histogram("Wait-Time", 7) {
+  histogram.labels().emplace_back("[0us~1us): ");
+  histogram.labels().emplace_back("[1us~10us): ");
+  histogram.labels().emplace_back("[10us~100us): ");
+  histogram.labels().emplace_back("[100us~1ms): ");
+  histogram.labels().emplace_back("[1ms~10ms): ");
+  histogram.labels().emplace_back("[10ms~100ms): ");
+  histogram.labels().emplace_back("[100ms~inf): ");
+}
+
+LockContention::LockContention()
+    : nanos_per_cycle_(1e9 / absl::base_internal::CycleClock::Frequency()),
+      sites_(new std::atomic<Site*>[MAX_SITES]), slots_(new Slot[MAX_TRACKED_MUTEXES]) {
+  for (std::size_t i = 0; i < MAX_SITES; i++) {
+    sites_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  sites_[OTHER_SITE].store(new Site("other"), std::memory_order_release);
+  site_count_ = 1;
+
+  const char* env = getenv("ROCKETMQ_LOCK_CONTENTION");
+  if (env && (!strcmp(env, "true") || !strcmp(env, "1"))) {
+    enable();
+  }
+}
+
+LockContention& LockContention::instance() {
+  // Leaked on purpose: the registered tracer may fire during static destruction.
+  static LockContention* profiler = new LockContention();
+  return *profiler;
+}
+
+void LockContention::trace(const char* msg, const void* obj, std::int64_t wait_cycles) {
+  instance().onContention(obj, wait_cycles);
+}
+
+void LockContention::enable() {
+  bool expected = false;
+  if (tracer_registered_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+    absl::RegisterMutexTracer(&LockContention::trace);
+  }
+  enabled_.store(true, std::memory_order_relaxed);
+  SPDLOG_INFO("Mutex contention profiling enabled");
+}
+
+void LockContention::disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+  SPDLOG_INFO("Mutex contention profiling disabled");
+}
+
+void LockContention::track(const absl::Mutex* mutex, const char* site) {
+  if (!enabled()) {
+    return;
+  }
+
+  std::uint32_t index = OTHER_SITE;
+  {
+    absl::MutexLock lk(&sites_mtx_);
+    for (std::uint32_t i = 0; i < site_count_; i++) {
+      if (!strcmp(sites_[i].load(std::memory_order_relaxed)->name, site)) {
+        index = i;
+        break;
+      }
+    }
+
+    if (OTHER_SITE == index) {
+      if (site_count_ >= MAX_SITES) {
+        SPDLOG_WARN("Too many lock sites. Contention of {} is attributed to other", site);
+        return;
+      }
+      index = site_count_++;
+      sites_[index].store(new Site(site), std::memory_order_release);
+    }
+  }
+
+  auto address = reinterpret_cast<std::uintptr_t>(mutex);
+  absl::MutexLock lk(&slots_mtx_);
+  if (insert(address, index)) {
+    tracked_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  SPDLOG_DEBUG("Lock contention table is full. Contention of {} is attributed to other", site);
+}
+
+bool LockContention::insert(std::uintptr_t address, std::uint32_t site) {
+  std::size_t start = slotOf(address);
+  for (std::size_t i = 0; i < MAX_TRACKED_MUTEXES; i++) {
+    Slot& slot = slots_[(start + i) % MAX_TRACKED_MUTEXES];
+    std::uintptr_t current = slot.mutex.load(std::memory_order_relaxed);
+    if (EMPTY_SLOT != current && DELETED_SLOT != current) {
+      continue;
+    }
+
+    if (DELETED_SLOT == current) {
+      deleted_slots_--;
+    }
+    // Publish site before address such that probing readers never see a stale site.
+    slot.site.store(site, std::memory_order_relaxed);
+    slot.mutex.store(address, std::memory_order_release);
+    return true;
+  }
+  return false;
+}
+
+void LockContention::untrack(const absl::Mutex* mutex) {
+  // Mutexes are tracked only while profiling, so most clients find the table empty.
+  if (!tracked_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  auto address = reinterpret_cast<std::uintptr_t>(mutex);
+  absl::MutexLock lk(&slots_mtx_);
+  std::size_t start = slotOf(address);
+  for (std::size_t i = 0; i < MAX_TRACKED_MUTEXES; i++) {
+    std::size_t index = (start + i) % MAX_TRACKED_MUTEXES;
+    std::uintptr_t current = slots_[index].mutex.load(std::memory_order_relaxed);
+    if (EMPTY_SLOT == current) {
+      return;
+    }
+
+    if (address != current) {
+      continue;
+    }
+
+    tracked_.fetch_sub(1, std::memory_order_relaxed);
+    if (EMPTY_SLOT != slots_[(index + 1) % MAX_TRACKED_MUTEXES].mutex.load(std::memory_order_relaxed)) {
+      slots_[index].mutex.store(DELETED_SLOT, std::memory_order_relaxed);
+      if (++deleted_slots_ >= MAX_DELETED_SLOTS) {
+        rehash();
+      }
+      return;
+    }
+
+    // Probes stop at the empty slot next to it anyway: the slot, along with tombstones right before it, may be
+    // emptied without hiding any tracked mutex.
+    slots_[index].mutex.store(EMPTY_SLOT, std::memory_order_relaxed);
+    for (std::size_t prev = (index + MAX_TRACKED_MUTEXES - 1) % MAX_TRACKED_MUTEXES;
+         DELETED_SLOT == slots_[prev].mutex.load(std::memory_order_relaxed);
+         prev = (prev + MAX_TRACKED_MUTEXES - 1) % MAX_TRACKED_MUTEXES) {
+      slots_[prev].mutex.store(EMPTY_SLOT, std::memory_order_relaxed);
+      deleted_slots_--;
+    }
+    return;
+  }
+}
+
+void LockContention::rehash() {
+  std::vector<std::pair<std::uintptr_t, std::uint32_t>> tracked;
+  for (std::size_t i = 0; i < MAX_TRACKED_MUTEXES; i++) {
+    std::uintptr_t current = slots_[i].mutex.load(std::memory_order_relaxed);
+    if (EMPTY_SLOT != current && DELETED_SLOT != current) {
+      tracked.emplace_back(current, slots_[i].site.load(std::memory_order_relaxed));
+    }
+    slots_[i].mutex.store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+  deleted_slots_ = 0;
+
+  for (const auto& item : tracked) {
+    insert(item.first, item.second);
+  }
+  SPDLOG_DEBUG("Rehashed lock contention table, {} mutexes tracked", tracked.size());
+}
+
+std::uint32_t LockContention::siteOf(const void* mutex) const {
+  auto address = reinterpret_cast<std::uintptr_t>(mutex);
+  std::size_t start = slotOf(address);
+  for (std::size_t i = 0; i < MAX_TRACKED_MUTEXES; i++) {
+    const Slot& slot = slots_[(start + i) % MAX_TRACKED_MUTEXES];
+    std::uintptr_t current = slot.mutex.load(std::memory_order_acquire);
+    if (address == current) {
+      return slot.site.load(std::memory_order_relaxed);
+    }
+
+    if (EMPTY_SLOT == current) {
+      break;
+    }
+  }
+  return OTHER_SITE;
+}
+
+void LockContention::onContention(const void* mutex, std::int64_t wait_cycles) {
+  if (!enabled()) {
+    return;
+  }
+
+  Site* site = sites_[siteOf(mutex)].load(std::memory_order_acquire);
+  auto nanos = static_cast<std::int64_t>(wait_cycles * nanos_per_cycle_);
+  site->contentions.fetch_add(1, std::memory_order_relaxed);
+  site->wait_nanos.fetch_add(nanos, std::memory_order_relaxed);
+
+  int grade = 0;
+  for (std::int64_t micros = nanos / 1000; micros > 0; micros /= 10) {
+    grade++;
+  }
+  site->histogram.countIn(grade);
+}
+
+void LockContention::report(std::string& result, bool reset) {
+  std::vector<Site*> sites;
+  {
+    absl::MutexLock lk(&sites_mtx_);
+    for (std::uint32_t i = 0; i < site_count_; i++) {
+      Site* site = sites_[i].load(std::memory_order_relaxed);
+      if (site->contentions.load(std::memory_order_relaxed)) {
+        sites.push_back(site);
+      }
+    }
+  }
+
+  std::sort(sites.begin(), sites.end(), [](const Site* lhs, const Site* rhs) {
+    return lhs->wait_nanos.load(std::memory_order_relaxed) > rhs->wait_nanos.load(std::memory_order_relaxed);
+  });
+
+  result.clear();
+  result.append(absl::StrFormat("Lock-Contention: enabled=%s, sites=%d", enabled() ? "true" : "false", sites.size()));
+  for (Site* site : sites) {
+    std::int64_t contentions = reset ? site->contentions.exchange(0, std::memory_order_relaxed)
+                                     : site->contentions.load(std::memory_order_relaxed);
+    std::int64_t wait_nanos = reset ? site->wait_nanos.exchange(0, std::memory_order_relaxed)
+                                    : site->wait_nanos.load(std::memory_order_relaxed);
+    std::string histogram;
+    if (reset) {
+      site->histogram.reportAndReset(histogram);
+    } else {
+      site->histogram.report(histogram);
+    }
+    result.append(absl::StrFormat("\n  %s: contentions=%d, wait=%dus, %s", site->name, contentions, wait_nanos / 1000,
+                                  histogram));
+  }
+}
+
+ROCKETMQ_NAMESPACE_END
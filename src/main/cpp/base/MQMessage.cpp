@@ -23,6 +23,7 @@
 #include "UtilAll.h"
 #include "rocketmq/MQMessageExt.h"
 #include <chrono>
+#include <utility>
 
 ROCKETMQ_NAMESPACE_BEGIN
 
@@ -66,10 +67,23 @@ MQMessage& MQMessage::operator=(const MQMessage& other) {
   if (this == &other) {
     return *this;
   }
+  if (!impl_) {
+    impl_ = new MessageImpl(*other.impl_);
+    return *this;
+  }
   *impl_ = *(other.impl_);
   return *this;
 }
 
+MQMessage::MQMessage(MQMessage&& other) noexcept : impl_(other.impl_) {
+  other.impl_ = nullptr;
+}
+
+MQMessage& MQMessage::operator=(MQMessage&& other) noexcept {
+  std::swap(impl_, other.impl_);
+  return *this;
+}
+
 const std::string& MQMessage::getMsgId() const {
   return impl_->system_attribute_.message_id;
 }
@@ -17,6 +17,8 @@
 #include "rocketmq/MQMessageExt.h"
 #include "MessageImpl.h"
 
+#include <utility>
+
 ROCKETMQ_NAMESPACE_BEGIN
 
 MQMessageExt::MQMessageExt() : MQMessage() {
@@ -26,11 +28,15 @@ MQMessageExt::MQMessageExt(const MQMessageExt& other) : MQMessage(other) {
 }
 
 MQMessageExt& MQMessageExt::operator=(const MQMessageExt& other) {
-  if (this == &other) {
-    return *this;
-  }
+  MQMessage::operator=(other);
+  return *this;
+}
+
+MQMessageExt::MQMessageExt(MQMessageExt&& other) noexcept : MQMessage(std::move(other)) {
+}
 
-  *impl_ = *(other.impl_);
+MQMessageExt& MQMessageExt::operator=(MQMessageExt&& other) noexcept {
+  MQMessage::operator=(std::move(other));
   return *this;
 }
 
@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MemoryQuota.h"
+
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+void MemoryQuota::acquire(std::uint64_t bytes) {
+  used_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryQuota::release(std::uint64_t bytes) {
+  std::uint64_t used = used_.load(std::memory_order_relaxed);
+  std::uint64_t remaining;
+  do {
+    if (bytes > used) {
+      SPDLOG_WARN("Releasing {} bytes, which exceeds {} bytes in use", bytes, used);
+      remaining = 0;
+    } else {
+      remaining = used - bytes;
+    }
+  } while (!used_.compare_exchange_weak(used, remaining, std::memory_order_relaxed));
+}
+
+bool MemoryQuota::nearLimit() const {
+  std::uint64_t limit = limit_.load(std::memory_order_relaxed);
+  if (!limit) {
+    // Unlimited
+    return false;
+  }
+  return used_.load(std::memory_order_relaxed) >= static_cast<std::uint64_t>(limit * high_watermark_);
+}
+
+ROCKETMQ_NAMESPACE_END
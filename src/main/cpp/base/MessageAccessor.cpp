@@ -68,6 +68,10 @@ void MessageAccessor::setInvisiblePeriod(MQMessageExt& message, absl::Duration i
   message.impl_->system_attribute_.invisible_period = invisible_period;
 }
 
+absl::Duration MessageAccessor::invisiblePeriod(const MQMessageExt& message) {
+  return message.impl_->system_attribute_.invisible_period;
+}
+
 void MessageAccessor::setReceiptHandle(MQMessageExt& message, std::string receipt_handle) {
   message.impl_->system_attribute_.receipt_handle = std::move(receipt_handle);
 }
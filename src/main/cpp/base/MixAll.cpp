@@ -44,7 +44,14 @@ const uint32_t MixAll::MAX_MESSAGE_BODY_SIZE = 1024 * 1024 * 4;
 const uint32_t MixAll::MAX_CACHED_MESSAGE_COUNT = 65535;
 const uint32_t MixAll::DEFAULT_CACHED_MESSAGE_COUNT = 1024;
 const uint64_t MixAll::DEFAULT_CACHED_MESSAGE_MEMORY = 128L * 1024 * 1024;
+const uint64_t MixAll::DEFAULT_MEMORY_QUOTA = 4 * MixAll::DEFAULT_CACHED_MESSAGE_MEMORY;
 const uint32_t MixAll::DEFAULT_CONSUME_THREAD_POOL_SIZE = 20;
+const uint16_t MixAll::DEFAULT_TRANSACTION_CHECK_THREAD_POOL_SIZE = 2;
+const uint32_t MixAll::DEFAULT_TRANSACTION_CHECK_CAPACITY = 1024;
+const std::chrono::seconds MixAll::LAG_SAMPLE_INTERVAL = std::chrono::seconds(30);
+const uint32_t MixAll::LAG_SAMPLE_INFLIGHT_PER_BROKER = 8;
+const std::chrono::milliseconds MixAll::DELAYED_SEND_TICK = std::chrono::milliseconds(10);
+const uint32_t MixAll::DELAYED_SEND_WHEEL_SIZE = 512;
 const uint32_t MixAll::DEFAULT_CONSUME_MESSAGE_BATCH_SIZE = 1;
 const int32_t MixAll::DEFAULT_MAX_DELIVERY_ATTEMPTS = 16;
 
@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ThreadPlacement.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "spdlog/spdlog.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+namespace {
+
+absl::Mutex cpu_sets_mtx;
+absl::flat_hash_map<std::uint8_t, std::vector<int>>& cpuSets() EXCLUSIVE_LOCKS_REQUIRED(cpu_sets_mtx) {
+  static absl::flat_hash_map<std::uint8_t, std::vector<int>> cpu_sets;
+  return cpu_sets;
+}
+
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+// Value of MPOL_LOCAL from linux/mempolicy.h; libnuma headers are not required.
+const int MEMORY_POLICY_LOCAL = 4;
+#endif
+
+} // namespace
+
+void ThreadPlacement::cpuSet(ThreadRole role, std::vector<int> cpus) {
+  absl::MutexLock lk(&cpu_sets_mtx);
+  if (cpus.empty()) {
+    // Clearing falls back to the environment variable of the role rather than shadowing it.
+    cpuSets().erase(static_cast<std::uint8_t>(role));
+    return;
+  }
+  cpuSets()[static_cast<std::uint8_t>(role)] = std::move(cpus);
+}
+
+std::vector<int> ThreadPlacement::configuredCpuSet(ThreadRole role) {
+  {
+    absl::MutexLock lk(&cpu_sets_mtx);
+    auto search = cpuSets().find(static_cast<std::uint8_t>(role));
+    if (search != cpuSets().end()) {
+      return search->second;
+    }
+  }
+
+  std::vector<int> cpus;
+  const char* env = environmentVariableOf(role);
+  const char* value = env ? getenv(env) : nullptr;
+  if (value && !parseCpuList(value, cpus)) {
+    SPDLOG_WARN("Ignore malformed CPU list {}={}", env, value);
+    cpus.clear();
+  }
+  return cpus;
+}
+
+std::vector<int> ThreadPlacement::cpuSet(ThreadRole role) {
+  std::vector<int> cpus = configuredCpuSet(role);
+  if (!cpus.empty()) {
+    return cpus;
+  }
+
+  switch (role) {
+    case ThreadRole::CompletionQueue:
+      return cpuSet(ThreadRole::Callback);
+    case ThreadRole::Callback:
+      return cpuSet(ThreadRole::Consume);
+    default:
+      return cpus;
+  }
+}
+
+void ThreadPlacement::apply(ThreadRole role, const std::string& name) {
+#if defined(__linux__)
+  // Linux limits thread name to 16 bytes, including the terminating null byte.
+  std::string thread_name = name.substr(0, 15);
+  pthread_setname_np(pthread_self(), thread_name.c_str());
+#elif defined(__APPLE__)
+  pthread_setname_np(name.c_str());
+#endif
+
+  std::vector<int> cpus = cpuSet(role);
+  if (cpus.empty()) {
+    return;
+  }
+
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (rc) {
+    SPDLOG_WARN("Failed to bind thread {} to CPU set. Cause: {}", name, strerror(rc));
+    return;
+  }
+
+#if defined(SYS_set_mempolicy)
+  // Allocate from the NUMA node the thread now runs on, even if the process-wide policy says otherwise.
+  if (syscall(SYS_set_mempolicy, MEMORY_POLICY_LOCAL, nullptr, 0)) {
+    SPDLOG_DEBUG("Failed to apply node-local memory policy for thread {}. Cause: {}", name, strerror(errno));
+  }
+#endif
+
+  SPDLOG_INFO("Thread {} is bound to {} CPU(s)", name, cpus.size());
+#else
+  SPDLOG_WARN("Binding threads to CPUs is not supported on this platform. Thread: {}", name);
+#endif
+}
+
+bool ThreadPlacement::parseCpuList(absl::string_view text, std::vector<int>& cpus) {
+  for (absl::string_view segment : absl::StrSplit(text, ',', absl::SkipWhitespace())) {
+    segment = absl::StripAsciiWhitespace(segment);
+    std::vector<absl::string_view> range = absl::StrSplit(segment, '-');
+    int begin = 0;
+    int end = 0;
+    switch (range.size()) {
+      case 1: {
+        if (!absl::SimpleAtoi(range[0], &begin)) {
+          return false;
+        }
+        end = begin;
+        break;
+      }
+      case 2: {
+        if (!absl::SimpleAtoi(range[0], &begin) || !absl::SimpleAtoi(range[1], &end)) {
+          return false;
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+
+    if (begin < 0 || end < begin) {
+      return false;
+    }
+
+    for (int cpu = begin; cpu <= end; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return !cpus.empty();
+}
+
+const char* ThreadPlacement::environmentVariableOf(ThreadRole role) {
+  switch (role) {
+    case ThreadRole::Scheduler:
+      return "ROCKETMQ_CPUSET_SCHEDULER";
+    case ThreadRole::Callback:
+      return "ROCKETMQ_CPUSET_CALLBACK";
+    case ThreadRole::Consume:
+      return "ROCKETMQ_CPUSET_CONSUME";
+    case ThreadRole::CompletionQueue:
+      return "ROCKETMQ_CPUSET_COMPLETION_QUEUE";
+    case ThreadRole::Exporter:
+      return "ROCKETMQ_CPUSET_EXPORTER";
+    default:
+      return nullptr;
+  }
+}
+
+ROCKETMQ_NAMESPACE_END
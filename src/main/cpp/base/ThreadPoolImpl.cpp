@@ -19,60 +19,143 @@
 #include "asio/executor_work_guard.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
+#include "fmt/format.h"
 #include "rocketmq/RocketMQ.h"
 #include "rocketmq/State.h"
 #include "spdlog/spdlog.h"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <system_error>
 
 ROCKETMQ_NAMESPACE_BEGIN
 
-ThreadPoolImpl::ThreadPoolImpl(std::uint16_t workers)
+ThreadPoolImpl::ThreadPoolImpl(std::uint16_t workers) : ThreadPoolImpl(workers, workers) {
+}
+
+ThreadPoolImpl::ThreadPoolImpl(std::uint16_t min_workers, std::uint16_t max_workers)
     : work_guard_(
           absl::make_unique<asio::executor_work_guard<asio::io_context::executor_type>>(context_.get_executor())),
-      workers_(workers) {
+      min_workers_(min_workers), max_workers_(std::max(min_workers, max_workers)), workers_(min_workers) {
 }
 
 void ThreadPoolImpl::start() {
-  for (std::uint16_t i = 0; i < workers_; i++) {
-    std::thread worker([this]() {
-      State expected = State::CREATED;
-      if (state_.compare_exchange_strong(expected, State::STARTED, std::memory_order_relaxed)) {
-        absl::MutexLock lk(&start_mtx_);
-        start_cv_.SignalAll();
-      }
+  {
+    absl::MutexLock lk(&workers_mtx_);
+    for (std::uint16_t i = 0; i < min_workers_; i++) {
+      spawn();
+    }
+  }
+
+  {
+    absl::MutexLock lk(&start_mtx_);
+    if (State::CREATED == state_.load(std::memory_order_relaxed)) {
+      start_cv_.Wait(&start_mtx_);
+    }
+  }
+}
+
+void ThreadPoolImpl::spawn() {
+  threads_.emplace_back(std::bind(&ThreadPoolImpl::loop, this));
+}
+
+void ThreadPoolImpl::loop() {
+  ThreadPlacement::apply(role_, fmt::format("{}-{}", name_, spawned_.fetch_add(1, std::memory_order_relaxed)));
+
+  State expected = State::CREATED;
+  if (state_.compare_exchange_strong(expected, State::STARTED, std::memory_order_relaxed)) {
+    absl::MutexLock lk(&start_mtx_);
+    start_cv_.SignalAll();
+  }
 
-      while (true) {
+  while (true) {
 #ifdef __EXCEPTIONS
-        try {
+    try {
 #endif
-          std::error_code ec;
-          context_.run(ec);
-          if (ec) {
-            SPDLOG_WARN("Error raised from ThreadPool: {}", ec.message());
-          }
+      std::error_code ec;
+      context_.run_one(ec);
+      if (ec) {
+        SPDLOG_WARN("Error raised from ThreadPool: {}", ec.message());
+      }
 #ifdef __EXCEPTIONS
-        } catch (std::exception& e) {
-          SPDLOG_WARN("Exception raised from ThreadPool: {}", e.what());
-        }
+    } catch (std::exception& e) {
+      SPDLOG_WARN("Exception raised from ThreadPool: {}", e.what());
+    }
 #endif
-        if (State::STARTED != state_.load(std::memory_order_relaxed)) {
-          SPDLOG_INFO("A thread-pool worker quit");
-          break;
-        }
+    if (State::STARTED != state_.load(std::memory_order_relaxed)) {
+      SPDLOG_INFO("A thread-pool worker quit");
+      break;
+    }
+
+    if (tryRetire()) {
+      absl::MutexLock lk(&workers_mtx_);
+      retired_.push_back(std::this_thread::get_id());
+      SPDLOG_DEBUG("A thread-pool worker retired");
+      break;
+    }
+  }
+}
+
+bool ThreadPoolImpl::tryRetire() {
+  std::uint16_t retiring = retiring_.load(std::memory_order_relaxed);
+  while (retiring) {
+    if (retiring_.compare_exchange_weak(retiring, retiring - 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPoolImpl::reapRetiredWorkers() {
+  for (const auto& id : retired_) {
+    for (auto it = threads_.begin(); it != threads_.end(); it++) {
+      if (it->get_id() == id) {
+        it->join();
+        threads_.erase(it);
+        break;
       }
-    });
-    threads_.emplace_back(std::move(worker));
+    }
   }
+  retired_.clear();
+}
 
-  {
-    absl::MutexLock lk(&start_mtx_);
-    if (State::CREATED == state_.load(std::memory_order_relaxed)) {
-      start_cv_.Wait(&start_mtx_);
+void ThreadPoolImpl::resize(std::uint16_t workers) {
+  if (State::STARTED != state_.load(std::memory_order_relaxed)) {
+    SPDLOG_WARN("State of ThreadPool is not STARTED");
+    return;
+  }
+
+  workers = std::max(min_workers_, std::min(workers, max_workers_));
+
+  absl::MutexLock lk(&workers_mtx_);
+  reapRetiredWorkers();
+
+  std::uint16_t current = workers_.load(std::memory_order_relaxed);
+  if (workers == current) {
+    return;
+  }
+
+  if (workers > current) {
+    std::uint16_t delta = workers - current;
+    // Workers scheduled to retire are still alive; keep them instead of spawning new ones.
+    while (delta && tryRetire()) {
+      delta--;
+    }
+    for (; delta; delta--) {
+      spawn();
+    }
+  } else {
+    std::uint16_t delta = current - workers;
+    retiring_.fetch_add(delta, std::memory_order_relaxed);
+    // Wake up idle workers such that they get a chance to retire.
+    for (std::uint16_t i = 0; i < delta; i++) {
+      asio::post(context_, []() {});
     }
   }
+  workers_.store(workers, std::memory_order_relaxed);
+  SPDLOG_INFO("ThreadPool resized from {} to {} workers", current, workers);
 }
 
 void ThreadPoolImpl::shutdown() {
@@ -80,7 +163,16 @@ void ThreadPoolImpl::shutdown() {
   if (state_.compare_exchange_strong(expected, State::STOPPING, std::memory_order_relaxed)) {
     work_guard_->reset();
     context_.stop();
-    for (auto& thread : threads_) {
+
+    // Retiring workers acquire workers_mtx_ on their way out; join them without holding it.
+    std::vector<std::thread> threads;
+    {
+      absl::MutexLock lk(&workers_mtx_);
+      threads.swap(threads_);
+      retired_.clear();
+    }
+
+    for (auto& thread : threads) {
       if (thread.joinable()) {
         thread.join();
       }
@@ -91,7 +183,31 @@ void ThreadPoolImpl::shutdown() {
 
 void ThreadPoolImpl::submit(std::function<void()> task) {
   if (State::STARTED == state_.load(std::memory_order_relaxed)) {
-    asio::post(context_, task);
+    backlog_.fetch_add(1, std::memory_order_relaxed);
+    auto enqueue_time = std::chrono::steady_clock::now();
+    asio::post(context_, [this, task, enqueue_time]() {
+      struct BusyGuard {
+        explicit BusyGuard(std::atomic<std::uint32_t>& busy) : busy_(busy) {
+          busy_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~BusyGuard() {
+          busy_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        std::atomic<std::uint32_t>& busy_;
+      } guard(busy_workers_);
+
+      // Mark the worker busy before the task leaves the backlog, such that idle() never misses a task in transit.
+      backlog_.fetch_sub(1, std::memory_order_relaxed);
+      std::int64_t delay =
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - enqueue_time)
+              .count();
+      std::int64_t max_delay = max_queueing_delay_.load(std::memory_order_relaxed);
+      while (delay > max_delay &&
+             !max_queueing_delay_.compare_exchange_weak(max_delay, delay, std::memory_order_relaxed)) {
+      }
+
+      task();
+    });
   } else {
     SPDLOG_WARN("State of ThreadPool is not STARTED");
   }
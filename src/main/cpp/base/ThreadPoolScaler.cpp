@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ThreadPoolScaler.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+ThreadPoolScaler::ThreadPoolScaler(ThreadPoolImpl& pool, ThreadPoolScalerOptions options)
+    : pool_(pool), options_(options) {
+}
+
+void ThreadPoolScaler::tick() {
+  std::uint16_t workers = pool_.workers();
+  std::uint32_t backlog = pool_.backlog();
+  std::uint32_t busy = pool_.busyWorkers();
+  std::chrono::microseconds queueing_delay = pool_.maxQueueingDelayAndReset();
+  max_queueing_delay_ = std::max(max_queueing_delay_, queueing_delay);
+
+  bool pressured = queueing_delay > options_.queueing_delay_threshold ||
+                   backlog > static_cast<std::uint32_t>(workers) * options_.backlog_per_worker_threshold;
+
+  // Hysteresis: the idle condition is deliberately much stricter than the negation of the pressured one.
+  bool idle = !backlog && busy * 2 <= workers && queueing_delay * 4 < options_.queueing_delay_threshold;
+
+  if (pressured) {
+    idle_ticks_ = 0;
+    pressured_ticks_++;
+  } else if (idle) {
+    pressured_ticks_ = 0;
+    idle_ticks_++;
+  } else {
+    pressured_ticks_ = 0;
+    idle_ticks_ = 0;
+  }
+
+  if (pressured_ticks_ >= options_.scale_up_ticks && workers < pool_.maxWorkers()) {
+    std::uint16_t step = std::max<std::uint16_t>(1, workers / 2);
+    std::uint16_t target = std::min<std::uint32_t>(pool_.maxWorkers(), workers + step);
+    SPDLOG_INFO("Grow thread pool from {} to {} workers. Backlog: {}, max queueing delay: {}us", workers, target,
+                backlog, queueing_delay.count());
+    pool_.resize(target);
+    scale_up_count_++;
+    pressured_ticks_ = 0;
+    return;
+  }
+
+  if (idle_ticks_ >= options_.scale_down_ticks && workers > pool_.minWorkers()) {
+    SPDLOG_INFO("Shrink thread pool from {} to {} workers after {} idle ticks", workers, workers - 1, idle_ticks_);
+    pool_.resize(workers - 1);
+    scale_down_count_++;
+    idle_ticks_ = 0;
+  }
+}
+
+void ThreadPoolScaler::reportAndReset(std::string& result) {
+  result = fmt::format("ThreadPool: workers={}, min={}, max={}, backlog={}, busy={}, max-queueing-delay={}us, "
+                       "scale-up={}, scale-down={}",
+                       pool_.workers(), pool_.minWorkers(), pool_.maxWorkers(), pool_.backlog(), pool_.busyWorkers(),
+                       max_queueing_delay_.count(), scale_up_count_, scale_down_count_);
+  max_queueing_delay_ = std::chrono::microseconds(0);
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "UniqueIdGenerator.h"
+#include "LockContention.h"
 #include "LoggerImpl.h"
 #include "MixAll.h"
 #include "UtilAll.h"
@@ -32,6 +33,7 @@ const uint8_t UniqueIdGenerator::VERSION = 1;
 UniqueIdGenerator::UniqueIdGenerator()
     : prefix_(), since_custom_epoch_(std::chrono::system_clock::now() - customEpoch()),
       start_time_point_(std::chrono::steady_clock::now()), seconds_(deltaSeconds()), sequence_(0) {
+  LockContention::instance().track(&mtx_, "UniqueIdGenerator::mtx_");
   std::vector<unsigned char> mac_address;
   if (UtilAll::macAddress(mac_address)) {
     memcpy(prefix_.data(), mac_address.data(), mac_address.size());
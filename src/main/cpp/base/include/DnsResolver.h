@@ -16,6 +16,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
@@ -37,11 +42,24 @@ public:
    */
   void resolve(const std::vector<std::string>& list);
 
+  /**
+   * @brief Map an IP back to the domain it was resolved from. It only consults what resolve() cached and never blocks
+   * on a name server.
+   */
   absl::optional<std::string> lookupIP(absl::string_view ip) LOCKS_EXCLUDED(ip_domain_map_mtx_);
 
+  /**
+   * @return Number of lookupIP() calls so far, for diagnostics.
+   */
+  std::uint64_t lookups() const {
+    return lookups_.load(std::memory_order_relaxed);
+  }
+
 private:
   absl::flat_hash_map<std::string, std::string> ip_domain_map_ GUARDED_BY(ip_domain_map_mtx_);
   absl::Mutex ip_domain_map_mtx_;
+
+  std::atomic<std::uint64_t> lookups_{0};
 };
 
 DnsResolver* dnsResolver();
@@ -57,7 +57,6 @@ public:
   }
 
   void reportAndReset(std::string& result) {
-    assert(labels_.size() == static_cast<std::vector<std::string>::size_type>(capacity_));
     std::vector<int32_t> values;
     values.reserve(capacity_);
     for (auto& item : data_) {
@@ -65,6 +64,21 @@ public:
       values.push_back(value);
       item->fetch_sub(value, std::memory_order_relaxed);
     }
+    render(values, result);
+  }
+
+  void report(std::string& result) const {
+    std::vector<int32_t> values;
+    values.reserve(capacity_);
+    for (const auto& item : data_) {
+      values.push_back(item->load(std::memory_order_relaxed));
+    }
+    render(values, result);
+  }
+
+private:
+  void render(const std::vector<int32_t>& values, std::string& result) const {
+    assert(labels_.size() == static_cast<std::vector<std::string>::size_type>(capacity_));
     result.clear();
     result.append(title_).append(":");
     for (std::vector<std::string>::size_type i = 0; i < labels_.size(); ++i) {
@@ -75,7 +89,6 @@ public:
     }
   }
 
-private:
   std::string title_;
   std::vector<std::unique_ptr<std::atomic<int32_t>>> data_;
   int32_t capacity_;
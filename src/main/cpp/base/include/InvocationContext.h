@@ -47,6 +47,15 @@ struct BaseInvocationContext {
 
   virtual ~BaseInvocationContext() = default;
   virtual void onCompletion(bool ok) = 0;
+
+  /**
+   * Bookkeeping tags, such as connectivity-state watches, complete on the completion-queue poller itself instead of
+   * the callback thread pool, so that they are reclaimed even once the pool is shut down.
+   */
+  virtual bool completesInline() const {
+    return false;
+  }
+
   std::string request_id_;
   std::string remote_address;
   grpc::ClientContext context;
@@ -54,6 +63,12 @@ struct BaseInvocationContext {
   std::string task_name;
   absl::Time created_time{absl::Now()};
   std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+
+  /**
+   * Timeout derived from latencies observed against the remote endpoint. Only short calls set it, in return for which
+   * their own latency is fed back; it stays zero for long-polling calls, which keep their full window.
+   */
+  std::chrono::milliseconds adaptive_timeout{0};
 };
 
 template <typename T>
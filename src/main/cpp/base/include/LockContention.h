@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/synchronization/mutex.h"
+
+#include "Histogram.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Opt-in contention profiling of absl::Mutex instances, aggregated by lock site.
+ *
+ * Once enabled, absl's mutex tracer reports every contended release along with how long waiters were blocked. Mutexes
+ * labelled through track() are attributed to their site, e.g. "ClientManagerImpl::rpc_clients_mtx_", and all others
+ * to "other". Wait time of each site is kept in a histogram, exposed through client stats and the admin server.
+ *
+ * Profiling is enabled by setting environment variable ROCKETMQ_LOCK_CONTENTION to "true" or "1", or through enable().
+ * absl allows the tracer to be registered once per process; disable() merely stops aggregation. Mutexes are labelled
+ * only while profiling is enabled, such that clients, queues and publish infos cost nothing otherwise.
+ */
+class LockContention {
+public:
+  static LockContention& instance();
+
+  void enable();
+
+  void disable();
+
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Attribute contention of the mutex to the site. Sites are expected to be string literals. No-op unless
+   * profiling is enabled.
+   */
+  void track(const absl::Mutex* mutex, const char* site) LOCKS_EXCLUDED(sites_mtx_, slots_mtx_);
+
+  /**
+   * @brief Expected to be called before the tracked mutex is destroyed.
+   */
+  void untrack(const absl::Mutex* mutex) LOCKS_EXCLUDED(slots_mtx_);
+
+  /**
+   * Expose for test purpose only.
+   */
+  std::size_t tombstones() LOCKS_EXCLUDED(slots_mtx_) {
+    absl::MutexLock lk(&slots_mtx_);
+    return deleted_slots_;
+  }
+
+  void onContention(const void* mutex, std::int64_t wait_cycles);
+
+  /**
+   * @brief Render sites that have seen contention, most waited-on first.
+   *
+   * @param reset Whether to clear statistics after rendering them.
+   */
+  void report(std::string& result, bool reset) LOCKS_EXCLUDED(sites_mtx_);
+
+  static const std::size_t MAX_SITES;
+  static const std::size_t MAX_TRACKED_MUTEXES;
+
+private:
+  LockContention();
+
+  struct Site {
+    explicit Site(const char* name);
+
+    const char* name;
+    std::atomic<std::int64_t> contentions{0};
+    std::atomic<std::int64_t> wait_nanos{0};
+    Histogram histogram;
+  };
+
+  /**
+   * @brief Open-addressing table from mutex address to site index, probed lock-free from the tracer and updated under
+   * slots_mtx_.
+   */
+  struct Slot {
+    std::atomic<std::uintptr_t> mutex{0};
+    std::atomic<std::uint32_t> site{0};
+  };
+
+  static void trace(const char* msg, const void* obj, std::int64_t wait_cycles);
+
+  std::atomic_bool enabled_{false};
+  std::atomic_bool tracer_registered_{false};
+
+  double nanos_per_cycle_;
+
+  std::unique_ptr<std::atomic<Site*>[]> sites_;
+  std::uint32_t site_count_ GUARDED_BY(sites_mtx_){0};
+  absl::Mutex sites_mtx_;
+
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::size_t> tracked_{0};
+  std::size_t deleted_slots_ GUARDED_BY(slots_mtx_){0};
+  absl::Mutex slots_mtx_;
+
+  std::uint32_t siteOf(const void* mutex) const;
+
+  bool insert(std::uintptr_t address, std::uint32_t site) EXCLUSIVE_LOCKS_REQUIRED(slots_mtx_);
+
+  /**
+   * @brief Re-insert tracked mutexes into a table free of tombstones. Contention reported meanwhile may be attributed
+   * to other.
+   */
+  void rehash() EXCLUSIVE_LOCKS_REQUIRED(slots_mtx_);
+};
+
+ROCKETMQ_NAMESPACE_END
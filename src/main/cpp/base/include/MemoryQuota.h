@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Account memory held by received messages across all queues served by one client runtime.
+ *
+ * Acquisition never blocks nor fails: messages already decoded have to be cached anyway. Instead, callers are expected
+ * to hold off fetching more once the quota is near its limit, that is, usage reaches the high watermark.
+ */
+class MemoryQuota {
+public:
+  explicit MemoryQuota(std::uint64_t limit, double high_watermark = 0.9)
+      : limit_(limit), high_watermark_(high_watermark) {
+  }
+
+  void acquire(std::uint64_t bytes);
+
+  void release(std::uint64_t bytes);
+
+  std::uint64_t used() const {
+    return used_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t limit() const {
+    return limit_.load(std::memory_order_relaxed);
+  }
+
+  void limit(std::uint64_t limit) {
+    limit_.store(limit, std::memory_order_relaxed);
+  }
+
+  bool nearLimit() const;
+
+private:
+  std::atomic<std::uint64_t> used_{0};
+  std::atomic<std::uint64_t> limit_;
+  double high_watermark_;
+};
+
+ROCKETMQ_NAMESPACE_END
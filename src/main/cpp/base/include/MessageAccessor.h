@@ -47,6 +47,7 @@ public:
   static absl::Time decodedTimestamp(const MQMessageExt& message);
 
   static void setInvisiblePeriod(MQMessageExt& message, absl::Duration invisible_period);
+  static absl::Duration invisiblePeriod(const MQMessageExt& message);
 
   static void setReceiptHandle(MQMessageExt& message, std::string receipt_handle);
   static void setTraceContext(MQMessageExt& message, std::string trace_context);
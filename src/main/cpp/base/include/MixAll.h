@@ -35,7 +35,31 @@ public:
   static const uint32_t MAX_CACHED_MESSAGE_COUNT;
   static const uint32_t DEFAULT_CACHED_MESSAGE_COUNT;
   static const uint64_t DEFAULT_CACHED_MESSAGE_MEMORY;
+
+  /**
+   * Memory that messages received, in transit or cached, may take up per client runtime. By default, 512MiB.
+   */
+  static const uint64_t DEFAULT_MEMORY_QUOTA;
   static const uint32_t DEFAULT_CONSUME_THREAD_POOL_SIZE;
+
+  /**
+   * Threads that run local transaction state checks, and checks allowed to be pending at a time, per producer.
+   */
+  static const uint16_t DEFAULT_TRANSACTION_CHECK_THREAD_POOL_SIZE;
+  static const uint32_t DEFAULT_TRANSACTION_CHECK_CAPACITY;
+
+  /**
+   * Interval between consumer lag samples, and end-offset queries a sample may have in flight per broker.
+   */
+  static const std::chrono::seconds LAG_SAMPLE_INTERVAL;
+  static const uint32_t LAG_SAMPLE_INFLIGHT_PER_BROKER;
+
+  /**
+   * Granularity of the timing wheel holding messages that producers send with a delay, and slots it has; a revolution
+   * spans about 5 seconds.
+   */
+  static const std::chrono::milliseconds DELAYED_SEND_TICK;
+  static const uint32_t DELAYED_SEND_WHEEL_SIZE;
   static const uint32_t DEFAULT_CONSUME_MESSAGE_BATCH_SIZE;
   static const int32_t DEFAULT_MAX_DELIVERY_ATTEMPTS;
 
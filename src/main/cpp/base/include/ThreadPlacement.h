@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Roles of the threads spawned by the client. Threads of the same role share one CPU set.
+ */
+enum class ThreadRole : std::uint8_t {
+  Generic = 0,
+  Scheduler,
+  Callback,
+  Consume,
+  CompletionQueue,
+  Exporter,
+};
+
+/**
+ * @brief Controls naming, CPU affinity and NUMA memory policy of client threads.
+ *
+ * CPU sets are configured either programmatically through cpuSet() or through environment variables named
+ * ROCKETMQ_CPUSET_{SCHEDULER,CALLBACK,CONSUME,COMPLETION_QUEUE,EXPORTER}, whose values follow the cpuset list
+ * format, e.g. "0-3,8,10-11". Either way, they must be in place before the corresponding threads start.
+ *
+ * A role without a CPU set of its own follows the role it hands work to: the completion-queue poller follows the
+ * callback pool, which in turn follows the consume pool. Once a thread is bound to CPUs, its memory policy is switched
+ * to node-local so that buffers it allocates afterwards stay on its own NUMA node.
+ */
+class ThreadPlacement {
+public:
+  /**
+   * @brief Set CPU set of the role, overriding its environment variable. An empty set clears the override.
+   */
+  static void cpuSet(ThreadRole role, std::vector<int> cpus);
+
+  /**
+   * @return CPU set effective for the role, after applying environment variables and fallback rules. An empty set means
+   * the threads are free to float.
+   */
+  static std::vector<int> cpuSet(ThreadRole role);
+
+  /**
+   * @brief Name the calling thread and bind it to the CPU set of the given role, if any.
+   *
+   * @param role Role of the calling thread.
+   * @param name Thread name, which is truncated to 15 characters on Linux.
+   */
+  static void apply(ThreadRole role, const std::string& name);
+
+  /**
+   * @brief Parse CPU list in the format of "0-3,8,10-11".
+   *
+   * @return false if the text is malformed.
+   */
+  static bool parseCpuList(absl::string_view text, std::vector<int>& cpus);
+
+  static const char* environmentVariableOf(ThreadRole role);
+
+private:
+  static std::vector<int> configuredCpuSet(ThreadRole role);
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -17,16 +17,20 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "asio.hpp"
 #include "asio/io_context.hpp"
 
+#include "ThreadPlacement.h"
 #include "ThreadPool.h"
 #include "rocketmq/State.h"
 
@@ -36,22 +40,108 @@ class ThreadPoolImpl : public ThreadPool {
 public:
   explicit ThreadPoolImpl(std::uint16_t workers);
 
+  /**
+   * @brief Create an elastic thread pool, which starts with min_workers threads and may be resized within
+   * [min_workers, max_workers] afterwards.
+   */
+  ThreadPoolImpl(std::uint16_t min_workers, std::uint16_t max_workers);
+
   ~ThreadPoolImpl() override = default;
 
-  void start() override;
+  void start() override LOCKS_EXCLUDED(workers_mtx_);
 
-  void shutdown() override;
+  void shutdown() override LOCKS_EXCLUDED(workers_mtx_);
 
   void submit(std::function<void(void)> task) override;
 
+  /**
+   * @brief Assign role and name prefix to worker threads. Must be called prior to start().
+   */
+  void placement(ThreadRole role, std::string name) {
+    role_ = role;
+    name_ = std::move(name);
+  }
+
+  /**
+   * @brief Grow or shrink the pool to the given number of workers, clamped to [min_workers, max_workers].
+   *
+   * Surplus workers retire once they finish their current task; they never abandon queued tasks.
+   */
+  void resize(std::uint16_t workers) LOCKS_EXCLUDED(workers_mtx_);
+
+  std::uint16_t workers() const {
+    return workers_.load(std::memory_order_relaxed);
+  }
+
+  std::uint16_t minWorkers() const {
+    return min_workers_;
+  }
+
+  std::uint16_t maxWorkers() const {
+    return max_workers_;
+  }
+
+  /**
+   * @return Number of submitted tasks that are not yet picked up by any worker.
+   */
+  std::uint32_t backlog() const {
+    return backlog_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return Number of workers that are executing a task.
+   */
+  std::uint32_t busyWorkers() const {
+    return busy_workers_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return true if no submitted task is either queued or running.
+   */
+  bool idle() const {
+    return !backlog_.load(std::memory_order_relaxed) && !busy_workers_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return The longest time a task spent in queue since the previous call.
+   */
+  std::chrono::microseconds maxQueueingDelayAndReset() {
+    return std::chrono::microseconds(max_queueing_delay_.exchange(0, std::memory_order_relaxed));
+  }
+
 private:
   asio::io_context context_;
   std::unique_ptr<asio::executor_work_guard<asio::io_context::executor_type>> work_guard_;
-  std::uint16_t workers_;
-  std::vector<std::thread> threads_;
+  const std::uint16_t min_workers_;
+  const std::uint16_t max_workers_;
+  std::atomic<std::uint16_t> workers_;
+  std::vector<std::thread> threads_ GUARDED_BY(workers_mtx_);
+  std::vector<std::thread::id> retired_ GUARDED_BY(workers_mtx_);
+  absl::Mutex workers_mtx_;
   std::atomic<State> state_{State::CREATED};
   absl::Mutex start_mtx_;
   absl::CondVar start_cv_;
+
+  /**
+   * @brief Number of workers that shall quit once they finish the task at hand.
+   */
+  std::atomic<std::uint16_t> retiring_{0};
+
+  ThreadRole role_{ThreadRole::Generic};
+  std::string name_{"ThreadPool"};
+  std::atomic<std::uint32_t> spawned_{0};
+
+  std::atomic<std::uint32_t> backlog_{0};
+  std::atomic<std::uint32_t> busy_workers_{0};
+  std::atomic<std::int64_t> max_queueing_delay_{0};
+
+  void spawn() EXCLUSIVE_LOCKS_REQUIRED(workers_mtx_);
+
+  void loop() LOCKS_EXCLUDED(workers_mtx_);
+
+  bool tryRetire();
+
+  void reapRetiredWorkers() EXCLUSIVE_LOCKS_REQUIRED(workers_mtx_);
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
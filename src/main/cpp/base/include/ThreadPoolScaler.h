@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "ThreadPoolImpl.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+struct ThreadPoolScalerOptions {
+  /**
+   * @brief The pool is considered under pressure if any task waited in queue longer than this.
+   */
+  std::chrono::milliseconds queueing_delay_threshold{std::chrono::milliseconds(100)};
+
+  /**
+   * @brief The pool is considered under pressure if there are more than this many queued tasks per worker.
+   */
+  std::uint32_t backlog_per_worker_threshold{2};
+
+  /**
+   * @brief Number of consecutive pressured ticks before the pool grows.
+   */
+  std::uint32_t scale_up_ticks{2};
+
+  /**
+   * @brief Number of consecutive idle ticks before the pool shrinks by one worker.
+   */
+  std::uint32_t scale_down_ticks{30};
+};
+
+/**
+ * @brief Control loop that resizes an elastic ThreadPoolImpl according to its backlog and queueing delay.
+ *
+ * The owner is expected to invoke tick() at a fixed cadence. To avoid oscillation, the pool grows multiplicatively only
+ * after sustained pressure, shrinks one worker at a time only after a sustained idle period, and both streaks restart
+ * from zero after every resize.
+ */
+class ThreadPoolScaler {
+public:
+  ThreadPoolScaler(ThreadPoolImpl& pool, ThreadPoolScalerOptions options);
+
+  explicit ThreadPoolScaler(ThreadPoolImpl& pool) : ThreadPoolScaler(pool, ThreadPoolScalerOptions()) {
+  }
+
+  void tick();
+
+  std::uint32_t scaleUpCount() const {
+    return scale_up_count_;
+  }
+
+  std::uint32_t scaleDownCount() const {
+    return scale_down_count_;
+  }
+
+  /**
+   * @brief Render scaling stats accumulated since the previous report.
+   */
+  void reportAndReset(std::string& result);
+
+private:
+  ThreadPoolImpl& pool_;
+  ThreadPoolScalerOptions options_;
+
+  std::uint32_t pressured_ticks_{0};
+  std::uint32_t idle_ticks_{0};
+
+  std::uint32_t scale_up_count_{0};
+  std::uint32_t scale_down_count_{0};
+  std::chrono::microseconds max_queueing_delay_{0};
+};
+
+ROCKETMQ_NAMESPACE_END
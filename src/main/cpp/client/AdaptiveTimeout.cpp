@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AdaptiveTimeout.h"
+
+#include <algorithm>
+#include <cmath>
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+void AdaptiveTimeout::record(const std::string& endpoint, absl::Duration latency) {
+  absl::MutexLock lk(&mtx_);
+  Samples& samples = samples_[endpoint];
+  if (samples.latencies.size() < window_) {
+    samples.latencies.push_back(latency);
+    return;
+  }
+  samples.latencies[samples.next] = latency;
+  samples.next = (samples.next + 1) % window_;
+}
+
+absl::Duration AdaptiveTimeout::timeout(const std::string& endpoint, absl::Duration ceiling) const {
+  std::vector<absl::Duration> latencies;
+  {
+    absl::MutexLock lk(&mtx_);
+    auto search = samples_.find(endpoint);
+    if (samples_.end() == search || search->second.latencies.size() < min_samples_) {
+      return ceiling;
+    }
+    latencies = search->second.latencies;
+  }
+
+  auto rank = static_cast<std::size_t>(std::ceil(percentile_ * latencies.size()));
+  rank = std::min(std::max(rank, static_cast<std::size_t>(1)), latencies.size());
+  std::nth_element(latencies.begin(), latencies.begin() + (rank - 1), latencies.end());
+  absl::Duration timeout = std::max(latencies[rank - 1] * multiplier_, floor_);
+  return std::min(timeout, ceiling);
+}
+
+void AdaptiveTimeout::remove(const std::vector<std::string>& endpoints) {
+  absl::MutexLock lk(&mtx_);
+  for (const auto& endpoint : endpoints) {
+    samples_.erase(endpoint);
+  }
+}
+
+std::size_t AdaptiveTimeout::size() const {
+  absl::MutexLock lk(&mtx_);
+  return samples_.size();
+}
+
+ROCKETMQ_NAMESPACE_END
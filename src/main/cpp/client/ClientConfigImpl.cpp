@@ -24,6 +24,7 @@
 #include <unistd.h>
 #endif
 
+#include "Signature.h"
 #include "UtilAll.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
@@ -94,4 +95,19 @@ absl::Duration ClientConfigImpl::getIoTimeout() const {
   return io_timeout_;
 }
 
+std::shared_ptr<const Metadata::Entries> ClientConfigImpl::commonHeaders() {
+  absl::MutexLock lk(&common_headers_mtx_);
+  if (!common_headers_) {
+    auto headers = std::make_shared<Metadata::Entries>();
+    Signature::commonHeaders(this, *headers);
+    common_headers_ = std::move(headers);
+  }
+  return common_headers_;
+}
+
+void ClientConfigImpl::resetCommonHeaders() {
+  absl::MutexLock lk(&common_headers_mtx_);
+  common_headers_.reset();
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -18,6 +18,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <system_error>
 #include <utility>
@@ -25,25 +27,30 @@
 
 #include "ReceiveMessageResult.h"
 #include "Scheduler.h"
+#include "google/protobuf/descriptor.h"
 #include "google/rpc/code.pb.h"
 
 #include "DnsResolver.h"
 #include "InvocationContext.h"
+#include "LockContention.h"
 #include "LogInterceptor.h"
 #include "LogInterceptorFactory.h"
 #include "LoggerImpl.h"
 #include "MessageAccessor.h"
 #include "MetadataConstants.h"
+#include "MetricsInterceptorFactory.h"
 #include "MixAll.h"
 #include "Partition.h"
 #include "Protocol.h"
 #include "RpcClient.h"
 #include "RpcClientImpl.h"
+#include "ThreadPlacement.h"
 #include "UtilAll.h"
 #include "grpcpp/create_channel.h"
 #include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQMessageExt.h"
-#include "absl/strings/str_join.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
@@ -51,15 +58,43 @@ ClientManagerImpl::ClientManagerImpl(std::string resource_namespace)
     : scheduler_(std::make_shared<SchedulerImpl>()), resource_namespace_(std::move(resource_namespace)),
       state_(State::CREATED), completion_queue_(std::make_shared<CompletionQueue>()),
       callback_thread_pool_(absl::make_unique<ThreadPoolImpl>(std::thread::hardware_concurrency())),
-      latency_histogram_("Message-Latency", 11) {
+      latency_histogram_("Message-Latency", 11), rpc_metrics_(rpcMethods()),
+      memory_quota_(std::make_shared<MemoryQuota>(MixAll::DEFAULT_MEMORY_QUOTA)),
+      resource_quota_("rocketmq-client-" + resource_namespace_) {
   spdlog::set_level(spdlog::level::trace);
   assignLabels(latency_histogram_);
+  LockContention::instance().track(&rpc_clients_mtx_, "ClientManagerImpl::rpc_clients_mtx_");
+
+  const char* rpc_metrics = getenv("ROCKETMQ_RPC_METRICS");
+  if (rpc_metrics && (!strcmp(rpc_metrics, "false") || !strcmp(rpc_metrics, "0"))) {
+    rpc_metrics_enabled_ = false;
+  }
+  const char* adaptive_timeout = getenv("ROCKETMQ_ADAPTIVE_TIMEOUT");
+  if (adaptive_timeout && (!strcmp(adaptive_timeout, "false") || !strcmp(adaptive_timeout, "0"))) {
+    adaptive_timeout_enabled_ = false;
+  }
+  const char* rpc_log = getenv("ROCKETMQ_RPC_LOG");
+  if (rpc_log && (!strcmp(rpc_log, "true") || !strcmp(rpc_log, "1"))) {
+    rpc_log_enabled_ = true;
+  }
+  callback_thread_pool_->placement(ThreadRole::Callback, "rmq-callback");
 
   grpc::SslCredentialsOptions options = {};
   channel_credential_ = grpc::SslCredentials(options);
 
-  // Use unlimited receive message size.
-  channel_arguments_.SetMaxReceiveMessageSize(-1);
+  const char* memory_quota = getenv("ROCKETMQ_MEMORY_QUOTA");
+  std::uint64_t memory_quota_bytes;
+  if (memory_quota && absl::SimpleAtoi(memory_quota, &memory_quota_bytes) && memory_quota_bytes) {
+    memory_quota_->limit(memory_quota_bytes);
+  }
+  resource_quota_.Resize(memory_quota_->limit());
+  channel_arguments_.SetResourceQuota(resource_quota_);
+
+  // Largest response expected is a full batch of messages whose bodies are of maximum size, plus allowance for their
+  // properties and system attributes.
+  int max_receive_message_size =
+      MixAll::DEFAULT_RECEIVE_MESSAGE_BATCH_SIZE * (MixAll::MAX_MESSAGE_BODY_SIZE + 64 * 1024);
+  channel_arguments_.SetMaxReceiveMessageSize(max_receive_message_size);
 
   int max_send_message_size = 1024 * 1024 * 16;
   channel_arguments_.SetMaxSendMessageSize(max_send_message_size);
@@ -88,6 +123,7 @@ ClientManagerImpl::ClientManagerImpl(std::string resource_namespace)
 
 ClientManagerImpl::~ClientManagerImpl() {
   shutdown();
+  LockContention::instance().untrack(&rpc_clients_mtx_);
   SPDLOG_INFO("ClientManager[ResourceNamespace={}] destructed", resource_namespace_);
 }
 
@@ -112,6 +148,15 @@ void ClientManagerImpl::start() {
   };
   health_check_task_id_ = scheduler_->schedule(health_check_functor, HEALTH_CHECK_TASK_NAME, std::chrono::seconds(5),
                                                std::chrono::seconds(5));
+
+  auto clean_rpc_client_functor = [client_instance_weak_ptr]() {
+    auto client_instance = client_instance_weak_ptr.lock();
+    if (client_instance) {
+      client_instance->doCleanOfflineRpcClients();
+    }
+  };
+  clean_rpc_client_task_id_ = scheduler_->schedule(clean_rpc_client_functor, CLEAN_RPC_CLIENT_TASK_NAME,
+                                                   std::chrono::seconds(30), std::chrono::seconds(30));
   auto heartbeat_functor = [client_instance_weak_ptr]() {
     auto client_instance = client_instance_weak_ptr.lock();
     if (client_instance) {
@@ -140,7 +185,11 @@ void ClientManagerImpl::shutdown() {
     SPDLOG_WARN("Unexpected client instance state: {}", state_.load(std::memory_order_relaxed));
     return;
   }
-  state_.store(STOPPING, std::memory_order_relaxed);
+  {
+    // Connectivity watches completing from now on are released by the poller rather than re-armed.
+    absl::MutexLock lk(&watch_mtx_);
+    state_.store(STOPPING, std::memory_order_relaxed);
+  }
 
   callback_thread_pool_->shutdown();
 
@@ -148,6 +197,10 @@ void ClientManagerImpl::shutdown() {
     scheduler_->cancel(health_check_task_id_);
   }
 
+  if (clean_rpc_client_task_id_) {
+    scheduler_->cancel(clean_rpc_client_task_id_);
+  }
+
   if (heartbeat_task_id_) {
     scheduler_->cancel(heartbeat_task_id_);
   }
@@ -174,6 +227,19 @@ void ClientManagerImpl::shutdown() {
   SPDLOG_DEBUG("Client instance stopped");
 }
 
+std::vector<std::string> ClientManagerImpl::rpcMethods() {
+  std::vector<std::string> methods;
+  const google::protobuf::ServiceDescriptor* service =
+      google::protobuf::DescriptorPool::generated_pool()->FindServiceByName(rmq::MessagingService::service_full_name());
+  if (!service) {
+    return methods;
+  }
+  for (int i = 0; i < service->method_count(); i++) {
+    methods.push_back(absl::StrCat("/", service->full_name(), "/", service->method(i)->name()));
+  }
+  return methods;
+}
+
 void ClientManagerImpl::assignLabels(Histogram& histogram) {
   histogram.labels().emplace_back("[000ms~020ms): ");
   histogram.labels().emplace_back("[020ms~040ms): ");
@@ -207,9 +273,7 @@ void ClientManagerImpl::healthCheck(
   invocation_context->remote_address = target_host;
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
 
-  for (const auto& entry : metadata) {
-    invocation_context->context.AddMetadata(entry.first, entry.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb](const InvocationContext<HealthCheckResponse>* ctx) {
     std::error_code ec;
@@ -259,7 +323,37 @@ void ClientManagerImpl::doHealthCheck() {
     return;
   }
 
+  std::vector<std::shared_ptr<Client>> clients;
+  {
+    absl::MutexLock lk(&clients_mtx_);
+    for (auto& item : clients_) {
+      auto client = item.lock();
+      if (client && client->active()) {
+        clients.emplace_back(std::move(client));
+      }
+    }
+  }
+
+  for (auto& client : clients) {
+    client->healthCheck();
+  }
+  SPDLOG_DEBUG("Health check completed");
+}
+
+void ClientManagerImpl::doCleanOfflineRpcClients() {
+  if (State::STARTED != state_.load(std::memory_order_relaxed) &&
+      State::STARTING != state_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
   auto&& rpc_clients_removed = cleanOfflineRpcClients();
+  if (rpc_clients_removed.empty()) {
+    return;
+  }
+
+  endpoint_health_.remove(rpc_clients_removed);
+  rpc_metrics_.remove(rpc_clients_removed);
+  adaptive_timeout_.remove(rpc_clients_removed);
 
   std::vector<std::shared_ptr<Client>> clients;
   {
@@ -272,16 +366,85 @@ void ClientManagerImpl::doHealthCheck() {
     }
   }
 
-  if (!rpc_clients_removed.empty()) {
-    for (auto& client : clients) {
-      client->onRemoteEndpointRemoval(rpc_clients_removed);
+  for (auto& client : clients) {
+    client->onRemoteEndpointRemoval(rpc_clients_removed);
+  }
+}
+
+EndpointHealth ClientManagerImpl::endpointHealth(const std::string& endpoint) {
+  return endpoint_health_.health(endpoint);
+}
+
+void ClientManagerImpl::onRpcCompletion(const std::string& endpoint, bool ok, const grpc::Status& status) {
+  switch (status.error_code()) {
+    case grpc::StatusCode::UNAVAILABLE: {
+      ok = false;
+      break;
+    }
+    case grpc::StatusCode::DEADLINE_EXCEEDED:
+    case grpc::StatusCode::CANCELLED: {
+      // Inconclusive: long-polling calls may legitimately run out of time on a healthy connection.
+      return;
+    }
+    default: {
+      // Any status produced by the server proves the endpoint is reachable.
+      break;
+    }
+  }
+
+  if (!ok) {
+    if (endpoint_health_.onFailure(endpoint)) {
+      SPDLOG_WARN("RPC to {} failed at transport level. Mark it unhealthy", endpoint);
+    }
+    return;
+  }
+
+  if (endpoint_health_.onSuccess(endpoint)) {
+    notifyEndpointRecovery(endpoint);
+  }
+}
+
+bool ClientManagerImpl::onConnectivityState(const std::string& endpoint, grpc_connectivity_state state) {
+  switch (state) {
+    case grpc_connectivity_state::GRPC_CHANNEL_READY: {
+      if (endpoint_health_.onSuccess(endpoint)) {
+        notifyEndpointRecovery(endpoint);
+      }
+      break;
+    }
+    case grpc_connectivity_state::GRPC_CHANNEL_TRANSIENT_FAILURE:
+    case grpc_connectivity_state::GRPC_CHANNEL_SHUTDOWN: {
+      if (endpoint_health_.onFailure(endpoint)) {
+        SPDLOG_WARN("Channel to {} lost connectivity. Mark it unhealthy", endpoint);
+      }
+      break;
+    }
+    default: {
+      // IDLE or CONNECTING tells nothing about the remote endpoint.
+      break;
+    }
+  }
+
+  State current = state_.load(std::memory_order_relaxed);
+  return State::STARTED == current || State::STARTING == current;
+}
+
+void ClientManagerImpl::notifyEndpointRecovery(const std::string& endpoint) {
+  SPDLOG_INFO("Endpoint {} is observed healthy again", endpoint);
+  std::vector<std::shared_ptr<Client>> clients;
+  {
+    absl::MutexLock lk(&clients_mtx_);
+    for (auto& item : clients_) {
+      auto client = item.lock();
+      if (client) {
+        clients.emplace_back(std::move(client));
+      }
     }
   }
 
   for (auto& client : clients) {
-    client->healthCheck();
+    client->onEndpointRecovery(endpoint);
   }
-  SPDLOG_DEBUG("Health check completed");
 }
 
 std::vector<std::string> ClientManagerImpl::cleanOfflineRpcClients() {
@@ -323,9 +486,7 @@ void ClientManagerImpl::heartbeat(const std::string& target_host, const Metadata
   auto invocation_context = new InvocationContext<HeartbeatResponse>();
   invocation_context->task_name = fmt::format("Heartbeat to {}", target_host);
   invocation_context->remote_address = target_host;
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb](const InvocationContext<HeartbeatResponse>* invocation_context) {
     if (!invocation_context->status.ok()) {
@@ -398,15 +559,34 @@ void ClientManagerImpl::doHeartbeat() {
 }
 
 void ClientManagerImpl::pollCompletionQueue() {
+  ThreadPlacement::apply(ThreadRole::CompletionQueue, "rmq-cq-poller");
   while (State::STARTED == state_.load(std::memory_order_relaxed) ||
          State::STARTING == state_.load(std::memory_order_relaxed)) {
     bool ok = false;
     void* opaque_invocation_context;
     while (completion_queue_->Next(&opaque_invocation_context, &ok)) {
       auto invocation_context = static_cast<BaseInvocationContext*>(opaque_invocation_context);
-      if (!ok) {
-        // the call is dead
-        SPDLOG_WARN("CompletionQueue#Next assigned ok false, indicating the call is dead");
+      if (invocation_context->completesInline()) {
+        absl::MutexLock lk(&watch_mtx_);
+        State current = state_.load(std::memory_order_relaxed);
+        if (State::STARTED == current || State::STARTING == current) {
+          invocation_context->onCompletion(ok);
+        } else {
+          delete invocation_context;
+        }
+        continue;
+      }
+
+      // Tags other than RPCs, for example, connectivity-state watches, carry no remote address.
+      if (!invocation_context->remote_address.empty()) {
+        if (!ok) {
+          // the call is dead
+          SPDLOG_WARN("CompletionQueue#Next assigned ok false, indicating the call is dead");
+        }
+        onRpcCompletion(invocation_context->remote_address, ok, invocation_context->status);
+        if (invocation_context->adaptive_timeout.count()) {
+          onAdaptiveCallCompletion(invocation_context);
+        }
       }
       auto callback = [invocation_context, ok]() { invocation_context->onCompletion(ok); };
       callback_thread_pool_->submit(callback);
@@ -416,15 +596,39 @@ void ClientManagerImpl::pollCompletionQueue() {
   SPDLOG_INFO("pollCompletionQueue completed and quit");
 }
 
+void ClientManagerImpl::adaptDeadline(BaseInvocationContext* invocation_context, std::chrono::milliseconds timeout) {
+  if (adaptive_timeout_enabled_.load(std::memory_order_relaxed)) {
+    timeout = absl::ToChronoMilliseconds(
+        adaptive_timeout_.timeout(invocation_context->remote_address, absl::FromChrono(timeout)));
+    invocation_context->adaptive_timeout = timeout;
+  }
+  invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
+}
+
+void ClientManagerImpl::onAdaptiveCallCompletion(const BaseInvocationContext* invocation_context) {
+  const grpc::Status& status = invocation_context->status;
+  if (status.ok()) {
+    adaptive_timeout_.record(invocation_context->remote_address,
+                             absl::FromChrono(std::chrono::steady_clock::now() - invocation_context->start_time));
+    return;
+  }
+
+  // Latency of a timed-out call is at least its timeout. Recording it lets the timeout of a slowing endpoint grow.
+  if (grpc::StatusCode::DEADLINE_EXCEEDED == status.error_code()) {
+    adaptive_timeout_.record(invocation_context->remote_address,
+                             absl::FromChrono(invocation_context->adaptive_timeout));
+  }
+}
+
 bool ClientManagerImpl::send(const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                             SendCallback* cb) {
+                             std::chrono::milliseconds timeout, SendCallback* cb) {
   assert(cb);
 
   RpcClientSharedPtr client = getRpcClient(target_host);
   // Invocation context will be deleted in its onComplete() method.
   auto invocation_context = new InvocationContext<SendMessageResponse>();
 
-  auto&& headers = absl::StrJoin(metadata, ",", absl::PairFormatter("="));
+  auto&& headers = metadata.toString();
 
   // Log the send-message request in details, including headers.
   SPDLOG_DEBUG("Prepare to send message to {} asynchronously. Headers: {},{}={}, Request: {}", target_host, headers,
@@ -434,9 +638,8 @@ bool ClientManagerImpl::send(const std::string& target_host, const Metadata& met
   invocation_context->task_name =
       fmt::format("Send message[message-id={}] to {}", request.message().system_attribute().message_id(), target_host);
   invocation_context->remote_address = target_host;
-  for (const auto& entry : metadata) {
-    invocation_context->context.AddMetadata(entry.first, entry.second);
-  }
+  adaptDeadline(invocation_context, timeout);
+  metadata.attach(invocation_context->context);
 
   const std::string& topic = request.message().topic().name();
   std::weak_ptr<ClientManager> client_manager(shared_from_this());
@@ -515,12 +718,25 @@ bool ClientManagerImpl::send(const std::string& target_host, const Metadata& met
  */
 std::shared_ptr<grpc::Channel> ClientManagerImpl::createChannel(const std::string& target_host) {
   std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptor_factories;
-  interceptor_factories.emplace_back(absl::make_unique<LogInterceptorFactory>());
-  return grpc::CreateCustomChannel(target_host, channel_credential_, channel_arguments_);
+  if (rpc_metrics_enabled_.load(std::memory_order_relaxed)) {
+    interceptor_factories.emplace_back(
+        absl::make_unique<MetricsInterceptorFactory>(rpc_metrics_.endpoint(target_host)));
+  }
+
+  if (rpc_log_enabled_.load(std::memory_order_relaxed)) {
+    interceptor_factories.emplace_back(absl::make_unique<LogInterceptorFactory>());
+  }
+
+  if (interceptor_factories.empty()) {
+    return grpc::CreateCustomChannel(target_host, channel_credential_, channel_arguments_);
+  }
+  return grpc::experimental::CreateCustomChannelWithInterceptors(target_host, channel_credential_, channel_arguments_,
+                                                                 std::move(interceptor_factories));
 }
 
 RpcClientSharedPtr ClientManagerImpl::getRpcClient(const std::string& target_host, bool need_heartbeat) {
   std::shared_ptr<RpcClient> client;
+  bool created = false;
   {
     absl::MutexLock lock(&rpc_clients_mtx_);
     auto search = rpc_clients_.find(target_host);
@@ -530,16 +746,27 @@ RpcClientSharedPtr ClientManagerImpl::getRpcClient(const std::string& target_hos
       } else if (!search->second->ok()) {
         SPDLOG_INFO("Prior RPC client to {} is not OK. Re-create one", target_host);
       }
-      std::vector<std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>> interceptor_factories;
-      interceptor_factories.emplace_back(absl::make_unique<LogInterceptorFactory>());
       auto channel = createChannel(target_host);
       client = std::make_shared<RpcClientImpl>(completion_queue_, channel, need_heartbeat);
       rpc_clients_.insert_or_assign(target_host, client);
+      created = true;
     } else {
       client = search->second;
     }
   }
 
+  if (created) {
+    absl::MutexLock lk(&watch_mtx_);
+    State current = state_.load(std::memory_order_relaxed);
+    if (State::STARTED == current || State::STARTING == current) {
+      std::weak_ptr<ClientManagerImpl> client_manager(shared_from_this());
+      client->watchConnectivityState([client_manager, target_host](grpc_connectivity_state state) {
+        auto manager = client_manager.lock();
+        return manager && manager->onConnectivityState(target_host, state);
+      });
+    }
+  }
+
   if (need_heartbeat && !client->needHeartbeat()) {
     client->needHeartbeat(need_heartbeat);
   }
@@ -559,6 +786,19 @@ void ClientManagerImpl::cleanRpcClients() {
   rpc_clients_.clear();
 }
 
+Permission ClientManagerImpl::permissionOf(rmq::Permission permission) {
+  switch (permission) {
+    case rmq::Permission::READ:
+      return Permission::READ;
+    case rmq::Permission::WRITE:
+      return Permission::WRITE;
+    case rmq::Permission::READ_WRITE:
+      return Permission::READ_WRITE;
+    default:
+      return Permission::READ_WRITE;
+  }
+}
+
 SendResult ClientManagerImpl::processSendResponse(const MQMessageQueue& message_queue,
                                                   const SendMessageResponse& response) {
   if (google::rpc::Code::OK != response.common().status().code()) {
@@ -595,9 +835,7 @@ void ClientManagerImpl::resolveRoute(const std::string& target_host, const Metad
   invocation_context->task_name = fmt::format("Query route of topic={} from {}", request.topic().name(), target_host);
   invocation_context->remote_address = target_host;
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb](const InvocationContext<QueryRouteResponse>* invocation_context) {
     if (!invocation_context->status.ok()) {
@@ -614,10 +852,20 @@ void ClientManagerImpl::resolveRoute(const std::string& target_host, const Metad
       case google::rpc::Code::OK: {
         auto& partitions = invocation_context->response.partitions();
         std::vector<Partition> topic_partitions;
+        topic_partitions.reserve(partitions.size());
+        // Partitions of a broker share its endpoints, so they are parsed, and reverse-resolved, once per broker.
+        absl::flat_hash_map<std::pair<std::string, std::int32_t>, std::shared_ptr<ServiceAddress>> service_addresses;
         for (const auto& partition : partitions) {
           Topic t(partition.topic().resource_namespace(), partition.topic().name());
 
           auto& broker = partition.broker();
+          std::shared_ptr<ServiceAddress>& service_address = service_addresses[{broker.name(), broker.id()}];
+          if (service_address) {
+            Broker b(broker.name(), broker.id(), service_address);
+            topic_partitions.emplace_back(t, partition.id(), permissionOf(partition.permission()), std::move(b));
+            continue;
+          }
+
           AddressScheme scheme = AddressScheme::IPv4;
           switch (broker.endpoints().scheme()) {
             case rmq::AddressScheme::IPv4:
@@ -646,7 +894,6 @@ void ClientManagerImpl::resolveRoute(const std::string& target_host, const Metad
             }
           }
 
-          std::shared_ptr<ServiceAddress> service_address;
           std::vector<Address> addresses;
           if (prefer_domain && domains.size() == 1) {
             addresses.emplace_back(Address{*domains.begin(), port});
@@ -657,26 +904,8 @@ void ClientManagerImpl::resolveRoute(const std::string& target_host, const Metad
             }
             service_address = std::make_shared<ServiceAddress>(scheme, addresses);
           }
-          Broker b(partition.broker().name(), partition.broker().id(),
-                   std::move(service_address));
-
-          Permission permission = Permission::READ_WRITE;
-          switch (partition.permission()) {
-            case rmq::Permission::READ:
-              permission = Permission::READ;
-              break;
-
-            case rmq::Permission::WRITE:
-              permission = Permission::WRITE;
-              break;
-            case rmq::Permission::READ_WRITE:
-              permission = Permission::READ_WRITE;
-              break;
-            default:
-              break;
-          }
-          Partition topic_partition(t, partition.id(), permission, std::move(b));
-          topic_partitions.emplace_back(std::move(topic_partition));
+          Broker b(partition.broker().name(), partition.broker().id(), service_address);
+          topic_partitions.emplace_back(t, partition.id(), permissionOf(partition.permission()), std::move(b));
         }
         auto ptr =
             std::make_shared<TopicRouteData>(std::move(topic_partitions), invocation_context->response.DebugString());
@@ -767,9 +996,7 @@ void ClientManagerImpl::queryAssignment(
   auto invocation_context = new InvocationContext<QueryAssignmentResponse>();
   invocation_context->task_name = fmt::format("QueryAssignment from {}", target);
   invocation_context->remote_address = target;
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
   invocation_context->callback = callback;
   client->asyncQueryAssignment(request, invocation_context);
@@ -780,7 +1007,7 @@ void ClientManagerImpl::receiveMessage(const std::string& target_host, const Met
                                        const std::shared_ptr<ReceiveMessageCallback>& cb) {
   RpcClientSharedPtr client = getRpcClient(target_host);
   auto invocation_context = new InvocationContext<ReceiveMessageResponse>();
-  auto&& headers = absl::StrJoin(metadata, ",", absl::PairFormatter("="));
+  auto&& headers = metadata.toString();
   // Log the receive-message request in details, including headers.
   SPDLOG_DEBUG("Prepare to receive message from {} asynchronously. Headers: {},{}={}, Request: {}", target_host,
                headers, MetadataConstants::REQUEST_ID_KEY, invocation_context->request_id_,
@@ -790,11 +1017,7 @@ void ClientManagerImpl::receiveMessage(const std::string& target_host, const Met
                                               request.partition().topic().name(), request.partition().broker().name(),
                                               request.partition().id(), target_host);
   invocation_context->remote_address = target_host;
-  if (!metadata.empty()) {
-    for (const auto& item : metadata) {
-      invocation_context->context.AddMetadata(item.first, item.second);
-    }
-  }
+  metadata.attach(invocation_context->context);
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
 
   auto callback = [this, cb](const InvocationContext<ReceiveMessageResponse>* invocation_context) {
@@ -1098,11 +1321,9 @@ void ClientManagerImpl::ack(const std::string& target, const Metadata& metadata,
   auto invocation_context = new InvocationContext<AckMessageResponse>();
   invocation_context->task_name = fmt::format("Ack message[{}] against {}", request.message_id(), target);
   invocation_context->remote_address = target_host;
-  invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
+  adaptDeadline(invocation_context, timeout);
 
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   // TODO: Use capture by move and pass-by-value paradigm when C++ 14 is available.
   auto callback = [request, cb](const InvocationContext<AckMessageResponse>* invocation_context) {
@@ -1153,11 +1374,9 @@ void ClientManagerImpl::nack(const std::string& target_host, const Metadata& met
   auto invocation_context = new InvocationContext<NackMessageResponse>();
   invocation_context->task_name = fmt::format("Nack Message[{}] against {}", request.message_id(), target_host);
   invocation_context->remote_address = target_host;
-  invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
+  adaptDeadline(invocation_context, timeout);
 
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [completion_callback](const InvocationContext<NackMessageResponse>* invocation_context) {
     if (!invocation_context->status.ok()) {
@@ -1221,9 +1440,7 @@ void ClientManagerImpl::endTransaction(
   invocation_context->task_name = fmt::format("End transaction[{}] of message[] against {}", request.transaction_id(),
                                               request.message_id(), target_host);
   invocation_context->remote_address = target_host;
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   // Set RPC deadline.
   auto deadline = std::chrono::system_clock::now() + timeout;
@@ -1278,9 +1495,7 @@ void ClientManagerImpl::pollCommand(const std::string& target, const Metadata& m
 
   auto invocation_context = new InvocationContext<PollCommandResponse>();
   invocation_context->remote_address = target;
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
   auto deadline = std::chrono::system_clock::now() + timeout;
   invocation_context->context.set_deadline(deadline);
 
@@ -1307,9 +1522,7 @@ void ClientManagerImpl::queryOffset(const std::string& target_host, const Metada
   invocation_context->remote_address = target_host;
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
 
-  for (const auto& entry : metadata) {
-    invocation_context->context.AddMetadata(entry.first, entry.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb](const InvocationContext<QueryOffsetResponse>* invocation_context) {
     std::error_code ec;
@@ -1359,7 +1572,7 @@ void ClientManagerImpl::queryOffset(const std::string& target_host, const Metada
 void ClientManagerImpl::pullMessage(
     const std::string& target_host, const Metadata& metadata, const PullMessageRequest& request,
     std::chrono::milliseconds timeout,
-    const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) {
+    const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
   SPDLOG_DEBUG("PullMessage Request: {}, target_host={}", request.DebugString(), target_host);
   auto client = getRpcClient(target_host);
   auto invocation_context = new InvocationContext<PullMessageResponse>();
@@ -1368,9 +1581,7 @@ void ClientManagerImpl::pullMessage(
                                               request.partition().id(), target_host);
   invocation_context->remote_address = target_host;
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb, this](const InvocationContext<PullMessageResponse>* invocation_context) {
     std::error_code ec;
@@ -1392,12 +1603,13 @@ void ClientManagerImpl::pullMessage(
       case google::rpc::Code::OK: {
         SPDLOG_TRACE("Received PullMessage Response: {}, host={}", invocation_context->response.DebugString(),
                      invocation_context->remote_address);
+        result.messages.reserve(invocation_context->response.messages().size());
         for (const auto& item : invocation_context->response.messages()) {
           MQMessageExt message;
           if (!wrapMessage(item, message)) {
             return;
           }
-          result.messages.emplace_back(message);
+          result.messages.emplace_back(std::move(message));
         }
       } break;
       case google::rpc::Code::PERMISSION_DENIED: {
@@ -1454,9 +1666,7 @@ void ClientManagerImpl::forwardMessageToDeadLetterQueue(
   invocation_context->remote_address = target_host;
   invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
 
-  for (const auto& item : metadata) {
-    invocation_context->context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(invocation_context->context);
 
   auto callback = [cb](const InvocationContext<ForwardMessageToDeadLetterQueueResponse>* invocation_context) {
     if (!invocation_context->status.ok()) {
@@ -1473,6 +1683,86 @@ void ClientManagerImpl::forwardMessageToDeadLetterQueue(
   client->asyncForwardMessageToDeadLetterQueue(request, invocation_context);
 }
 
+void ClientManagerImpl::changeInvisibleDuration(
+    const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+    std::chrono::milliseconds timeout,
+    const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) {
+  RpcClientSharedPtr client = getRpcClient(target_host);
+  if (!client) {
+    SPDLOG_WARN("No RPC client for {}", target_host);
+    ChangeInvisibleDurationResponse response;
+    std::error_code ec = ErrorCode::BadRequest;
+    cb(ec, response);
+    return;
+  }
+
+  auto invocation_context = new InvocationContext<ChangeInvisibleDurationResponse>();
+  invocation_context->task_name =
+      fmt::format("Change invisible duration of {} messages against {}", request.entries_size(), target_host);
+  invocation_context->remote_address = target_host;
+  invocation_context->context.set_deadline(std::chrono::system_clock::now() + timeout);
+
+  metadata.attach(invocation_context->context);
+
+  auto callback = [cb](const InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) {
+    if (!invocation_context->status.ok()) {
+      SPDLOG_WARN("Failed to write ChangeInvisibleDuration request to wire. gRPC-code: {}, gRPC-message: {}",
+                  invocation_context->status.error_code(), invocation_context->status.error_message());
+      // Brokers predating the RPC reject it as unimplemented.
+      std::error_code ec = grpc::StatusCode::UNIMPLEMENTED == invocation_context->status.error_code()
+                               ? ErrorCode::NotImplemented
+                               : ErrorCode::RequestTimeout;
+      cb(ec, invocation_context->response);
+      return;
+    }
+
+    std::error_code ec;
+    const auto& common = invocation_context->response.common();
+    switch (common.status().code()) {
+      case google::rpc::Code::OK: {
+        SPDLOG_DEBUG("ChangeInvisibleDuration to {} OK", invocation_context->remote_address);
+        break;
+      }
+      case google::rpc::Code::UNAUTHENTICATED: {
+        SPDLOG_WARN("Unauthenticated: {}, host={}", common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::Unauthorized;
+        break;
+      }
+      case google::rpc::Code::PERMISSION_DENIED: {
+        SPDLOG_WARN("PermissionDenied: {}, host={}", common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::Forbidden;
+        break;
+      }
+      case google::rpc::Code::INTERNAL: {
+        SPDLOG_WARN("InternalServerError: {}, host={}", common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::InternalServerError;
+        break;
+      }
+      case google::rpc::Code::INVALID_ARGUMENT: {
+        SPDLOG_WARN("InvalidArgument: {}, host={}", common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::BadRequest;
+        break;
+      }
+      case google::rpc::Code::NOT_FOUND: {
+        // Receipt handles expire routinely; it says nothing about whether the broker supports the RPC.
+        SPDLOG_WARN("NotFound: {}, host={}", common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::NotFound;
+        break;
+      }
+      default: {
+        // Only gRPC UNIMPLEMENTED, handled above, tells the broker lacks the RPC. Anything else is transient.
+        SPDLOG_WARN("Unexpected status code: {}, message: {}, host={}", common.status().code(),
+                    common.status().message(), invocation_context->remote_address);
+        ec = ErrorCode::InternalServerError;
+        break;
+      }
+    }
+    cb(ec, invocation_context->response);
+  };
+  invocation_context->callback = callback;
+  client->asyncChangeInvisibleDuration(request, invocation_context);
+}
+
 std::error_code ClientManagerImpl::reportThreadStackTrace(const std::string& target_host, const Metadata& metadata,
                                                           const ReportThreadStackTraceRequest& request,
                                                           std::chrono::milliseconds timeout) {
@@ -1482,9 +1772,7 @@ std::error_code ClientManagerImpl::reportThreadStackTrace(const std::string& tar
   auto deadline = std::chrono::system_clock::now() + timeout;
   context.set_deadline(deadline);
 
-  for (const auto& item : metadata) {
-    context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(context);
 
   ReportThreadStackTraceResponse response;
   auto status = client->reportThreadStackTrace(&context, request, &response);
@@ -1526,9 +1814,7 @@ std::error_code ClientManagerImpl::reportMessageConsumptionResult(const std::str
   auto deadline = std::chrono::system_clock::now() + timeout;
   context.set_deadline(deadline);
 
-  for (const auto& item : metadata) {
-    context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(context);
 
   ReportMessageConsumptionResultResponse response;
   auto status = client->reportMessageConsumptionResult(&context, request, &response);
@@ -1573,9 +1859,7 @@ std::error_code ClientManagerImpl::notifyClientTermination(const std::string& ta
 
   grpc::ClientContext context;
   context.set_deadline(std::chrono::system_clock::now() + timeout);
-  for (const auto& item : metadata) {
-    context.AddMetadata(item.first, item.second);
-  }
+  metadata.attach(context);
 
   SPDLOG_DEBUG("NotifyClientTermination request: {}", request.DebugString());
 
@@ -1619,10 +1903,34 @@ std::error_code ClientManagerImpl::notifyClientTermination(const std::string& ta
   return ec;
 }
 
+void ClientManagerImpl::memoryQuota(std::uint64_t bytes) {
+  if (!bytes) {
+    // A zero-sized resource quota would starve every channel of this runtime.
+    SPDLOG_WARN("Ignore memory quota of 0 bytes, keeping {} bytes", memory_quota_->limit());
+    return;
+  }
+  memory_quota_->limit(bytes);
+  resource_quota_.Resize(bytes);
+}
+
 void ClientManagerImpl::logStats() {
   std::string stats;
   latency_histogram_.reportAndReset(stats);
   SPDLOG_INFO("{}", stats);
+
+  std::vector<std::string> rpc_stats;
+  rpc_metrics_.reportAndReset(rpc_stats);
+  for (const auto& item : rpc_stats) {
+    SPDLOG_INFO("{}", item);
+  }
+
+  SPDLOG_INFO("Memory-Quota: used={}bytes, limit={}bytes", memory_quota_->used(), memory_quota_->limit());
+
+  LockContention& lock_contention = LockContention::instance();
+  if (lock_contention.enabled()) {
+    lock_contention.report(stats, false);
+    SPDLOG_INFO("{}", stats);
+  }
 }
 
 void ClientManagerImpl::submit(std::function<void()> task) {
@@ -1632,5 +1940,6 @@ void ClientManagerImpl::submit(std::function<void()> task) {
 const char* ClientManagerImpl::HEARTBEAT_TASK_NAME = "heartbeat-task";
 const char* ClientManagerImpl::STATS_TASK_NAME = "stats-task";
 const char* ClientManagerImpl::HEALTH_CHECK_TASK_NAME = "health-check-task";
+const char* ClientManagerImpl::CLEAN_RPC_CLIENT_TASK_NAME = "clean-rpc-client-task";
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
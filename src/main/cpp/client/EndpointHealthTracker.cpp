@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "EndpointHealthTracker.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+bool EndpointHealthTracker::onSuccess(const std::string& endpoint, absl::Time now) {
+  absl::MutexLock lk(&mtx_);
+  Evidence& evidence = evidences_[endpoint];
+  bool recovered = !evidence.healthy;
+  evidence.healthy = true;
+  evidence.observed_time = now;
+  return recovered;
+}
+
+bool EndpointHealthTracker::onFailure(const std::string& endpoint, absl::Time now) {
+  absl::MutexLock lk(&mtx_);
+  Evidence& evidence = evidences_[endpoint];
+  bool failed = evidence.healthy;
+  evidence.healthy = false;
+  evidence.observed_time = now;
+  return failed;
+}
+
+EndpointHealth EndpointHealthTracker::health(const std::string& endpoint, absl::Time now) const {
+  absl::MutexLock lk(&mtx_);
+  auto search = evidences_.find(endpoint);
+  if (evidences_.end() == search || now - search->second.observed_time > freshness_) {
+    return EndpointHealth::Unknown;
+  }
+  return search->second.healthy ? EndpointHealth::Healthy : EndpointHealth::Unhealthy;
+}
+
+void EndpointHealthTracker::remove(const std::vector<std::string>& endpoints) {
+  absl::MutexLock lk(&mtx_);
+  for (const auto& endpoint : endpoints) {
+    evidences_.erase(endpoint);
+  }
+}
+
+std::size_t EndpointHealthTracker::size() const {
+  absl::MutexLock lk(&mtx_);
+  return evidences_.size();
+}
+
+ROCKETMQ_NAMESPACE_END
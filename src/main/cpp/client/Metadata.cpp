@@ -0,0 +1,38 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Metadata.h"
+
+#include "absl/strings/str_cat.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+void Metadata::attach(grpc::ClientContext& context) const {
+  forEach([&context](const std::string& key, const std::string& value) { context.AddMetadata(key, value); });
+}
+
+std::string Metadata::toString() const {
+  std::string result;
+  forEach([&result](const std::string& key, const std::string& value) {
+    if (!result.empty()) {
+      result.append(",");
+    }
+    absl::StrAppend(&result, key, "=", value);
+  });
+  return result;
+}
+
+ROCKETMQ_NAMESPACE_END
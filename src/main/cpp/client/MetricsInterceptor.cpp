@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetricsInterceptor.h"
+#include "InterceptorContinuation.h"
+#include "google/protobuf/message.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+void MetricsInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods* methods) {
+  InterceptorContinuation continuation(methods);
+
+  if (methods->QueryInterceptionHookPoint(grpc::experimental::InterceptionHookPoints::PRE_SEND_INITIAL_METADATA)) {
+    start_ = std::chrono::steady_clock::now();
+    started_ = true;
+    metrics_->onStart();
+  }
+
+  if (methods->QueryInterceptionHookPoint(grpc::experimental::InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+    // Request is serialized on first access to the buffer, which would otherwise happen right after this hook.
+    auto begin = std::chrono::steady_clock::now();
+    grpc::ByteBuffer* buffer = methods->GetSerializedSendMessage();
+    if (buffer) {
+      metrics_->onSerialized(buffer->Length(), std::chrono::steady_clock::now() - begin);
+    }
+  }
+
+  if (methods->QueryInterceptionHookPoint(grpc::experimental::InterceptionHookPoints::POST_RECV_MESSAGE)) {
+    // Client interceptors only see the deserialized response; its encoded size stands in for bytes on the wire.
+    void* message = methods->GetRecvMessage();
+    if (message) {
+      metrics_->onReceived(static_cast<google::protobuf::Message*>(message)->ByteSizeLong());
+    }
+  }
+
+  if (methods->QueryInterceptionHookPoint(grpc::experimental::InterceptionHookPoints::POST_RECV_STATUS) && started_) {
+    grpc::Status* status = methods->GetRecvStatus();
+    metrics_->onComplete(client_rpc_info_->method(), status && status->ok(),
+                         std::chrono::steady_clock::now() - start_);
+  }
+}
+
+ROCKETMQ_NAMESPACE_END
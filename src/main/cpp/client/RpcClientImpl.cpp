@@ -26,6 +26,32 @@ using ClientContext = grpc::ClientContext;
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+const std::chrono::seconds RpcClientImpl::CONNECTIVITY_WATCH_INTERVAL = std::chrono::seconds(10);
+
+/**
+ * @brief Completion-queue tag of a pending connectivity-state watch. remote_address is deliberately left empty so that
+ * the completion is not mistaken for an RPC outcome.
+ */
+struct ConnectivityWatch : public BaseInvocationContext {
+  bool completesInline() const override {
+    return true;
+  }
+
+  void onCompletion(bool ok) override {
+    // ok is false if the deadline expired before state changed. The channel must not be kept alive by the watch, or
+    // destroying the RPC client would never cancel it.
+    auto rpc_client = client.lock();
+    if (!rpc_client) {
+      delete this;
+      return;
+    }
+    rpc_client->watch(this);
+  }
+
+  std::weak_ptr<RpcClientImpl> client;
+  std::function<bool(grpc_connectivity_state)> callback;
+};
+
 void RpcClientImpl::asyncQueryRoute(const QueryRouteRequest& request,
                                     InvocationContext<QueryRouteResponse>* invocation_context) {
   invocation_context->response_reader =
@@ -120,6 +146,23 @@ bool RpcClientImpl::ok() const {
   return channel_ && grpc_connectivity_state::GRPC_CHANNEL_SHUTDOWN != channel_->GetState(false);
 }
 
+void RpcClientImpl::watchConnectivityState(std::function<bool(grpc_connectivity_state)> cb) {
+  auto watch = new ConnectivityWatch();
+  watch->client = shared_from_this();
+  watch->callback = std::move(cb);
+  this->watch(watch);
+}
+
+void RpcClientImpl::watch(ConnectivityWatch* watch) {
+  grpc_connectivity_state state = channel_->GetState(false);
+  if (!watch->callback(state) || grpc_connectivity_state::GRPC_CHANNEL_SHUTDOWN == state) {
+    delete watch;
+    return;
+  }
+  channel_->NotifyOnStateChange(state, std::chrono::system_clock::now() + CONNECTIVITY_WATCH_INTERVAL,
+                                completion_queue_.get(), watch);
+}
+
 void RpcClientImpl::addMetadata(grpc::ClientContext& context,
                                 const absl::flat_hash_map<std::string, std::string>& metadata) {
   for (const auto& entry : metadata) {
@@ -191,4 +234,15 @@ void RpcClientImpl::asyncForwardMessageToDeadLetterQueue(
                                               invocation_context);
 }
 
+void RpcClientImpl::asyncChangeInvisibleDuration(
+    const ChangeInvisibleDurationRequest& request,
+    InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) {
+  assert(invocation_context);
+  invocation_context->response_reader =
+      stub_->PrepareAsyncChangeInvisibleDuration(&invocation_context->context, request, completion_queue_.get());
+  invocation_context->response_reader->StartCall();
+  invocation_context->response_reader->Finish(&invocation_context->response, &invocation_context->status,
+                                              invocation_context);
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
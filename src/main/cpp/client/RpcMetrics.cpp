@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RpcMetrics.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+EndpointMetrics::EndpointMetrics(std::string endpoint, const std::vector<std::string>& methods)
+    : endpoint_(std::move(endpoint)) {
+  for (const auto& method : methods) {
+    methods_.emplace(method, absl::make_unique<MethodMetrics>());
+  }
+}
+
+EndpointMetrics::MethodMetrics::MethodMetrics() : latency("Latency", 8) {
+  latency.labels().emplace_back("[0ms~1ms): ");
+  latency.labels().emplace_back("[1ms~5ms): ");
+  latency.labels().emplace_back("[5ms~20ms): ");
+  latency.labels().emplace_back("[20ms~100ms): ");
+  latency.labels().emplace_back("[100ms~500ms): ");
+  latency.labels().emplace_back("[500ms~1s): ");
+  latency.labels().emplace_back("[1s~5s): ");
+  latency.labels().emplace_back("[5s~inf): ");
+}
+
+void EndpointMetrics::onComplete(absl::string_view method, bool ok, std::chrono::nanoseconds latency) {
+  inflight_.fetch_sub(1, std::memory_order_relaxed);
+
+  auto search = methods_.find(method);
+  MethodMetrics* metrics = search == methods_.end() ? &others_ : search->second.get();
+
+  metrics->calls.fetch_add(1, std::memory_order_relaxed);
+  if (!ok) {
+    metrics->failures.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static const std::int64_t bounds[] = {1, 5, 20, 100, 500, 1000, 5000};
+  auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(latency).count();
+  int grade = 0;
+  for (std::int64_t bound : bounds) {
+    if (millis < bound) {
+      break;
+    }
+    grade++;
+  }
+  metrics->latency.countIn(grade);
+}
+
+void EndpointMetrics::reportAndReset(std::string& stats) {
+  stats = absl::StrFormat("RPC-Metrics[%s]: inflight=%d, sent=%dbytes, received=%dbytes, serialization=%dus",
+                          endpoint_, inflight(), bytes_sent_.exchange(0, std::memory_order_relaxed),
+                          bytes_received_.exchange(0, std::memory_order_relaxed),
+                          serialization_nanos_.exchange(0, std::memory_order_relaxed) / 1000);
+
+  for (auto& entry : methods_) {
+    report(entry.first, *entry.second, stats);
+  }
+  report("others", others_, stats);
+}
+
+void EndpointMetrics::report(absl::string_view method, MethodMetrics& metrics, std::string& stats) {
+  std::int64_t calls = metrics.calls.exchange(0, std::memory_order_relaxed);
+  std::int64_t failures = metrics.failures.exchange(0, std::memory_order_relaxed);
+  if (!calls) {
+    return;
+  }
+  std::string latency;
+  metrics.latency.reportAndReset(latency);
+  stats.append(absl::StrFormat("\n  %s: calls=%d, failures=%d, %s", method, calls, failures, latency));
+}
+
+std::shared_ptr<EndpointMetrics> RpcMetrics::endpoint(const std::string& endpoint) {
+  absl::MutexLock lk(&mtx_);
+  auto search = endpoints_.find(endpoint);
+  if (search != endpoints_.end()) {
+    return search->second;
+  }
+  auto metrics = std::make_shared<EndpointMetrics>(endpoint, methods_);
+  endpoints_.insert({endpoint, metrics});
+  return metrics;
+}
+
+void RpcMetrics::remove(const std::vector<std::string>& endpoints) {
+  absl::MutexLock lk(&mtx_);
+  for (const auto& endpoint : endpoints) {
+    endpoints_.erase(endpoint);
+  }
+}
+
+void RpcMetrics::reportAndReset(std::vector<std::string>& stats) {
+  std::vector<std::shared_ptr<EndpointMetrics>> endpoints;
+  {
+    absl::MutexLock lk(&mtx_);
+    for (const auto& entry : endpoints_) {
+      endpoints.push_back(entry.second);
+    }
+  }
+
+  stats.clear();
+  for (const auto& endpoint : endpoints) {
+    std::string item;
+    endpoint->reportAndReset(item);
+    stats.push_back(std::move(item));
+  }
+}
+
+ROCKETMQ_NAMESPACE_END
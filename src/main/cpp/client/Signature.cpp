@@ -15,6 +15,14 @@
  * limitations under the License.
  */
 #include "Signature.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+
 #include "ClientConfigImpl.h"
 #include "MetadataConstants.h"
 #include "Protocol.h"
@@ -23,26 +31,116 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
-void Signature::sign(ClientConfig* client, absl::flat_hash_map<std::string, std::string>& metadata) {
-  assert(client);
+namespace {
+
+/**
+ * @brief Authorization header computed for one client, credentials and second. Region and service name take part in
+ * the credential scope, thus in the cache key as well.
+ */
+struct SignedAuthorization {
+  Credentials credentials;
+  std::string region;
+  std::string service_name;
+  std::int64_t second{0};
+  std::string authorization;
+};
+
+const std::size_t MAX_CACHED_AUTHORIZATIONS = 4;
+
+} // namespace
+
+const std::string& Signature::dateTime(std::int64_t second) {
+  static thread_local std::int64_t cached_second = 0;
+  static thread_local std::string date_time;
+  if (second != cached_second || date_time.empty()) {
+    date_time = absl::FormatTime(MetadataConstants::DATE_TIME_FORMAT, absl::FromUnixSeconds(second),
+                                 absl::UTCTimeZone());
+    cached_second = second;
+  }
+  return date_time;
+}
+
+const std::string& Signature::authorization(ClientConfig* client, const Credentials& credentials,
+                                            std::int64_t second) {
+  // Signed content is the date-time only, which changes once per second. A few entries per thread serve all clients
+  // and credentials in use.
+  static thread_local std::vector<SignedAuthorization> cache;
+
+  SignedAuthorization* entry = nullptr;
+  for (auto& item : cache) {
+    if (item.credentials == credentials && item.region == client->region() &&
+        item.service_name == client->serviceName()) {
+      entry = &item;
+      break;
+    }
+  }
 
-  metadata.insert({MetadataConstants::LANGUAGE_KEY, "CPP"});
-  // Add common headers
-  metadata.insert({MetadataConstants::CLIENT_VERSION_KEY, ClientConfigImpl::CLIENT_VERSION});
-  metadata.insert({MetadataConstants::PROTOCOL_VERSION_KEY, Protocol::PROTOCOL_VERSION});
+  if (entry && entry->second == second) {
+    return entry->authorization;
+  }
+
+  if (!entry) {
+    if (cache.size() < MAX_CACHED_AUTHORIZATIONS) {
+      cache.emplace_back();
+      entry = &cache.back();
+    } else {
+      // Evict the least recently refreshed one.
+      entry = &*std::min_element(
+          cache.begin(), cache.end(),
+          [](const SignedAuthorization& lhs, const SignedAuthorization& rhs) { return lhs.second < rhs.second; });
+    }
+    entry->credentials = credentials;
+    entry->region = client->region();
+    entry->service_name = client->serviceName();
+  }
+
+  entry->second = second;
+  entry->authorization = absl::StrCat(
+      MetadataConstants::ALGORITHM_KEY, " ", MetadataConstants::CREDENTIAL_KEY, "=", credentials.accessKey(), "/",
+      client->region(), "/", client->serviceName(), ", ", MetadataConstants::SIGNED_HEADERS_KEY, "=",
+      MetadataConstants::DATE_TIME_KEY, ", ", MetadataConstants::SIGNATURE_KEY, "=",
+      TlsHelper::sign(credentials.accessSecret(), dateTime(second)));
+  SPDLOG_DEBUG("Refresh authorization header: {}", entry->authorization);
+  return entry->authorization;
+}
+
+void Signature::commonHeaders(ClientConfig* client, Metadata::Entries& headers) {
+  headers.insert({MetadataConstants::LANGUAGE_KEY, "CPP"});
+  headers.insert({MetadataConstants::CLIENT_VERSION_KEY, ClientConfigImpl::CLIENT_VERSION});
+  headers.insert({MetadataConstants::PROTOCOL_VERSION_KEY, Protocol::PROTOCOL_VERSION});
 
   if (!client->tenantId().empty()) {
-    metadata.insert({MetadataConstants::TENANT_ID_KEY, client->tenantId()});
+    headers.insert({MetadataConstants::TENANT_ID_KEY, client->tenantId()});
   }
 
   if (!client->resourceNamespace().empty()) {
-    metadata.insert({MetadataConstants::NAMESPACE_KEY, client->resourceNamespace()});
+    headers.insert({MetadataConstants::NAMESPACE_KEY, client->resourceNamespace()});
+  }
+}
+
+void Signature::sign(ClientConfig* client, absl::flat_hash_map<std::string, std::string>& metadata) {
+  Metadata signed_metadata;
+  sign(client, signed_metadata);
+  signed_metadata.forEach(
+      [&metadata](const std::string& key, const std::string& value) { metadata.insert({key, value}); });
+}
+
+void Signature::sign(ClientConfig* client, Metadata& metadata) {
+  assert(client);
+
+  auto common_headers = client->commonHeaders();
+  if (common_headers) {
+    metadata.share(std::move(common_headers));
+  } else {
+    Metadata::Entries headers;
+    commonHeaders(client, headers);
+    for (auto& header : headers) {
+      metadata.insert(std::move(header));
+    }
   }
 
-  absl::Time now = absl::Now();
-  absl::TimeZone utc_time_zone = absl::UTCTimeZone();
-  const std::string request_date_time = absl::FormatTime(MetadataConstants::DATE_TIME_FORMAT, now, utc_time_zone);
-  metadata.insert({MetadataConstants::DATE_TIME_KEY, request_date_time});
+  std::int64_t second = absl::ToUnixSeconds(absl::Now());
+  metadata.insert({MetadataConstants::DATE_TIME_KEY, dateTime(second)});
 
   if (client->credentialsProvider()) {
     Credentials&& credentials = client->credentialsProvider()->getCredentials();
@@ -51,26 +149,7 @@ void Signature::sign(ClientConfig* client, absl::flat_hash_map<std::string, std:
       return;
     }
 
-    std::string authorization;
-    authorization.append(MetadataConstants::ALGORITHM_KEY)
-        .append(" ")
-        .append(MetadataConstants::CREDENTIAL_KEY)
-        .append("=")
-        .append(credentials.accessKey())
-        .append("/")
-        .append(client->region())
-        .append("/")
-        .append(client->serviceName())
-        .append(", ")
-        .append(MetadataConstants::SIGNED_HEADERS_KEY)
-        .append("=")
-        .append(MetadataConstants::DATE_TIME_KEY)
-        .append(", ")
-        .append(MetadataConstants::SIGNATURE_KEY)
-        .append("=")
-        .append(TlsHelper::sign(credentials.accessSecret(), request_date_time));
-    SPDLOG_DEBUG("Add authorization header: {}", authorization);
-    metadata.insert({MetadataConstants::AUTHORIZATION, authorization});
+    metadata.insert({MetadataConstants::AUTHORIZATION, authorization(client, credentials, second)});
 
     if (!credentials.sessionToken().empty()) {
       metadata.insert({MetadataConstants::STS_SESSION_TOKEN, credentials.sessionToken()});
@@ -78,4 +157,4 @@ void Signature::sign(ClientConfig* client, absl::flat_hash_map<std::string, std:
   }
 }
 
-ROCKETMQ_NAMESPACE_END
\ No newline at end of file
+ROCKETMQ_NAMESPACE_END
@@ -23,18 +23,43 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+namespace {
+
+/**
+ * @brief HMAC context keyed by the most recently used secret. Signing with the same secret again only resets the
+ * context, skipping allocation and key schedule.
+ */
+struct KeyedHmacContext {
+  KeyedHmacContext() : ctx(HMAC_CTX_new()) {
+  }
+
+  ~KeyedHmacContext() {
+    HMAC_CTX_free(ctx);
+  }
+
+  KeyedHmacContext(const KeyedHmacContext&) = delete;
+  KeyedHmacContext& operator=(const KeyedHmacContext&) = delete;
+
+  HMAC_CTX* ctx;
+  std::string key;
+  bool keyed{false};
+};
+
+} // namespace
+
 std::string TlsHelper::sign(const std::string& access_secret, const std::string& content) {
-  HMAC_CTX* ctx = HMAC_CTX_new();
-  HMAC_Init_ex(ctx, access_secret.c_str(), access_secret.length(), EVP_sha1(), nullptr);
-  HMAC_Update(ctx, reinterpret_cast<const unsigned char*>(content.c_str()), content.length());
-  auto result = new unsigned char[EVP_MD_size(EVP_sha1())];
+  static thread_local KeyedHmacContext hmac;
+  if (hmac.keyed && hmac.key == access_secret) {
+    HMAC_Init_ex(hmac.ctx, nullptr, 0, nullptr, nullptr);
+  } else {
+    hmac.keyed = 1 == HMAC_Init_ex(hmac.ctx, access_secret.c_str(), access_secret.length(), EVP_sha1(), nullptr);
+    hmac.key = access_secret;
+  }
+  HMAC_Update(hmac.ctx, reinterpret_cast<const unsigned char*>(content.c_str()), content.length());
+  unsigned char result[EVP_MAX_MD_SIZE];
   unsigned int len;
-  HMAC_Final(ctx, result, &len);
-  HMAC_CTX_free(ctx);
-
-  std::string hex_str = MixAll::hex(result, len);
-  delete[] result;
-  return hex_str;
+  HMAC_Final(hmac.ctx, result, &len);
+  return MixAll::hex(result, len);
 }
 
 ROCKETMQ_NAMESPACE_END
@@ -15,7 +15,14 @@
  * limitations under the License.
  */
 #include "TopicAssignmentInfo.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
 #include "DnsResolver.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_join.h"
 #include "google/rpc/code.pb.h"
 #include "rocketmq/RocketMQ.h"
 #include "spdlog/spdlog.h"
@@ -24,13 +31,14 @@ ROCKETMQ_NAMESPACE_BEGIN
 
 thread_local uint32_t TopicAssignment::query_which_broker_ = 0;
 
-TopicAssignment::TopicAssignment(const QueryAssignmentResponse& response) : debug_string_(response.DebugString()) {
+TopicAssignment::TopicAssignment(const QueryAssignmentResponse& response) {
   if (response.common().status().code() != google::rpc::Code::OK) {
     SPDLOG_WARN("QueryAssignmentResponse#code is not SUCCESS. Keep assignment info intact. QueryAssignmentResponse: {}",
                 response.DebugString());
     return;
   }
 
+  absl::flat_hash_map<std::pair<std::string, std::int32_t>, std::string> service_addresses;
   for (const auto& item : response.assignments()) {
     const rmq::Partition& partition = item.partition();
     if (rmq::Permission::READ != partition.permission() && rmq::Permission::READ_WRITE != partition.permission()) {
@@ -45,52 +53,69 @@ TopicAssignment::TopicAssignment(const QueryAssignmentResponse& response) : debu
       continue;
     }
 
+    // Partitions of a broker share its endpoints, so the address is built, and reverse-resolved, once per broker.
+    std::pair<std::string, std::int32_t> key(broker.name(), broker.id());
+    auto search = service_addresses.find(key);
+    if (service_addresses.end() == search) {
+      search = service_addresses.emplace(std::move(key), serviceAddressOf(broker)).first;
+    }
+
     MQMessageQueue message_queue(partition.topic().name(), partition.broker().name(), partition.id());
-    std::string service_address;
-    rmq::AddressScheme scheme;
-    for (const auto& address : broker.endpoints().addresses()) {
-      if (service_address.empty()) {
-        switch (broker.endpoints().scheme()) {
-          case rmq::AddressScheme::IPv4: {
-            auto opt = dnsResolver()->lookupIP(address.host());
-            if (opt) {
-              scheme = rmq::AddressScheme::DOMAIN_NAME;
-              service_address.append("dns:").append(opt.value()).append(":").append(std::to_string(address.port()));
-              SPDLOG_INFO("Replacing ipv4:{}:{} with dns:{}:{}", address.host(), address.port(), opt.value(),
-                          address.port());
-            } else {
-              scheme = rmq::AddressScheme::IPv4;
-              service_address.append("ipv4:");
-            }
-            break;
-          }
-          case rmq::AddressScheme::IPv6: {
-            scheme = rmq::AddressScheme::IPv6;
-            service_address.append("ipv6:");
-            break;
-          }
-          case rmq::AddressScheme::DOMAIN_NAME: {
-            service_address.append("dns:").append(address.host()).append(":").append(std::to_string(address.port()));
+    message_queue.serviceAddress(search->second);
+    assignment_list_.emplace_back(Assignment(message_queue));
+  }
+  std::sort(assignment_list_.begin(), assignment_list_.end());
+}
+
+std::string TopicAssignment::serviceAddressOf(const rmq::Broker& broker) {
+  std::string service_address;
+  rmq::AddressScheme scheme = broker.endpoints().scheme();
+  for (const auto& address : broker.endpoints().addresses()) {
+    if (service_address.empty()) {
+      switch (broker.endpoints().scheme()) {
+        case rmq::AddressScheme::IPv4: {
+          auto opt = dnsResolver()->lookupIP(address.host());
+          if (opt) {
             scheme = rmq::AddressScheme::DOMAIN_NAME;
-            break;
-          }
-          default: {
-            SPDLOG_WARN("Unsupported gRPC naming scheme: {}", address.DebugString());
-            break;
+            service_address.append("dns:").append(opt.value()).append(":").append(std::to_string(address.port()));
+            SPDLOG_INFO("Replacing ipv4:{}:{} with dns:{}:{}", address.host(), address.port(), opt.value(),
+                        address.port());
+          } else {
+            scheme = rmq::AddressScheme::IPv4;
+            service_address.append("ipv4:");
           }
+          break;
+        }
+        case rmq::AddressScheme::IPv6: {
+          scheme = rmq::AddressScheme::IPv6;
+          service_address.append("ipv6:");
+          break;
+        }
+        case rmq::AddressScheme::DOMAIN_NAME: {
+          service_address.append("dns:").append(address.host()).append(":").append(std::to_string(address.port()));
+          scheme = rmq::AddressScheme::DOMAIN_NAME;
+          break;
+        }
+        default: {
+          SPDLOG_WARN("Unsupported gRPC naming scheme: {}", address.DebugString());
+          break;
         }
-      } else {
-        service_address.append(",");
-      }
-      if (rmq::AddressScheme::DOMAIN_NAME == scheme) {
-        break;
       }
-      service_address.append(address.host()).append(":").append(std::to_string(address.port()));
+    } else {
+      service_address.append(",");
     }
-    message_queue.serviceAddress(service_address);
-    assignment_list_.emplace_back(Assignment(message_queue));
+    if (rmq::AddressScheme::DOMAIN_NAME == scheme) {
+      break;
+    }
+    service_address.append(address.host()).append(":").append(std::to_string(address.port()));
   }
-  std::sort(assignment_list_.begin(), assignment_list_.end());
+  return service_address;
+}
+
+std::string TopicAssignment::debugString() const {
+  return absl::StrJoin(assignment_list_, ",", [](std::string* out, const Assignment& assignment) {
+    out->append(assignment.messageQueue().simpleName());
+  });
 }
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "TopicPublishInfo.h"
 #include "TopicRouteData.h"
 
+#include "LockContention.h"
 #include "LoggerImpl.h"
 #include "MixAll.h"
 #include "absl/container/flat_hash_map.h"
@@ -28,9 +29,14 @@ thread_local uint32_t TopicPublishInfo::send_which_queue_ = MixAll::random(0, 10
 
 TopicPublishInfo::TopicPublishInfo(absl::string_view topic, TopicRouteDataPtr topic_route_data)
     : topic_(topic.data(), topic.length()), topic_route_data_(std::move(topic_route_data)) {
+  LockContention::instance().track(&partition_list_mtx_, "TopicPublishInfo::partition_list_mtx_");
   updatePublishInfo();
 }
 
+TopicPublishInfo::~TopicPublishInfo() {
+  LockContention::instance().untrack(&partition_list_mtx_);
+}
+
 bool TopicPublishInfo::selectOneMessageQueue(MQMessageQueue& message_queue) {
   unsigned int index = ++send_which_queue_;
   {
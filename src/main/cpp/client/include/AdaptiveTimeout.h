@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Derive per-endpoint RPC timeouts from latencies recently observed against each endpoint.
+ *
+ * Timeout of an endpoint is the configured percentile of its latency window scaled by a multiplier, bounded below by
+ * a floor and above by the caller's ceiling, typically the remaining budget of the operation. Until enough samples are
+ * gathered, the ceiling applies as is. Calls that run out of time are recorded with the timeout they were given, so a
+ * slowing endpoint pushes its own timeout up instead of getting trapped by it.
+ *
+ * Only short unary calls are supposed to be recorded; long-polling calls would skew the window.
+ */
+class AdaptiveTimeout {
+public:
+  explicit AdaptiveTimeout(double percentile = 0.99, double multiplier = 2.0,
+                           absl::Duration floor = absl::Milliseconds(200), std::size_t window = 128,
+                           std::size_t min_samples = 16)
+      : percentile_(percentile), multiplier_(multiplier), floor_(floor), window_(window), min_samples_(min_samples) {
+  }
+
+  void record(const std::string& endpoint, absl::Duration latency) LOCKS_EXCLUDED(mtx_);
+
+  absl::Duration timeout(const std::string& endpoint, absl::Duration ceiling) const LOCKS_EXCLUDED(mtx_);
+
+  void remove(const std::vector<std::string>& endpoints) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t size() const LOCKS_EXCLUDED(mtx_);
+
+private:
+  struct Samples {
+    std::vector<absl::Duration> latencies;
+
+    /**
+     * @brief Position to overwrite once the window is full.
+     */
+    std::size_t next{0};
+  };
+
+  double percentile_;
+  double multiplier_;
+  absl::Duration floor_;
+  std::size_t window_;
+  std::size_t min_samples_;
+
+  absl::flat_hash_map<std::string, Samples> samples_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+};
+
+ROCKETMQ_NAMESPACE_END
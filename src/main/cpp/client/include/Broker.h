@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ServiceAddress.h"
@@ -49,7 +50,7 @@ public:
     return name_ < other.name_;
   }
 
-  std::string serviceAddress() const {
+  const std::string& serviceAddress() const {
     return service_address_->address();
   }
 
@@ -38,12 +38,18 @@ public:
 
   /**
    * For endpoints that are marked as inactive due to one or multiple business
-   * operation failure, this function is to initiate health-check RPCs; Once the
-   * health-check passes, they are conceptually add back to serve further
-   * business workload.
+   * operation failure, this function is to add them back once they are observed
+   * healthy. Health-check RPCs are only initiated for those without recent
+   * evidence, typically because their channels are idle.
    */
   virtual void healthCheck() = 0;
 
+  /**
+   * Invoked once an endpoint is observed healthy again, either from
+   * connectivity state of its channel or from a successful RPC.
+   */
+  virtual void onEndpointRecovery(const std::string& endpoint) = 0;
+
   virtual void schedule(const std::string& task_name, const std::function<void(void)>& task,
                         std::chrono::milliseconds delay) = 0;
 
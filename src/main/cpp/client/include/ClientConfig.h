@@ -16,10 +16,12 @@
  */
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "absl/time/time.h"
 
+#include "Metadata.h"
 #include "rocketmq/CredentialsProvider.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
@@ -47,6 +49,14 @@ public:
   virtual std::string clientId() const = 0;
 
   virtual bool isTracingEnabled() const = 0;
+
+  /**
+   * @brief Headers common to all calls of this client, prebuilt and shared. nullptr if the client does not cache them,
+   * in which case they are built per call.
+   */
+  virtual std::shared_ptr<const Metadata::Entries> commonHeaders() {
+    return nullptr;
+  }
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
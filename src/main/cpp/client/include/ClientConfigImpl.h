@@ -22,7 +22,9 @@
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 
 #include "ClientConfig.h"
@@ -41,6 +43,7 @@ public:
 
   void resourceNamespace(absl::string_view resource_namespace) {
     resource_namespace_ = std::string(resource_namespace.data(), resource_namespace.length());
+    resetCommonHeaders();
   }
 
   std::string clientId() const override;
@@ -97,11 +100,14 @@ public:
 
   void tenantId(std::string tenant_id) {
     tenant_id_ = std::move(tenant_id);
+    resetCommonHeaders();
   }
   const std::string& tenantId() const override {
     return tenant_id_;
   }
 
+  std::shared_ptr<const Metadata::Entries> commonHeaders() override LOCKS_EXCLUDED(common_headers_mtx_);
+
   static const char* CLIENT_VERSION;
 
 protected:
@@ -140,6 +146,14 @@ protected:
 
   std::atomic<bool> enable_tracing_{true};
 
+  /**
+   * Built on first use; dropped whenever tenant or namespace changes.
+   */
+  std::shared_ptr<const Metadata::Entries> common_headers_ GUARDED_BY(common_headers_mtx_);
+  absl::Mutex common_headers_mtx_;
+
+  void resetCommonHeaders() LOCKS_EXCLUDED(common_headers_mtx_);
+
   static std::string steadyName();
 };
 
@@ -22,6 +22,9 @@
 #include <system_error>
 
 #include "Client.h"
+#include "EndpointHealthTracker.h"
+#include "MemoryQuota.h"
+#include "Metadata.h"
 #include "ReceiveMessageCallback.h"
 #include "RpcClient.h"
 #include "Scheduler.h"
@@ -32,8 +35,6 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
-using Metadata = absl::flat_hash_map<std::string, std::string>;
-
 class ClientManager {
 public:
   virtual ~ClientManager() = default;
@@ -71,6 +72,11 @@ public:
       std::chrono::milliseconds timeout,
       const std::function<void(const InvocationContext<ForwardMessageToDeadLetterQueueResponse>*)>& cb) = 0;
 
+  virtual void changeInvisibleDuration(
+      const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+      std::chrono::milliseconds timeout,
+      const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) = 0;
+
   virtual void endTransaction(const std::string& target_host, const Metadata& metadata,
                               const EndTransactionRequest& request, std::chrono::milliseconds timeout,
                               const std::function<void(const std::error_code&, const EndTransactionResponse&)>& cb) = 0;
@@ -84,6 +90,11 @@ public:
               std::chrono::milliseconds timeout,
               const std::function<void(const std::error_code&, const InvocationContext<HealthCheckResponse>*)>& cb) = 0;
 
+  /**
+   * @brief Health of the endpoint as passively observed from connectivity state and outcome of RPCs.
+   */
+  virtual EndpointHealth endpointHealth(const std::string& endpoint) = 0;
+
   virtual void addClientObserver(std::weak_ptr<Client> client) = 0;
 
   virtual void
@@ -95,11 +106,11 @@ public:
                               std::chrono::milliseconds timeout, const std::shared_ptr<ReceiveMessageCallback>& cb) = 0;
 
   virtual bool send(const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                    SendCallback* cb) = 0;
+                    std::chrono::milliseconds timeout, SendCallback* cb) = 0;
 
   virtual void pullMessage(const std::string& target_host, const Metadata& metadata, const PullMessageRequest& request,
                            std::chrono::milliseconds timeout,
-                           const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) = 0;
+                           const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) = 0;
 
   virtual std::error_code notifyClientTermination(const std::string& target_host, const Metadata& metadata,
                                                   const NotifyClientTerminationRequest& request,
@@ -115,6 +126,11 @@ public:
 
   virtual State state() const = 0;
 
+  /**
+   * @brief Memory quota shared by all receiving clients of this runtime.
+   */
+  virtual std::shared_ptr<MemoryQuota> memoryQuota() = 0;
+
   virtual void submit(std::function<void()> task) = 0;
 };
 
@@ -31,16 +31,21 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "grpcpp/resource_quota.h"
 
+#include "AdaptiveTimeout.h"
 #include "Client.h"
 #include "ClientManager.h"
+#include "EndpointHealthTracker.h"
 #include "HeartbeatDataCallback.h"
 #include "Histogram.h"
 #include "InvocationContext.h"
+#include "MemoryQuota.h"
 #include "OrphanTransactionCallback.h"
 #include "ReceiveMessageCallback.h"
 #include "RpcClient.h"
 #include "RpcClientImpl.h"
+#include "RpcMetrics.h"
 #include "SchedulerImpl.h"
 #include "SendMessageContext.h"
 #include "ThreadPoolImpl.h"
@@ -70,8 +75,36 @@ public:
 
   static void assignLabels(Histogram& histogram);
 
+  /**
+   * @return Full names of methods of the messaging service, for which RPC metrics are accounted separately.
+   */
+  static std::vector<std::string> rpcMethods();
+
+  /**
+   * @brief Create a channel with the configured interceptor chain: per-endpoint metrics unless disabled through
+   * ROCKETMQ_RPC_METRICS=false, followed by payload logging if enabled through ROCKETMQ_RPC_LOG=true. Without any
+   * interceptor, channels are created plain and calls bear no interception cost.
+   */
   std::shared_ptr<grpc::Channel> createChannel(const std::string& target_host) override;
 
+  /**
+   * @brief Affect channels created afterwards only.
+   */
+  void rpcMetricsEnabled(bool enabled) {
+    rpc_metrics_enabled_ = enabled;
+  }
+
+  void rpcLogEnabled(bool enabled) {
+    rpc_log_enabled_ = enabled;
+  }
+
+  /**
+   * @brief Enabled by default; disable through ROCKETMQ_ADAPTIVE_TIMEOUT=false to always apply the timeout given.
+   */
+  void adaptiveTimeoutEnabled(bool enabled) {
+    adaptive_timeout_enabled_ = enabled;
+  }
+
   /**
    * Resolve route data from name server for the given topic.
    *
@@ -86,6 +119,10 @@ public:
                     const std::function<void(const std::error_code&, const TopicRouteDataPtr&)>& cb) override
       LOCKS_EXCLUDED(rpc_clients_mtx_);
 
+  /**
+   * Fallback for endpoints that cannot be judged passively: clients probe their isolated endpoints only if no recent
+   * evidence about them has been observed.
+   */
   void doHealthCheck() LOCKS_EXCLUDED(clients_mtx_);
 
   /**
@@ -94,6 +131,8 @@ public:
    */
   std::vector<std::string> cleanOfflineRpcClients() LOCKS_EXCLUDED(clients_mtx_, rpc_clients_mtx_);
 
+  void doCleanOfflineRpcClients() LOCKS_EXCLUDED(clients_mtx_, rpc_clients_mtx_);
+
   /**
    * Execute health-check on behalf of the client.
    */
@@ -102,8 +141,14 @@ public:
                    const std::function<void(const std::error_code&, const InvocationContext<HealthCheckResponse>*)>& cb)
       override LOCKS_EXCLUDED(rpc_clients_mtx_);
 
+  EndpointHealth endpointHealth(const std::string& endpoint) override;
+
+  /**
+   * @param timeout Remaining budget of the send operation. The attempt may be given less if the target host has been
+   * answering faster, so that a stalled attempt fails over early.
+   */
   bool send(const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-            SendCallback* cb) override LOCKS_EXCLUDED(rpc_clients_mtx_);
+            std::chrono::milliseconds timeout, SendCallback* cb) override LOCKS_EXCLUDED(rpc_clients_mtx_);
 
   /**
    * Get a RpcClient according to the given target hosts, which follows scheme specified
@@ -121,6 +166,8 @@ public:
 
   static SendResult processSendResponse(const MQMessageQueue& message_queue, const SendMessageResponse& response);
 
+  static Permission permissionOf(rmq::Permission permission);
+
   // only for test
   void addRpcClient(const std::string& target_host, const RpcClientSharedPtr& client) LOCKS_EXCLUDED(rpc_clients_mtx_);
 
@@ -164,6 +211,17 @@ public:
       std::chrono::milliseconds timeout,
       const std::function<void(const InvocationContext<ForwardMessageToDeadLetterQueueResponse>*)>& cb) override;
 
+  /**
+   * Extend invisible duration of in-flight messages of the same broker asynchronously.
+   * @param target_host Target broker host address.
+   * @param request Batch of messages to extend invisible duration for.
+   * @param cb Callback with per-entry results, including renewed receipt handles.
+   */
+  void changeInvisibleDuration(
+      const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+      std::chrono::milliseconds timeout,
+      const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) override;
+
   /**
    * End a transaction asynchronously.
    *
@@ -192,7 +250,7 @@ public:
 
   void pullMessage(const std::string& target_host, const Metadata& metadata, const PullMessageRequest& request,
                    std::chrono::milliseconds timeout,
-                   const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) override;
+                   const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) override;
 
   std::error_code notifyClientTermination(const std::string& target_host, const Metadata& metadata,
                                           const NotifyClientTerminationRequest& request,
@@ -216,6 +274,18 @@ public:
 
   State state() const override;
 
+  std::shared_ptr<MemoryQuota> memoryQuota() override {
+    return memory_quota_;
+  }
+
+  /**
+   * @brief Resize memory quota of this runtime, which bounds both transport buffers of gRPC and messages cached by
+   * process queues. Defaults to ROCKETMQ_MEMORY_QUOTA bytes if set, MixAll::DEFAULT_MEMORY_QUOTA otherwise.
+   *
+   * @param bytes New size of the quota. 0 is rejected with a warning, leaving the quota as it is.
+   */
+  void memoryQuota(std::uint64_t bytes);
+
   void submit(std::function<void()> task) override;
 
 private:
@@ -223,13 +293,36 @@ private:
 
   void pollCompletionQueue();
 
+  /**
+   * @brief Derive health of the endpoint from outcome of an RPC completed against it.
+   */
+  void onRpcCompletion(const std::string& endpoint, bool ok, const grpc::Status& status);
+
+  /**
+   * @return true if the connectivity state should still be watched.
+   */
+  bool onConnectivityState(const std::string& endpoint, grpc_connectivity_state state);
+
+  void notifyEndpointRecovery(const std::string& endpoint) LOCKS_EXCLUDED(clients_mtx_);
+
   void logStats();
 
+  /**
+   * @brief Set deadline of a short call to the adaptive timeout of the target host, capped by the given timeout.
+   */
+  void adaptDeadline(BaseInvocationContext* invocation_context, std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Feed latency of a completed call back to the adaptive timeout of its remote host.
+   */
+  void onAdaptiveCallCompletion(const BaseInvocationContext* invocation_context);
+
   SchedulerSharedPtr scheduler_;
 
   static const char* HEARTBEAT_TASK_NAME;
   static const char* STATS_TASK_NAME;
   static const char* HEALTH_CHECK_TASK_NAME;
+  static const char* CLEAN_RPC_CLIENT_TASK_NAME;
 
   std::string resource_namespace_;
 
@@ -241,8 +334,17 @@ private:
   absl::flat_hash_map<std::string, std::shared_ptr<RpcClient>> rpc_clients_ GUARDED_BY(rpc_clients_mtx_);
   absl::Mutex rpc_clients_mtx_; // protects rpc_clients_
 
+  /**
+   * Held while arming connectivity watches and while leaving STARTED, such that no watch is armed on the completion
+   * queue once its shutdown is under way.
+   */
+  absl::Mutex watch_mtx_;
+
   std::uint32_t heartbeat_task_id_{0};
   std::uint32_t health_check_task_id_{0};
+  std::uint32_t clean_rpc_client_task_id_{0};
+
+  EndpointHealthTracker endpoint_health_;
   std::uint32_t stats_task_id_{0};
 
   std::shared_ptr<CompletionQueue> completion_queue_;
@@ -252,6 +354,16 @@ private:
 
   Histogram latency_histogram_;
 
+  RpcMetrics rpc_metrics_;
+  std::atomic<bool> rpc_metrics_enabled_{true};
+  std::atomic<bool> rpc_log_enabled_{false};
+
+  std::shared_ptr<MemoryQuota> memory_quota_;
+  grpc::ResourceQuota resource_quota_;
+
+  AdaptiveTimeout adaptive_timeout_;
+  std::atomic<bool> adaptive_timeout_enabled_{true};
+
   absl::flat_hash_set<std::string> exporter_endpoint_set_ GUARDED_BY(exporter_endpoint_set_mtx_);
   absl::Mutex exporter_endpoint_set_mtx_;
 
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+enum class EndpointHealth : std::uint8_t
+{
+  /**
+   * @brief No fresh evidence about the endpoint, typically because its channel is idle. An active probe is required to
+   * tell.
+   */
+  Unknown = 0,
+
+  Healthy = 1,
+
+  Unhealthy = 2,
+};
+
+/**
+ * @brief Passively derive health of remote endpoints from what has been observed, namely, connectivity state of their
+ * channels and outcome of real RPCs, rather than from dedicated health-check traffic.
+ */
+class EndpointHealthTracker {
+public:
+  explicit EndpointHealthTracker(absl::Duration freshness = absl::Seconds(30)) : freshness_(freshness) {
+  }
+
+  /**
+   * @brief Record evidence that the endpoint is reachable.
+   *
+   * @return true if the endpoint was previously considered unhealthy, that is, it just recovered.
+   */
+  bool onSuccess(const std::string& endpoint, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Record evidence that the endpoint is unreachable.
+   *
+   * @return true if the endpoint was previously considered healthy.
+   */
+  bool onFailure(const std::string& endpoint, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Health of the endpoint according to evidence observed within the freshness window.
+   */
+  EndpointHealth health(const std::string& endpoint, absl::Time now = absl::Now()) const LOCKS_EXCLUDED(mtx_);
+
+  void remove(const std::vector<std::string>& endpoints) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t size() const LOCKS_EXCLUDED(mtx_);
+
+private:
+  struct Evidence {
+    bool healthy{true};
+    absl::Time observed_time{absl::InfinitePast()};
+  };
+
+  absl::Duration freshness_;
+
+  absl::flat_hash_map<std::string, Evidence> evidences_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -20,6 +20,9 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+/**
+ * @brief Dumps headers and payloads of every call at debug level. Debugging aid, installed only on demand.
+ */
 class LogInterceptor : public grpc::experimental::Interceptor {
 public:
   explicit LogInterceptor(grpc::experimental::ClientRpcInfo* client_rpc_info) : client_rpc_info_(client_rpc_info) {
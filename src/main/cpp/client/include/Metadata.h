@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "grpcpp/client_context.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Headers of one RPC.
+ *
+ * Headers that stay the same for every call of a client, for example, language, versions, tenant and namespace, are
+ * built once into an immutable, ref-counted block that calls share. Only entries specific to the call, typically
+ * date-time and authorization, are inserted one by one.
+ */
+class Metadata {
+public:
+  using Entries = absl::flat_hash_map<std::string, std::string>;
+
+  Metadata() = default;
+
+  Metadata(Entries entries) : entries_(std::move(entries)) {
+  }
+
+  void share(std::shared_ptr<const Entries> common) {
+    common_ = std::move(common);
+  }
+
+  std::pair<Entries::iterator, bool> insert(Entries::value_type entry) {
+    return entries_.insert(std::move(entry));
+  }
+
+  bool empty() const {
+    return (!common_ || common_->empty()) && entries_.empty();
+  }
+
+  /**
+   * @brief Visit shared headers first, then those of this call.
+   */
+  template <typename Visitor>
+  void forEach(Visitor visitor) const {
+    if (common_) {
+      for (const auto& entry : *common_) {
+        visitor(entry.first, entry.second);
+      }
+    }
+    for (const auto& entry : entries_) {
+      visitor(entry.first, entry.second);
+    }
+  }
+
+  void attach(grpc::ClientContext& context) const;
+
+  /**
+   * @brief Render as comma-separated key=value pairs, for logging.
+   */
+  std::string toString() const;
+
+private:
+  std::shared_ptr<const Entries> common_;
+  Entries entries_;
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -70,6 +71,8 @@ using ForwardMessageToDeadLetterQueueRequest = rmq::ForwardMessageToDeadLetterQu
 using ForwardMessageToDeadLetterQueueResponse = rmq::ForwardMessageToDeadLetterQueueResponse;
 using NotifyClientTerminationRequest = rmq::NotifyClientTerminationRequest;
 using NotifyClientTerminationResponse = rmq::NotifyClientTerminationResponse;
+using ChangeInvisibleDurationRequest = rmq::ChangeInvisibleDurationRequest;
+using ChangeInvisibleDurationResponse = rmq::ChangeInvisibleDurationResponse;
 
 /**
  * @brief A RpcClient represents a session between client and a remote broker.
@@ -123,6 +126,9 @@ public:
       const ForwardMessageToDeadLetterQueueRequest& request,
       InvocationContext<ForwardMessageToDeadLetterQueueResponse>* invocation_context) = 0;
 
+  virtual void asyncChangeInvisibleDuration(const ChangeInvisibleDurationRequest& request,
+                                            InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) = 0;
+
   virtual grpc::Status reportThreadStackTrace(grpc::ClientContext* context,
                                               const ReportThreadStackTraceRequest& request,
                                               ReportThreadStackTraceResponse* response) = 0;
@@ -149,6 +155,14 @@ public:
    * @return true if underlying connection is OK or recoverable; false otherwise.
    */
   virtual bool ok() const = 0;
+
+  /**
+   * @brief Watch connectivity state of the underlying channel without generating any network traffic.
+   *
+   * @param cb Invoked with the latest connectivity state whenever it changes, and periodically while it stays the same.
+   * Watching continues as long as it returns true and the channel is not shut down.
+   */
+  virtual void watchConnectivityState(std::function<bool(grpc_connectivity_state)> cb) = 0;
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
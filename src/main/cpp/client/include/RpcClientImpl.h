@@ -24,6 +24,8 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+struct ConnectivityWatch;
+
 class RpcClientImpl : public RpcClient, public std::enable_shared_from_this<RpcClientImpl> {
 public:
   RpcClientImpl(std::shared_ptr<CompletionQueue> completion_queue, std::shared_ptr<Channel> channel,
@@ -79,6 +81,9 @@ public:
       const ForwardMessageToDeadLetterQueueRequest& request,
       InvocationContext<ForwardMessageToDeadLetterQueueResponse>* invocation_context) override;
 
+  void asyncChangeInvisibleDuration(const ChangeInvisibleDurationRequest& request,
+                                    InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) override;
+
   grpc::Status reportThreadStackTrace(grpc::ClientContext* context, const ReportThreadStackTraceRequest& request,
                                       ReportThreadStackTraceResponse* response) override;
 
@@ -95,7 +100,21 @@ public:
 
   bool ok() const override;
 
+  void watchConnectivityState(std::function<bool(grpc_connectivity_state)> cb) override;
+
 private:
+  friend struct ConnectivityWatch;
+
+  /**
+   * @brief Re-arm the watch if the channel may still change state. Takes ownership of the watch.
+   */
+  void watch(ConnectivityWatch* watch);
+
+  /**
+   * @brief Deadline of each round of watch, after which the callback is invoked with unchanged state.
+   */
+  static const std::chrono::seconds CONNECTIVITY_WATCH_INTERVAL;
+
   static void addMetadata(grpc::ClientContext& context, const absl::flat_hash_map<std::string, std::string>& metadata);
 
   std::shared_ptr<CompletionQueue> completion_queue_;
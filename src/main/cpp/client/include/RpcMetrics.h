@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+#include "Histogram.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief RPC traffic of one endpoint: bytes sent and received, time spent serializing requests, calls in flight and
+ * latency per method.
+ *
+ * All counters are plain atomics so that interceptors record them without locking. The per-method table is built
+ * once, on construction, from the methods given and never changes afterwards; calls to other methods are accounted
+ * together as "others".
+ */
+class EndpointMetrics {
+public:
+  EndpointMetrics(std::string endpoint, const std::vector<std::string>& methods);
+
+  void onStart() {
+    inflight_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void onSerialized(std::size_t bytes, std::chrono::nanoseconds elapsed) {
+    bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+    serialization_nanos_.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @param bytes Encoded size of the response.
+   */
+  void onReceived(std::size_t bytes) {
+    bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void onComplete(absl::string_view method, bool ok, std::chrono::nanoseconds latency);
+
+  std::int64_t inflight() const {
+    return inflight_.load(std::memory_order_relaxed);
+  }
+
+  const std::string& endpoint() const {
+    return endpoint_;
+  }
+
+  /**
+   * @brief Render traffic since last report. In-flight count is a gauge and is never reset.
+   */
+  void reportAndReset(std::string& stats);
+
+private:
+  struct MethodMetrics {
+    MethodMetrics();
+
+    std::atomic<std::int64_t> calls{0};
+    std::atomic<std::int64_t> failures{0};
+    Histogram latency;
+  };
+
+  const std::string endpoint_;
+
+  std::atomic<std::int64_t> inflight_{0};
+  std::atomic<std::uint64_t> bytes_sent_{0};
+  std::atomic<std::uint64_t> bytes_received_{0};
+  std::atomic<std::int64_t> serialization_nanos_{0};
+
+  absl::flat_hash_map<std::string, std::unique_ptr<MethodMetrics>> methods_;
+  MethodMetrics others_;
+
+  static void report(absl::string_view method, MethodMetrics& metrics, std::string& stats);
+};
+
+/**
+ * @brief Registry of EndpointMetrics, one per endpoint that a channel is created to.
+ */
+class RpcMetrics {
+public:
+  RpcMetrics() = default;
+
+  /**
+   * @param methods Full names of RPC methods, in form of /package.Service/Method, to account separately.
+   */
+  explicit RpcMetrics(std::vector<std::string> methods) : methods_(std::move(methods)) {
+  }
+
+  std::shared_ptr<EndpointMetrics> endpoint(const std::string& endpoint) LOCKS_EXCLUDED(mtx_);
+
+  void remove(const std::vector<std::string>& endpoints) LOCKS_EXCLUDED(mtx_);
+
+  void reportAndReset(std::vector<std::string>& stats) LOCKS_EXCLUDED(mtx_);
+
+private:
+  const std::vector<std::string> methods_;
+  absl::flat_hash_map<std::string, std::shared_ptr<EndpointMetrics>> endpoints_ GUARDED_BY(mtx_);
+  absl::Mutex mtx_;
+};
+
+ROCKETMQ_NAMESPACE_END
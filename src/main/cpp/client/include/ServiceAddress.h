@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -80,6 +81,7 @@ public:
   ServiceAddress(AddressScheme scheme, std::vector<Address> addresses)
       : scheme_(scheme), addresses_(std::move(addresses)) {
     std::sort(addresses_.begin(), addresses_.end());
+    address_ = render();
   }
 
   AddressScheme scheme() const {
@@ -90,7 +92,19 @@ public:
     return !addresses_.empty();
   }
 
-  std::string address() const {
+  /**
+   * @brief Target string in the gRPC naming format, rendered once as the class is immutable.
+   */
+  const std::string& address() const {
+    return address_;
+  }
+
+private:
+  AddressScheme scheme_;
+  std::vector<Address> addresses_;
+  std::string address_;
+
+  std::string render() const {
     std::string result;
     switch (scheme_) {
       case AddressScheme::IPv4:
@@ -115,10 +129,6 @@ public:
     }
     return result;
   }
-
-private:
-  AddressScheme scheme_;
-  std::vector<Address> addresses_;
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -16,15 +16,38 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <string>
+
 #include "absl/container/flat_hash_map.h"
 
 #include "ClientConfig.h"
+#include "Metadata.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
 class Signature {
 public:
+  /**
+   * @brief Attach headers common to all calls of the client, then add date-time and, if credentials are provided,
+   * authorization. Both are computed at most once per second on each thread.
+   */
+  static void sign(ClientConfig* client, Metadata& metadata);
+
+  /**
+   * @brief Same headers as above, expanded into a plain map.
+   */
   static void sign(ClientConfig* client, absl::flat_hash_map<std::string, std::string>& metadata);
+
+  /**
+   * @brief Headers that stay the same for every call of the client: language, versions, tenant and namespace.
+   */
+  static void commonHeaders(ClientConfig* client, Metadata::Entries& headers);
+
+private:
+  static const std::string& dateTime(std::int64_t second);
+
+  static const std::string& authorization(ClientConfig* client, const Credentials& credentials, std::int64_t second);
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
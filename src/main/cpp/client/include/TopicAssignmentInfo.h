@@ -17,6 +17,7 @@
 #pragma once
 
 #include <atomic>
+#include <string>
 #include <vector>
 
 #include "Assignment.h"
@@ -46,9 +47,11 @@ public:
     return assignment_list_ != rhs.assignment_list_;
   }
 
-  const std::string& debugString() const {
-    return debug_string_;
-  }
+  /**
+   * @brief Render the assignments for diagnostics. It is built on demand rather than kept along, as it is rarely
+   * needed.
+   */
+  std::string debugString() const;
 
   static unsigned int getAndIncreaseQueryWhichBroker() {
     return ++query_which_broker_;
@@ -60,9 +63,9 @@ private:
    */
   std::vector<Assignment> assignment_list_;
 
-  std::string debug_string_;
-
   thread_local static uint32_t query_which_broker_;
+
+  static std::string serviceAddressOf(const rmq::Broker& broker);
 };
 
 using TopicAssignmentPtr = std::shared_ptr<TopicAssignment>;
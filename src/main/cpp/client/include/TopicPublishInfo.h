@@ -32,6 +32,8 @@ class TopicPublishInfo {
 public:
   TopicPublishInfo(absl::string_view topic, TopicRouteDataPtr topic_route_data);
 
+  ~TopicPublishInfo();
+
   /**
    * @param message_queue Reference to target message queue.
    * @return true if manage to select one; false otherwise.
@@ -66,6 +66,11 @@ public:
                (const std::function<void(const InvocationContext<ForwardMessageToDeadLetterQueueResponse>*)>&)),
               (override));
 
+  MOCK_METHOD(void, changeInvisibleDuration,
+              (const std::string&, const Metadata&, const ChangeInvisibleDurationRequest&, std::chrono::milliseconds,
+               (const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>&)),
+              (override));
+
   MOCK_METHOD(void, endTransaction,
               (const std::string&, const Metadata&, const EndTransactionRequest&, std::chrono::milliseconds,
                (const std::function<void(const std::error_code&, const EndTransactionResponse&)>&)),
@@ -81,6 +86,8 @@ public:
                (const std::function<void(const std::error_code&, const InvocationContext<HealthCheckResponse>*)>&)),
               (override));
 
+  MOCK_METHOD(EndpointHealth, endpointHealth, (const std::string&), (override));
+
   MOCK_METHOD(void, addClientObserver, (std::weak_ptr<Client>), (override));
 
   MOCK_METHOD(void, queryAssignment,
@@ -93,11 +100,13 @@ public:
                (const std::shared_ptr<ReceiveMessageCallback>&)),
               (override));
 
-  MOCK_METHOD(bool, send, (const std::string&, const Metadata&, SendMessageRequest&, SendCallback*), (override));
+  MOCK_METHOD(bool, send,
+              (const std::string&, const Metadata&, SendMessageRequest&, std::chrono::milliseconds, SendCallback*),
+              (override));
 
   MOCK_METHOD(void, pullMessage,
               (const std::string&, const Metadata&, const PullMessageRequest&, std::chrono::milliseconds,
-               (const std::function<void(const std::error_code&, const ReceiveMessageResult&)>&)),
+               (const std::function<void(const std::error_code&, ReceiveMessageResult&)>&)),
               (override));
 
   MOCK_METHOD(std::error_code, notifyClientTermination,
@@ -115,6 +124,8 @@ public:
 
   MOCK_METHOD(State, state, (), (const override));
 
+  MOCK_METHOD(std::shared_ptr<MemoryQuota>, memoryQuota, (), (override));
+
   MOCK_METHOD(void, submit, (std::function<void()>), (override));
 };
 
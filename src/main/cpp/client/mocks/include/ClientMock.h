@@ -33,6 +33,8 @@ public:
 
   MOCK_METHOD(void, healthCheck, (), (override));
 
+  MOCK_METHOD(void, onEndpointRecovery, (const std::string&), (override));
+
   MOCK_METHOD(void, schedule, (const std::string&, const std::function<void()>&, std::chrono::milliseconds),
               (override));
 
@@ -63,6 +63,10 @@ public:
                InvocationContext<ForwardMessageToDeadLetterQueueResponse>*),
               (override));
 
+  MOCK_METHOD(void, asyncChangeInvisibleDuration,
+              (const ChangeInvisibleDurationRequest&, InvocationContext<ChangeInvisibleDurationResponse>*),
+              (override));
+
   MOCK_METHOD(void, asyncPollCommand, (const PollCommandRequest&, InvocationContext<PollCommandResponse>*), (override));
 
   MOCK_METHOD(grpc::Status, reportThreadStackTrace,
@@ -84,6 +88,8 @@ public:
 
   MOCK_METHOD(bool, ok, (), (const override));
 
+  MOCK_METHOD(void, watchConnectivityState, (std::function<bool(grpc_connectivity_state)>), (override));
+
 protected:
   std::shared_ptr<grpc::CompletionQueue> completion_queue_;
 };
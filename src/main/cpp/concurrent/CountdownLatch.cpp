@@ -15,38 +15,54 @@
  * limitations under the License.
  */
 #include "CountdownLatch.h"
-#include "LoggerImpl.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
 void CountdownLatch::await() {
-  absl::MutexLock lock(&mtx_);
-  if (count_ <= 0) {
+  if (count() <= 0) {
     return;
   }
-  while (count_ > 0) {
+
+  absl::MutexLock lock(&mtx_);
+  // Register as a parked waiter, unless the latch opened in the meantime. Registration and countdown() modify the same
+  // word, so either countdown() sees this waiter and releases it, or this waiter sees the latch open.
+  uint64_t state = state_.load(std::memory_order_acquire);
+  do {
+    if (countOf(state) <= 0) {
+      return;
+    }
+  } while (!state_.compare_exchange_weak(state, pack(countOf(state), waitersOf(state) + 1), std::memory_order_acq_rel,
+                                         std::memory_order_acquire));
+
+  uint64_t generation = generation_;
+  while (generation == generation_) {
     cv_.Wait(&mtx_);
   }
 }
 
 void CountdownLatch::countdown() {
-  absl::MutexLock lock(&mtx_);
-  if (--count_ <= 0) {
-    cv_.SignalAll();
-  }
-  if (!name_.empty()) {
-    if (count_ >= 0) {
-      SPDLOG_TRACE("After countdown(), latch[{}]={}", name_, count_);
-    }
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    int32_t count = countOf(state) - 1;
+    // Parked waiters are released, thus deregistered, by the countdown that opens the latch.
+    next = pack(count, count <= 0 ? 0 : waitersOf(state));
+  } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  if (countOf(next) > 0 || !waitersOf(state)) {
+    return;
   }
+
+  absl::MutexLock lock(&mtx_);
+  ++generation_;
+  cv_.SignalAll();
 }
 
 void CountdownLatch::increaseCount() {
-  absl::MutexLock lock(&mtx_);
-  ++count_;
-  if (!name_.empty()) {
-    SPDLOG_TRACE("After increaseCount(), latch[{}]={}", name_, count_);
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  while (!state_.compare_exchange_weak(state, pack(countOf(state) + 1, waitersOf(state)), std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
   }
 }
 
-ROCKETMQ_NAMESPACE_END
\ No newline at end of file
+ROCKETMQ_NAMESPACE_END
@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
@@ -26,26 +28,64 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+/**
+ * @brief Latch that is opened once its count drops to zero.
+ *
+ * Count and number of parked waiters share one atomic word. countdown() and increaseCount() are a compare-and-swap
+ * each; the mutex and condition variable are touched only if some waiter is parked when the count reaches zero. This
+ * also makes the latch a cheap one-shot future: publish the result, then countdown() a latch of 1; await() returns
+ * with the result visible.
+ */
 class CountdownLatch {
 public:
   explicit CountdownLatch(int32_t count) : CountdownLatch(count, "anonymous") {
   }
-  CountdownLatch(int32_t count, absl::string_view name) : count_(count), name_(name.data(), name.length()) {
+
+  CountdownLatch(int32_t count, absl::string_view name)
+      : state_(pack(count, 0)), name_(name.data(), name.length()) {
   }
 
   void await() LOCKS_EXCLUDED(mtx_);
 
   void countdown() LOCKS_EXCLUDED(mtx_);
 
-  void increaseCount() LOCKS_EXCLUDED(mtx_);
+  void increaseCount();
+
+  int32_t count() const {
+    return countOf(state_.load(std::memory_order_acquire));
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
 
 private:
-  int32_t count_ GUARDED_BY(mtx_);
+  /**
+   * Lower half is the count; upper half is the number of parked waiters.
+   */
+  std::atomic<uint64_t> state_;
 
-  absl::Mutex mtx_; // protects count_
+  /**
+   * Bumped each time parked waiters are released.
+   */
+  uint64_t generation_ GUARDED_BY(mtx_){0};
+
+  absl::Mutex mtx_;
   absl::CondVar cv_;
 
   std::string name_;
+
+  static uint64_t pack(int32_t count, uint32_t waiters) {
+    return static_cast<uint64_t>(waiters) << 32 | static_cast<uint32_t>(count);
+  }
+
+  static int32_t countOf(uint64_t state) {
+    return static_cast<int32_t>(static_cast<uint32_t>(state));
+  }
+
+  static uint32_t waitersOf(uint64_t state) {
+    return static_cast<uint32_t>(state >> 32);
+  }
 };
 
-ROCKETMQ_NAMESPACE_END
\ No newline at end of file
+ROCKETMQ_NAMESPACE_END
@@ -23,6 +23,7 @@
 #include "LoggerImpl.h"
 #include "PushConsumer.h"
 #include "rocketmq/MessageListener.h"
+#include "rocketmq/MessageModel.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
@@ -38,14 +39,17 @@ void AsyncReceiveMessageCallback::onCompletion(const std::error_code& ec, const
     return;
   }
 
-  std::shared_ptr<PushConsumer> impl = process_queue->getConsumer().lock();
-  if (!impl->active()) {
-    SPDLOG_INFO("Consumer is not active any more. It should be quitting");
+  auto consumer = process_queue->getConsumer().lock();
+  if (!consumer) {
     return;
   }
 
-  auto consumer = process_queue->getConsumer().lock();
-  if (!consumer) {
+  if (!consumer->active()) {
+    SPDLOG_INFO("Consumer is not active any more. It should be quitting");
+    if (!ec && !result.messages.empty() && MessageModel::CLUSTERING == consumer->messageModel()) {
+      // Hand messages received while quitting back to broker immediately.
+      consumer->release(result.messages);
+    }
     return;
   }
 
@@ -58,7 +62,29 @@ void AsyncReceiveMessageCallback::onCompletion(const std::error_code& ec, const
 
   SPDLOG_DEBUG("Received {} messages from broker[host={}] for queue={}", result.messages.size(), result.source_host,
                process_queue->simpleName());
-  impl->getConsumeMessageService()->dispatch(process_queue, result.messages);
+
+  if (MessageModel::BROADCASTING == consumer->messageModel()) {
+    // Messages pulled in broadcasting mode are not strictly filtered by server. Drop non-matching ones before dispatch.
+    auto&& filter_expression = consumer->getFilterExpression(process_queue->messageQueue().getTopic());
+    if (filter_expression.has_value()) {
+      std::vector<MQMessageExt> messages;
+      messages.reserve(result.messages.size());
+      for (const auto& message : result.messages) {
+        if (filter_expression->accept(message)) {
+          messages.push_back(message);
+        }
+      }
+      SPDLOG_DEBUG("{} of {} messages from {} pass client-side filter", messages.size(), result.messages.size(),
+                   process_queue->simpleName());
+      if (!messages.empty()) {
+        consumer->getConsumeMessageService()->dispatch(process_queue, std::move(messages));
+      }
+      checkThrottleThenReceive();
+      return;
+    }
+  }
+
+  consumer->getConsumeMessageService()->dispatch(process_queue, result.messages);
   checkThrottleThenReceive();
 }
 
@@ -71,6 +97,11 @@ void AsyncReceiveMessageCallback::checkThrottleThenReceive() {
     return;
   }
 
+  if (process_queue->park()) {
+    SPDLOG_INFO("{} is paused. Stop receiving messages until it is resumed.", process_queue->simpleName());
+    return;
+  }
+
   if (process_queue->shouldThrottle()) {
     SPDLOG_INFO("Number of messages in {} exceeds throttle threshold. Receive messages later.",
                 process_queue->simpleName());
@@ -19,28 +19,23 @@
 ROCKETMQ_NAMESPACE_BEGIN
 
 void AwaitPullCallback::onSuccess(const PullResult& pull_result) noexcept {
-  absl::MutexLock lk(&mtx_);
-  completed_ = true;
-  // TODO: optimize out messages copy here.
   pull_result_ = pull_result;
-  cv_.SignalAll();
+  latch_.countdown();
+}
+
+void AwaitPullCallback::onSuccess(PullResult&& pull_result) noexcept {
+  pull_result_ = std::move(pull_result);
+  latch_.countdown();
 }
 
 void AwaitPullCallback::onFailure(const std::error_code& ec) noexcept {
-  absl::MutexLock lk(&mtx_);
-  completed_ = true;
   ec_ = ec;
-  cv_.SignalAll();
+  latch_.countdown();
 }
 
 bool AwaitPullCallback::await() {
-  {
-    absl::MutexLock lk(&mtx_);
-    while (!completed_) {
-      cv_.Wait(&mtx_);
-    }
-    return !hasFailure();
-  }
+  latch_.await();
+  return !hasFailure();
 }
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -22,8 +22,9 @@
 ROCKETMQ_NAMESPACE_BEGIN
 
 BroadcastTask::BroadcastTask(std::weak_ptr<ProcessQueue> process_queue,
-                             std::weak_ptr<ConsumeMessageService> consume_message_service)
-    : process_queue_(std::move(process_queue)), consume_message_service_(std::move(consume_message_service)) {
+                             std::weak_ptr<ConsumeMessageService> consume_message_service, ConsumeInvoker invoker)
+    : process_queue_(std::move(process_queue)), consume_message_service_(std::move(consume_message_service)),
+      invoker_(invoker) {
 }
 
 void BroadcastTask::process() {
@@ -38,34 +39,26 @@ void BroadcastTask::process() {
   }
 
   bool expected = false;
-  if (runnable_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
-
+  if (runnable_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
     while (true) {
       auto optional = process_queue->dequeBroadcastMessage();
       if (!optional.has_value()) {
         break;
       }
-      service->preHandle(optional.value());
 
-      ConsumeMessageResult result;
+      slot_.clear();
+      slot_.emplace_back(std::move(optional.value()));
+      const MQMessageExt& message = slot_.front();
 
-      auto listener = service->listener();
-      switch (listener->listenerType()) {
-        case MessageListenerType::FIFO: {
-          result = dynamic_cast<FifoMessageListener*>(listener)->consumeMessage(optional.value());
-          break;
-        }
-        case MessageListenerType::STANDARD: {
-          result = dynamic_cast<StandardMessageListener*>(listener)->consumeMessage({optional.value()});
-          break;
-        }
-      }
-      service->postHandle(optional.value(), result);
-      process_queue->release(optional.value().bodyLength());
+      service->preHandle(message);
+      ConsumeMessageResult result = invoker_(slot_);
+      service->postHandle(message, result);
+      process_queue->release(message.bodyLength());
     }
+    slot_.clear();
 
     expected = true;
-    if (!runnable_.compare_exchange_strong(expected, false, std::memory_order_relaxed)) {
+    if (!runnable_.compare_exchange_strong(expected, false, std::memory_order_release)) {
       SPDLOG_WARN("Unexpected runnable state");
     }
   }
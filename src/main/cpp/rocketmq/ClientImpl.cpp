@@ -33,16 +33,25 @@
 #include "ClientImpl.h"
 #include "ClientManagerImpl.h"
 #include "InvocationContext.h"
+#include "LockContention.h"
 #include "LoggerImpl.h"
 #include "MessageAccessor.h"
 #include "NamingScheme.h"
 #include "Signature.h"
+#include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQMessageExt.h"
 #include "rocketmq/MessageListener.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
 ClientImpl::ClientImpl(absl::string_view group_name) : ClientConfigImpl(group_name), state_(State::CREATED) {
+  LockContention::instance().track(&topic_route_table_mtx_, "ClientImpl::topic_route_table_mtx_");
+  LockContention::instance().track(&route_subscriptions_mtx_, "ClientImpl::route_subscriptions_mtx_");
+}
+
+ClientImpl::~ClientImpl() {
+  LockContention::instance().untrack(&topic_route_table_mtx_);
+  LockContention::instance().untrack(&route_subscriptions_mtx_);
 }
 
 void ClientImpl::start() {
@@ -85,6 +94,7 @@ void ClientImpl::shutdown() {
     if (route_update_handle_) {
       client_manager_->getScheduler()->cancel(route_update_handle_);
     }
+    unsubscribeRoutes();
     client_manager_.reset();
   } else {
     SPDLOG_ERROR("Try to shutdown ClientImpl, but its state is not as expected. Expecting: {}, Actual: {}",
@@ -94,6 +104,8 @@ void ClientImpl::shutdown() {
 
 const char* ClientImpl::UPDATE_ROUTE_TASK_NAME = "route_updater";
 
+const absl::Duration ClientImpl::ROUTE_MAX_AGE = absl::Seconds(25);
+
 void ClientImpl::endpointsInUse(absl::flat_hash_set<std::string>& endpoints) {
   absl::MutexLock lk(&topic_route_table_mtx_);
   for (const auto& item : topic_route_table_) {
@@ -122,36 +134,100 @@ void ClientImpl::getRouteFor(const std::string& topic,
     return;
   }
 
-  bool query_backend = true;
+  RouteKey key;
+  if (!subscribeRoute(topic, key)) {
+    std::error_code ec = ErrorCode::ServiceUnavailable;
+    cb(ec, nullptr);
+    return;
+  }
+
+  std::weak_ptr<ClientImpl> client(self());
+  auto callback = [client, topic, cb](const std::error_code& ec, const TopicRouteDataPtr& route) {
+    std::shared_ptr<ClientImpl> ptr = client.lock();
+    if (ptr) {
+      ptr->updateRouteCache(topic, ec, route);
+    }
+    cb(ec, route);
+  };
+  RouteCache::instance().getRoute(key, std::bind(&ClientImpl::fetchRouteFor, this, topic, std::placeholders::_1),
+                                  callback, io_timeout_);
+}
+
+RouteKey ClientImpl::routeKeyOf(const std::string& topic) {
+  RouteKey key;
+  key.access_point = name_server_resolver_->resolve();
+  if (credentials_provider_) {
+    key.access_key = credentials_provider_->getCredentials().accessKey();
+  }
+  key.resource_namespace = resource_namespace_;
+  key.topic = topic;
+  return key;
+}
+
+RouteCache::Listener ClientImpl::routeListenerOf(const std::string& topic) {
+  std::weak_ptr<ClientImpl> client(self());
+  return [client, topic](const TopicRouteDataPtr& route) {
+    std::shared_ptr<ClientImpl> ptr = client.lock();
+    if (ptr && ptr->active()) {
+      std::error_code ec;
+      ptr->updateRouteCache(topic, ec, route);
+    }
+  };
+}
+
+bool ClientImpl::subscribeRoute(const std::string& topic, RouteKey& key) {
   {
-    absl::MutexLock lk(&inflight_route_requests_mtx_);
-    {
-      absl::MutexLock route_table_lock(&topic_route_table_mtx_);
-      if (topic_route_table_.contains(topic)) {
-        route = topic_route_table_.at(topic);
-        query_backend = false;
-      }
+    absl::MutexLock lk(&route_subscriptions_mtx_);
+    auto search = route_subscriptions_.find(topic);
+    if (route_subscriptions_.end() != search) {
+      key = search->second.key;
+      return true;
     }
+  }
 
-    if (query_backend) {
-      if (inflight_route_requests_.contains(topic)) {
-        inflight_route_requests_.at(topic).emplace_back(cb);
-        SPDLOG_DEBUG("Would reuse prior route request for topic={}", topic);
-        return;
-      } else {
-        std::vector<std::function<void(const std::error_code&, const TopicRouteDataPtr&)>> inflight{cb};
-        inflight_route_requests_.insert({topic, inflight});
-        SPDLOG_INFO("Create inflight route query cache for topic={}", topic);
-      }
+  key = routeKeyOf(topic);
+  if (key.access_point.empty()) {
+    // Clients failing to resolve their name servers would otherwise share one entry, whichever cluster they target.
+    SPDLOG_WARN("No name server available to look up route of topic={}", topic);
+    return false;
+  }
+
+  absl::MutexLock lk(&route_subscriptions_mtx_);
+  auto search = route_subscriptions_.find(topic);
+  if (route_subscriptions_.end() != search) {
+    key = search->second.key;
+    return true;
+  }
+  std::uint64_t id = RouteCache::instance().subscribe(key, routeListenerOf(topic));
+  route_subscriptions_.insert({topic, RouteSubscription{key, id}});
+  SPDLOG_INFO("Subscribed to shared route of topic={} from {}", topic, key.access_point);
+  return true;
+}
+
+void ClientImpl::resubscribeRoute(const std::string& topic, const RouteKey& from, const RouteKey& to) {
+  std::uint64_t previous;
+  {
+    absl::MutexLock lk(&route_subscriptions_mtx_);
+    auto search = route_subscriptions_.find(topic);
+    if (route_subscriptions_.end() == search || search->second.key != from) {
+      // Unsubscribed or moved over concurrently.
+      return;
     }
+    previous = search->second.id;
+    search->second = RouteSubscription{to, RouteCache::instance().subscribe(to, routeListenerOf(topic))};
   }
+  RouteCache::instance().unsubscribe(from, previous);
+  SPDLOG_INFO("Route of topic={} is now shared from {} instead of {}", topic, to.access_point, from.access_point);
+}
 
-  if (!query_backend && route) {
-    std::error_code ec;
-    cb(ec, route);
-  } else {
-    fetchRouteFor(topic,
-                  std::bind(&ClientImpl::onTopicRouteReady, this, topic, std::placeholders::_1, std::placeholders::_2));
+void ClientImpl::unsubscribeRoutes() {
+  absl::flat_hash_map<std::string, RouteSubscription> subscriptions;
+  {
+    absl::MutexLock lk(&route_subscriptions_mtx_);
+    subscriptions.swap(route_subscriptions_);
+  }
+  for (const auto& item : subscriptions) {
+    RouteCache::instance().unsubscribe(item.second.key, item.second.id);
   }
 }
 
@@ -197,11 +273,30 @@ void ClientImpl::setAccessPoint(rmq::Endpoints* endpoints) {
   }
 }
 
+void ClientImpl::queryEndOffset(const MQMessageQueue& message_queue,
+                                const std::function<void(const std::error_code&, std::int64_t)>& cb) {
+  QueryOffsetRequest request;
+  request.mutable_partition()->mutable_topic()->set_resource_namespace(resource_namespace_);
+  request.mutable_partition()->mutable_topic()->set_name(message_queue.getTopic());
+  request.mutable_partition()->set_id(message_queue.getQueueId());
+  request.mutable_partition()->mutable_broker()->set_name(message_queue.getBrokerName());
+  request.set_policy(rmq::QueryOffsetPolicy::END);
+  Metadata metadata;
+  Signature::sign(this, metadata);
+  auto callback = [cb](const std::error_code& ec, const QueryOffsetResponse& response) {
+    cb(ec, ec ? -1 : response.offset());
+  };
+  client_manager_->queryOffset(message_queue.serviceAddress(), metadata, request,
+                               absl::ToChronoMilliseconds(io_timeout_), callback);
+}
+
 void ClientImpl::fetchRouteFor(const std::string& topic,
                                const std::function<void(const std::error_code&, const TopicRouteDataPtr&)>& cb) {
   std::string name_server = name_server_resolver_->resolve();
   if (name_server.empty()) {
     SPDLOG_WARN("No name server available");
+    std::error_code ec = ErrorCode::ServiceUnavailable;
+    cb(ec, nullptr);
     return;
   }
 
@@ -225,7 +320,7 @@ void ClientImpl::fetchRouteFor(const std::string& topic,
   request.mutable_topic()->set_name(topic);
   auto endpoints = request.mutable_endpoints();
   setAccessPoint(endpoints);
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
   client_manager_->resolveRoute(name_server, metadata, request, absl::ToChronoMilliseconds(io_timeout_), callback);
 }
@@ -237,19 +332,26 @@ void ClientImpl::updateRouteInfo() {
     return;
   }
 
-  std::vector<std::string> topics;
+  std::vector<std::pair<std::string, RouteKey>> subscriptions;
   {
-    absl::MutexLock lock(&topic_route_table_mtx_);
-    for (const auto& entry : topic_route_table_) {
-      topics.push_back(entry.first);
+    absl::MutexLock lk(&route_subscriptions_mtx_);
+    for (const auto& item : route_subscriptions_) {
+      subscriptions.emplace_back(item.first, item.second.key);
     }
   }
 
-  if (!topics.empty()) {
-    for (const auto& topic : topics) {
-      fetchRouteFor(
-          topic, std::bind(&ClientImpl::updateRouteCache, this, topic, std::placeholders::_1, std::placeholders::_2));
+  // Clients sharing the cache refresh the same routes; whichever comes first queries on behalf of all.
+  for (const auto& subscription : subscriptions) {
+    const std::string& topic = subscription.first;
+    RouteKey key = routeKeyOf(topic);
+    if (key.access_point.empty()) {
+      // Keep serving the route cached under the last known access point until name servers resolve again.
+      key = subscription.second;
+    } else if (key != subscription.second) {
+      resubscribeRoute(topic, subscription.second, key);
     }
+    RouteCache::instance().refresh(key, std::bind(&ClientImpl::fetchRouteFor, this, topic, std::placeholders::_1),
+                                   ROUTE_MAX_AGE, io_timeout_);
   }
   SPDLOG_DEBUG("Topic route info updated");
 }
@@ -261,11 +363,14 @@ void ClientImpl::heartbeat() {
     SPDLOG_WARN("No hosts to send heartbeat to at present");
     return;
   }
+  heartbeat(hosts);
+}
 
+void ClientImpl::heartbeat(const absl::flat_hash_set<std::string>& hosts) {
   HeartbeatRequest request;
   prepareHeartbeatData(request);
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
 
   for (const auto& target : hosts) {
@@ -280,30 +385,6 @@ void ClientImpl::heartbeat() {
   }
 }
 
-void ClientImpl::onTopicRouteReady(const std::string& topic, const std::error_code& ec,
-                                   const TopicRouteDataPtr& route) {
-  if (route) {
-    SPDLOG_DEBUG("Received route data for topic={}", topic);
-  }
-
-  updateRouteCache(topic, ec, route);
-
-  // Take all pending callbacks
-  std::vector<std::function<void(const std::error_code&, const TopicRouteDataPtr&)>> pending_requests;
-  {
-    absl::MutexLock lk(&inflight_route_requests_mtx_);
-    assert(inflight_route_requests_.contains(topic));
-    auto& inflight_requests = inflight_route_requests_.at(topic);
-    pending_requests.insert(pending_requests.end(), inflight_requests.begin(), inflight_requests.end());
-    inflight_route_requests_.erase(topic);
-  }
-
-  SPDLOG_DEBUG("Apply cached callbacks with acquired route data for topic={}", topic);
-  for (const auto& cb : pending_requests) {
-    cb(ec, route);
-  }
-}
-
 void ClientImpl::updateTraceHosts() {
   absl::flat_hash_set<std::string> hosts;
   absl::MutexLock lk(&topic_route_table_mtx_);
@@ -376,7 +457,7 @@ void ClientImpl::updateRouteCache(const std::string& topic, const std::error_cod
 
 void ClientImpl::pollCommand(const std::string& target) {
   SPDLOG_INFO("Start to poll command to remote, target={}", target);
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
 
   PollCommandRequest request;
@@ -451,7 +532,7 @@ void ClientImpl::onPollCommandResponse(const InvocationContext<PollCommandRespon
 
   switch (ctx->response.type_case()) {
     case PollCommandResponse::TypeCase::kPrintThreadStackTraceCommand: {
-      absl::flat_hash_map<std::string, std::string> metadata;
+      Metadata metadata;
       Signature::sign(this, metadata);
       ReportThreadStackTraceRequest request;
       auto command_id = ctx->response.print_thread_stack_trace_command().command_id();
@@ -487,9 +568,8 @@ void ClientImpl::onPollCommandResponse(const InvocationContext<PollCommandRespon
       if (client_manager_->wrapMessage(orphan, message)) {
         MessageAccessor::setTargetEndpoint(message, ctx->remote_address);
         const std::string& transaction_id = ctx->response.recover_orphaned_transaction_command().transaction_id();
-        // Dispatch task to thread-pool.
-        client_manager_->submit(
-            std::bind(&ClientImpl::resolveOrphanedTransactionalMessage, this, transaction_id, message));
+        // Producer queues the check onto its own executor, so there is no need to hop threads here.
+        resolveOrphanedTransactionalMessage(transaction_id, message);
       } else {
         SPDLOG_WARN("Failed to resolve orphaned transactional message, potentially caused by message-body checksum "
                     "verification failure.");
@@ -528,11 +608,32 @@ void ClientImpl::healthCheck() {
   std::vector<std::string> endpoints;
   {
     absl::MutexLock lk(&isolated_endpoints_mtx_);
-    for (const auto& item : isolated_endpoints_) {
-      endpoints.push_back(item);
+    for (auto it = isolated_endpoints_.begin(); it != isolated_endpoints_.end();) {
+      switch (client_manager_->endpointHealth(*it)) {
+        case EndpointHealth::Healthy: {
+          SPDLOG_INFO("Endpoint[{}] is observed healthy. Remove it from isolated endpoint pool", *it);
+          isolated_endpoints_.erase(it++);
+          break;
+        }
+        case EndpointHealth::Unhealthy: {
+          // Connectivity-state watch of its channel will report once it recovers.
+          it++;
+          break;
+        }
+        case EndpointHealth::Unknown: {
+          // Channel is idle; fall back to an active probe.
+          endpoints.push_back(*it);
+          it++;
+          break;
+        }
+      }
     }
   }
 
+  if (endpoints.empty()) {
+    return;
+  }
+
   std::weak_ptr<ClientImpl> base(self());
   auto callback = [base](const std::error_code& ec, const InvocationContext<HealthCheckResponse>* invocation_context) {
     std::shared_ptr<ClientImpl> ptr = base.lock();
@@ -546,12 +647,19 @@ void ClientImpl::healthCheck() {
 
   for (const auto& endpoint : endpoints) {
     HealthCheckRequest request;
-    absl::flat_hash_map<std::string, std::string> metadata;
+    Metadata metadata;
     Signature::sign(this, metadata);
     client_manager_->healthCheck(endpoint, metadata, request, absl::ToChronoMilliseconds(io_timeout_), callback);
   }
 }
 
+void ClientImpl::onEndpointRecovery(const std::string& endpoint) {
+  absl::MutexLock lk(&isolated_endpoints_mtx_);
+  if (isolated_endpoints_.erase(endpoint)) {
+    SPDLOG_INFO("Endpoint[{}] recovered. Remove it from isolated endpoint pool", endpoint);
+  }
+}
+
 void ClientImpl::schedule(const std::string& task_name, const std::function<void()>& task,
                           std::chrono::milliseconds delay) {
   client_manager_->getScheduler()->schedule(task, task_name, delay, std::chrono::milliseconds(0));
@@ -16,10 +16,13 @@
  */
 #include "ConsumeMessageServiceImpl.h"
 
+#include <algorithm>
+
 #include "BroadcastTask.h"
 #include "ConsumeTask.h"
 #include "PushConsumerImpl.h"
 #include "ThreadPoolImpl.h"
+#include "fmt/format.h"
 #include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQMessageExt.h"
 #include "rocketmq/MessageListener.h"
@@ -29,26 +32,55 @@
 
 ROCKETMQ_NAMESPACE_BEGIN
 
+const std::uint32_t ConsumeMessageServiceImpl::STATS_INTERVAL_TICKS = 10;
+
+const char* ConsumeMessageServiceImpl::CONSUME_RETRY_TASK_NAME = "consume-retry-task";
+
 ConsumeMessageServiceImpl::ConsumeMessageServiceImpl(std::weak_ptr<PushConsumer> consumer, int thread_count,
                                                      MessageListener* message_listener)
-    : state_(State::CREATED), thread_count_(thread_count), pool_(absl::make_unique<ThreadPoolImpl>(thread_count_)),
-      consumer_(std::move(consumer)), message_listener_(message_listener) {
+    : ConsumeMessageServiceImpl(std::move(consumer), thread_count, thread_count, message_listener) {
+}
+
+ConsumeMessageServiceImpl::ConsumeMessageServiceImpl(std::weak_ptr<PushConsumer> consumer, int thread_count,
+                                                     int max_thread_count, MessageListener* message_listener)
+    : state_(State::CREATED), thread_count_(thread_count),
+      pool_(absl::make_unique<ThreadPoolImpl>(thread_count_, std::max(thread_count_, max_thread_count))),
+      pool_scaler_(absl::make_unique<ThreadPoolScaler>(*pool_)), consumer_(std::move(consumer)),
+      message_listener_(message_listener), invoker_(message_listener) {
+  pool_->placement(ThreadRole::Consume, "rmq-consume");
 }
 
 void ConsumeMessageServiceImpl::start() {
   State expected = State::CREATED;
   if (state_.compare_exchange_strong(expected, State::STARTING, std::memory_order_relaxed)) {
     pool_->start();
+    state_.store(State::STARTED, std::memory_order_relaxed);
   }
 }
 
 void ConsumeMessageServiceImpl::shutdown() {
-  State expected = State::STOPPING;
-  if (state_.compare_exchange_strong(expected, State::STOPPED, std::memory_order_relaxed)) {
+  State expected = State::STARTED;
+  if (state_.compare_exchange_strong(expected, State::STOPPING, std::memory_order_relaxed)) {
     pool_->shutdown();
+    state_.store(State::STOPPED, std::memory_order_relaxed);
   }
 }
 
+void ConsumeMessageServiceImpl::drain() {
+  bool expected = false;
+  if (draining_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+    SPDLOG_INFO("ConsumeMessageService starts to drain. Unconsumed messages will be released back to broker");
+  }
+}
+
+void ConsumeMessageServiceImpl::release(const std::vector<MQMessageExt>& messages) {
+  auto consumer = consumer_.lock();
+  if (!consumer) {
+    return;
+  }
+  consumer->release(messages);
+}
+
 void ConsumeMessageServiceImpl::dispatch(std::shared_ptr<ProcessQueue> process_queue,
                                          std::vector<MQMessageExt> messages) {
   auto consumer = consumer_.lock();
@@ -56,39 +88,86 @@ void ConsumeMessageServiceImpl::dispatch(std::shared_ptr<ProcessQueue> process_q
     return;
   }
 
+  auto message_model = consumer->messageModel();
+
+  if (MessageModel::CLUSTERING == message_model && draining()) {
+    consumer->release(messages);
+    return;
+  }
+
+  if (MessageModel::CLUSTERING == message_model && duplicate_filter_) {
+    deduplicate(*consumer, messages);
+    if (messages.empty()) {
+      return;
+    }
+  }
+
   process_queue->accountCache(messages);
 
-  auto message_model = consumer->messageModel();
+  if (MessageModel::CLUSTERING == message_model) {
+    consumer->trackInflight(messages);
+  }
 
-  if (MessageListenerType::FIFO == message_listener_->listenerType()) {
-    switch (message_model) {
-      case MessageModel::BROADCASTING: {
-        process_queue->enqueueBroadcastMessages(std::move(messages));
+  auto self = shared_from_this();
 
-        if (!process_queue->broadcastTask()) {
-          auto task = std::make_shared<BroadcastTask>(process_queue, shared_from_this());
-          process_queue->broadcastTask(task);
-        }
+  switch (message_model) {
+    case MessageModel::BROADCASTING: {
+      process_queue->enqueueBroadcastMessages(std::move(messages));
 
-        auto consume_task = process_queue->broadcastTask();
-        if (!consume_task->runnable()) {
-          pool_->submit([consume_task]() { consume_task->process(); });
-        }
-        break;
+      if (!process_queue->broadcastTask()) {
+        auto task = std::make_shared<BroadcastTask>(process_queue, self, invoker_);
+        process_queue->broadcastTask(task);
       }
-      case MessageModel::CLUSTERING: {
-        auto consume_task = std::make_shared<ConsumeTask>(shared_from_this(), process_queue, std::move(messages));
+
+      auto consume_task = process_queue->broadcastTask();
+      if (!consume_task->runnable()) {
+        pool_->submit([consume_task]() { consume_task->process(); });
+      }
+      break;
+    }
+
+    case MessageModel::CLUSTERING: {
+      if (invoker_.fifo()) {
+        auto consume_task = std::make_shared<ConsumeTask>(self, process_queue, std::move(messages), invoker_);
         pool_->submit([consume_task]() { consume_task->process(); });
         break;
       }
+
+      for (auto& message : messages) {
+        auto consume_task = std::make_shared<ConsumeTask>(self, process_queue, std::move(message), invoker_);
+        pool_->submit([consume_task]() { consume_task->process(); });
+      }
+      break;
     }
-    return;
   }
+}
+
+void ConsumeMessageServiceImpl::deduplicate(PushConsumer& consumer, std::vector<MQMessageExt>& messages) {
+  std::vector<MQMessageExt> unique;
+  unique.reserve(messages.size());
+  for (auto& message : messages) {
+    if (!duplicate_filter_->seen(message.getMsgId())) {
+      unique.emplace_back(std::move(message));
+      continue;
+    }
 
-  for (const auto& message : messages) {
-    auto consume_task = std::make_shared<ConsumeTask>(shared_from_this(), process_queue, message);
-    pool_->submit([consume_task]() { consume_task->process(); });
+    if (DuplicateAction::FLAG == duplicate_action_) {
+      message.setProperty(DUPLICATE_PROPERTY_KEY, "true");
+      unique.emplace_back(std::move(message));
+      continue;
+    }
+
+    // It has been consumed already. Acknowledge the redelivery such that broker stops delivering it.
+    SPDLOG_DEBUG("Drop duplicate message[message-id={}, delivery-attempt={}]", message.getMsgId(),
+                 message.getDeliveryAttempt());
+    std::string message_id = message.getMsgId();
+    consumer.ack(message, [message_id](const std::error_code& ec) {
+      if (ec) {
+        SPDLOG_WARN("Failed to ack duplicate message[message-id={}]. Cause: {}", message_id, ec.message());
+      }
+    });
   }
+  messages.swap(unique);
 }
 
 void ConsumeMessageServiceImpl::submit(std::shared_ptr<ConsumeTask> task) {
@@ -134,6 +213,7 @@ void ConsumeMessageServiceImpl::nack(const MQMessageExt& message, std::function<
   if (!consumer) {
     return;
   }
+  broker_retry_count_.fetch_add(1, std::memory_order_relaxed);
   consumer->nack(message, cb);
 }
 
@@ -146,6 +226,41 @@ void ConsumeMessageServiceImpl::forward(const MQMessageExt& message, std::functi
 }
 
 void ConsumeMessageServiceImpl::schedule(std::shared_ptr<ConsumeTask> task, std::chrono::milliseconds delay) {
+  auto consumer = consumer_.lock();
+  if (!consumer) {
+    return;
+  }
+
+  std::weak_ptr<ConsumeMessageServiceImpl> service(shared_from_this());
+  auto functor = [service, task]() {
+    auto svc = service.lock();
+    if (svc) {
+      svc->submit(task);
+    }
+  };
+  consumer->schedule(CONSUME_RETRY_TASK_NAME, functor, delay);
+}
+
+bool ConsumeMessageServiceImpl::retryLocally(const MQMessageExt& message, std::uint32_t attempted,
+                                             std::chrono::milliseconds& delay) {
+  if (!retry_policy_.enabled()) {
+    return false;
+  }
+
+  auto consumer = consumer_.lock();
+  if (!consumer) {
+    return false;
+  }
+
+  // Invisible duration of in-flight messages is renewed in the background, which extends the budget for local retry.
+  auto remaining = absl::ToChronoMilliseconds(consumer->invisibleDeadline(message) - absl::Now());
+
+  if (!retry_policy_.retryLocally(attempted, remaining, delay)) {
+    return false;
+  }
+
+  local_retry_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
 }
 
 std::size_t ConsumeMessageServiceImpl::maxDeliveryAttempt() {
@@ -162,11 +277,52 @@ std::weak_ptr<PushConsumer> ConsumeMessageServiceImpl::consumer() {
   return consumer_;
 }
 
+void ConsumeMessageServiceImpl::adjustThreadPool() {
+  State state = state_.load(std::memory_order_relaxed);
+  if (State::STARTING != state && State::STARTED != state) {
+    return;
+  }
+
+  pool_scaler_->tick();
+
+  // Emit stats of the consume thread pool every STATS_INTERVAL_TICKS ticks.
+  if (++pool_scaler_ticks_ % STATS_INTERVAL_TICKS == 0) {
+    std::string stats;
+    pool_scaler_->reportAndReset(stats);
+    SPDLOG_INFO("Consume {}", stats);
+  }
+}
+
+void ConsumeMessageServiceImpl::reportAndReset(std::string& stats) {
+  std::uint64_t local_retries = local_retry_count_.exchange(0, std::memory_order_relaxed);
+  std::uint64_t broker_retries = broker_retry_count_.exchange(0, std::memory_order_relaxed);
+  stats = fmt::format("Consume retry: local-retries={}, broker-retries={}", local_retries, broker_retries);
+  if (duplicate_filter_) {
+    std::string deduplication_stats;
+    duplicate_filter_->reportAndReset(deduplication_stats);
+    stats += "; " + deduplication_stats;
+  }
+}
+
+void ConsumeMessageServiceImpl::deduplication(std::chrono::milliseconds window, std::size_t capacity,
+                                              DuplicateAction action) {
+  if (window.count() <= 0 || !capacity) {
+    duplicate_filter_.reset();
+    return;
+  }
+  duplicate_filter_ = absl::make_unique<DuplicateFilter>(absl::FromChrono(window), capacity);
+  duplicate_action_ = action;
+}
+
 bool ConsumeMessageServiceImpl::preHandle(const MQMessageExt& message) {
   return true;
 }
 
 bool ConsumeMessageServiceImpl::postHandle(const MQMessageExt& message, ConsumeMessageResult result) {
+  if (duplicate_filter_ && ConsumeMessageResult::SUCCESS == result) {
+    // Only successfully consumed messages count, or redeliveries following a failure would be suppressed.
+    duplicate_filter_->record(message.getMsgId());
+  }
   return true;
 }
 
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ConsumeRetryPolicy.h"
+
+#include <algorithm>
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+std::chrono::milliseconds ConsumeRetryPolicy::backoff(std::uint32_t attempt) const {
+  if (!attempt) {
+    return std::chrono::milliseconds(0);
+  }
+
+  double delay = static_cast<double>(initial_backoff.count());
+  for (std::uint32_t i = 1; i < attempt && delay < max_backoff.count(); i++) {
+    delay *= backoff_multiplier;
+  }
+  auto result = std::chrono::milliseconds(static_cast<std::int64_t>(delay));
+  return std::min(result, max_backoff);
+}
+
+bool ConsumeRetryPolicy::retryLocally(std::uint32_t attempted, std::chrono::milliseconds remaining,
+                                      std::chrono::milliseconds& delay) const {
+  if (attempted >= max_local_attempts) {
+    return false;
+  }
+
+  delay = backoff(attempted + 1);
+
+  // The retry, including its backoff, must complete in the invisible window, leaving enough room to nack.
+  return delay + reserved_window < remaining;
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -17,27 +17,29 @@
 
 #include "ConsumeTask.h"
 
+#include <cassert>
+#include <cstddef>
+
 #include "MessageAccessor.h"
-#include "PushConsumer.h"
 #include "rocketmq/ErrorCode.h"
 #include "rocketmq/Logger.h"
 #include "rocketmq/MQMessageExt.h"
-#include "rocketmq/MessageListener.h"
-#include "rocketmq/MessageModel.h"
 #include "spdlog/spdlog.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
 
 ConsumeTask::ConsumeTask(ConsumeMessageServiceWeakPtr service, std::weak_ptr<ProcessQueue> process_queue,
-                         MQMessageExt message)
-    : service_(std::move(service)), process_queue_(std::move(process_queue)) {
+                         MQMessageExt message, ConsumeInvoker invoker)
+    : service_(std::move(service)), process_queue_(std::move(process_queue)), invoker_(invoker),
+      fifo_(invoker.fifo()) {
   messages_.emplace_back(std::move(message));
 }
 
 ConsumeTask::ConsumeTask(ConsumeMessageServiceWeakPtr service, std::weak_ptr<ProcessQueue> process_queue,
-                         std::vector<MQMessageExt> messages)
-    : service_(std::move(service)), process_queue_(std::move(process_queue)), messages_(std::move(messages)) {
-  fifo_ = messages_.size() > 1;
+                         std::vector<MQMessageExt> messages, ConsumeInvoker invoker)
+    : service_(std::move(service)), process_queue_(std::move(process_queue)), messages_(std::move(messages)),
+      invoker_(invoker), fifo_(invoker.fifo()) {
+  assert(fifo_ || messages_.size() <= 1);
 }
 
 void ConsumeTask::pop() {
@@ -50,6 +52,7 @@ void ConsumeTask::pop() {
   process_queue->release(messages_[0].getBody().size());
 
   messages_.erase(messages_.begin());
+  local_attempts_ = 0;
 }
 
 void ConsumeTask::submit() {
@@ -134,19 +137,24 @@ void ConsumeTask::process() {
     return;
   }
 
-  std::shared_ptr<PushConsumer> consumer = svc->consumer().lock();
-
-  auto message_model = consumer->messageModel();
-  if (MessageModel::BROADCASTING == message_model) {
-
-    return;
-  }
-
   auto self = shared_from_this();
 
   switch (next_step_) {
     case NextStep::Consume: {
-      const auto& listener = svc->listener();
+      if (svc->draining()) {
+        // Hand unconsumed messages back to broker rather than waiting for their invisible duration to elapse.
+        SPDLOG_DEBUG("Release {} unconsumed messages as consumer is draining", messages_.size());
+        svc->release(messages_);
+        auto process_queue = process_queue_.lock();
+        if (process_queue) {
+          for (const auto& message : messages_) {
+            process_queue->release(message.getBody().size());
+          }
+        }
+        messages_.clear();
+        break;
+      }
+
       auto it = messages_.begin();
       SPDLOG_DEBUG("Start to process message[message-id={}]", it->getMsgId());
       svc->preHandle(*it);
@@ -154,15 +162,13 @@ void ConsumeTask::process() {
       std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
       // Invoke user-defined-callback
-      ConsumeMessageResult result;
-      if (MessageListenerType::FIFO == listener->listenerType()) {
-        auto fifo_message_listener = dynamic_cast<FifoMessageListener*>(listener);
-        result = fifo_message_listener->consumeMessage(*it);
-      } else {
-        auto standard_message_listener = dynamic_cast<StandardMessageListener*>(listener);
-        result = standard_message_listener->consumeMessage({*it});
+      ConsumeMessageResult result = invoker_(messages_);
+      // Record every message the listener was handed: the whole batch for standard listeners, its head for FIFO ones,
+      // whose remaining messages are yet to be consumed.
+      std::size_t handed = fifo_ ? 1 : messages_.size();
+      for (std::size_t i = 0; i < handed; i++) {
+        svc->postHandle(messages_[i], result);
       }
-      svc->postHandle(*it, result);
 
       switch (result) {
         case ConsumeMessageResult::SUCCESS: {
@@ -177,6 +183,17 @@ void ConsumeTask::process() {
             MessageAccessor::setDeliveryAttempt(*it, it->getDeliveryAttempt() + 1);
             schedule();
           } else {
+            std::chrono::milliseconds delay(0);
+            if (svc->retryLocally(*it, local_attempts_, delay)) {
+              // Consume again locally after backoff, saving a round-trip to broker for transient failures.
+              local_attempts_++;
+              next_step_ = NextStep::Consume;
+              SPDLOG_DEBUG("Retry message[message-id={}] locally in {}ms, local-attempt={}", it->getMsgId(),
+                           delay.count(), local_attempts_);
+              svc->schedule(self, delay);
+              break;
+            }
+
             // For standard way of processing, Nack to server.
             auto callback = std::bind(&ConsumeTask::onNack, self, std::placeholders::_1);
             svc->nack(*it, callback);
@@ -192,10 +192,27 @@ void DefaultMQProducer::sendOneway(MQMessage& message, MessageQueueSelector* sel
   impl_->sendOneway(message, ec);
 }
 
+void DefaultMQProducer::sendDelayed(const MQMessage& message, std::chrono::milliseconds delay,
+                                    SendCallback* send_callback) {
+  impl_->sendDelayed(message, delay, send_callback);
+}
+
+bool DefaultMQProducer::cancelDelayed(const std::string& message_id) {
+  return impl_->cancelDelayed(message_id);
+}
+
 void DefaultMQProducer::setLocalTransactionStateChecker(LocalTransactionStateCheckerPtr checker) {
   impl_->setLocalTransactionStateChecker(std::move(checker));
 }
 
+void DefaultMQProducer::setTransactionCheckExecutor(uint16_t thread_count, std::size_t capacity) {
+  impl_->transactionCheckExecutor(thread_count, capacity);
+}
+
+void DefaultMQProducer::setDelayedSendMemoryBudget(uint64_t memory_budget) {
+  impl_->delayedSend(memory_budget);
+}
+
 void DefaultMQProducer::setMaxAttemptTimes(int max_attempt_times) {
   impl_->maxAttemptTimes(max_attempt_times);
 }
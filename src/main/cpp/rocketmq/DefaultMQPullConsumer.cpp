@@ -57,6 +57,15 @@ void DefaultMQPullConsumer::pull(const PullMessageQuery& query, PullCallback* ca
   impl_->pull(query, callback);
 }
 
+void DefaultMQPullConsumer::subscribe(const std::string& topic, const std::string& expression,
+                                      ExpressionType expression_type) {
+  impl_->subscribe(topic, expression, expression_type);
+}
+
+std::vector<QueueLag> DefaultMQPullConsumer::queueLags() const {
+  return impl_->queueLags();
+}
+
 void DefaultMQPullConsumer::setResourceNamespace(const std::string& resource_namespace) {
   impl_->resourceNamespace(resource_namespace);
 }
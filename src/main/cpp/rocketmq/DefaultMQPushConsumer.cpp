@@ -32,6 +32,10 @@ void DefaultMQPushConsumer::start() {
   impl_->start();
 }
 
+std::future<void> DefaultMQPushConsumer::startAsync() {
+  return impl_->startAsync();
+}
+
 void DefaultMQPushConsumer::shutdown() {
   impl_->shutdown();
   SPDLOG_DEBUG("PushConsumerImpl shared_ptr use_count={}", impl_.use_count());
@@ -72,6 +76,53 @@ void DefaultMQPushConsumer::setConsumeThreadCount(int thread_count) {
   impl_->consumeThreadPoolSize(thread_count);
 }
 
+void DefaultMQPushConsumer::setMaxConsumeThreadCount(int max_thread_count) {
+  impl_->maxConsumeThreadPoolSize(max_thread_count);
+}
+
+void DefaultMQPushConsumer::setLocalRetry(int max_local_attempts, std::chrono::milliseconds initial_backoff) {
+  if (max_local_attempts >= 0) {
+    impl_->consumeRetryPolicy(max_local_attempts, initial_backoff);
+  }
+}
+
+void DefaultMQPushConsumer::setDeduplication(std::chrono::milliseconds window, std::size_t capacity,
+                                             DuplicateAction action) {
+  impl_->deduplication(window, capacity, action);
+}
+
+void DefaultMQPushConsumer::setInvisibleDuration(std::chrono::milliseconds invisible_duration) {
+  impl_->invisibleDuration(invisible_duration);
+}
+
+void DefaultMQPushConsumer::setDrainTimeout(std::chrono::milliseconds drain_timeout) {
+  impl_->drainTimeout(drain_timeout);
+}
+
+void DefaultMQPushConsumer::setStartupTimeout(std::chrono::milliseconds startup_timeout) {
+  impl_->startupTimeout(startup_timeout);
+}
+
+void DefaultMQPushConsumer::pause(const std::string& topic) {
+  impl_->pause(topic);
+}
+
+void DefaultMQPushConsumer::pause(const MQMessageQueue& message_queue) {
+  impl_->pause(message_queue);
+}
+
+void DefaultMQPushConsumer::resume(const std::string& topic) {
+  impl_->resume(topic);
+}
+
+void DefaultMQPushConsumer::resume(const MQMessageQueue& message_queue) {
+  impl_->resume(message_queue);
+}
+
+std::vector<QueueLag> DefaultMQPushConsumer::queueLags() const {
+  return impl_->queueLags();
+}
+
 void DefaultMQPushConsumer::setInstanceName(const std::string& instance_name) {
   impl_->setInstanceName(instance_name);
 }
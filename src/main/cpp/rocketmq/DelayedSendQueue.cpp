@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DelayedSendQueue.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "rocketmq/ErrorCode.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+DelayedSendQueue::DelayedSendQueue(Dispatcher dispatcher, std::uint64_t memory_budget,
+                                   std::chrono::milliseconds tick_duration, std::size_t wheel_size, Clock clock)
+    : dispatcher_(std::move(dispatcher)), memory_budget_(memory_budget),
+      tick_duration_(std::max(tick_duration, std::chrono::milliseconds(1))), clock_(std::move(clock)),
+      epoch_(clock_()), wheel_(std::max<std::size_t>(1, wheel_size)), lateness_histogram_("Lateness", 11) {
+  lateness_histogram_.labels().emplace_back("[000ms~010ms): ");
+  lateness_histogram_.labels().emplace_back("[010ms~020ms): ");
+  lateness_histogram_.labels().emplace_back("[020ms~030ms): ");
+  lateness_histogram_.labels().emplace_back("[030ms~040ms): ");
+  lateness_histogram_.labels().emplace_back("[040ms~050ms): ");
+  lateness_histogram_.labels().emplace_back("[050ms~060ms): ");
+  lateness_histogram_.labels().emplace_back("[060ms~070ms): ");
+  lateness_histogram_.labels().emplace_back("[070ms~080ms): ");
+  lateness_histogram_.labels().emplace_back("[080ms~090ms): ");
+  lateness_histogram_.labels().emplace_back("[090ms~100ms): ");
+  lateness_histogram_.labels().emplace_back("[100ms~inf): ");
+}
+
+std::uint64_t DelayedSendQueue::tickOf(std::chrono::steady_clock::time_point time_point) const {
+  if (time_point <= epoch_) {
+    return 0;
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(time_point - epoch_).count() / tick_duration_.count();
+}
+
+bool DelayedSendQueue::schedule(const MQMessage& message, std::chrono::milliseconds delay, SendCallback* callback,
+                                std::error_code& ec) {
+  auto now = clock_();
+  auto due = now + delay;
+  if (delay.count() <= 0) {
+    std::vector<Entry> entries{Entry{message, callback, due, 0}};
+    dispatch(entries, now);
+    return true;
+  }
+
+  {
+    absl::MutexLock lk(&mtx_);
+    if (index_.contains(message.getMsgId())) {
+      ec = ErrorCode::BadRequest;
+    } else if (memory_in_use_ + message.bodyLength() > memory_budget_) {
+      ec = ErrorCode::TooManyRequest;
+    } else {
+      // Round deadline up to a tick boundary such that a message is never handed over before it is due.
+      std::uint64_t deadline_tick = tickOf(due);
+      if (epoch_ + deadline_tick * tick_duration_ < due) {
+        deadline_tick++;
+      }
+      deadline_tick = std::max(deadline_tick, current_tick_ + 1);
+      std::size_t slot = deadline_tick % wheel_.size();
+      auto it = wheel_[slot].insert(wheel_[slot].end(), Entry{message, callback, due, deadline_tick});
+      index_.insert({message.getMsgId(), std::make_pair(slot, it)});
+      memory_in_use_ += message.bodyLength();
+      return true;
+    }
+  }
+
+  rejected_.fetch_add(1, std::memory_order_relaxed);
+  SPDLOG_WARN("Reject delayed sending of message[msg-id={}, topic={}, delay={}ms]. Cause: {}", message.getMsgId(),
+              message.getTopic(), delay.count(), ec.message());
+  return false;
+}
+
+bool DelayedSendQueue::cancel(const std::string& message_id) {
+  SendCallback* callback;
+  {
+    absl::MutexLock lk(&mtx_);
+    auto search = index_.find(message_id);
+    if (index_.end() == search) {
+      return false;
+    }
+    Slot& slot = wheel_[search->second.first];
+    callback = search->second.second->callback;
+    memory_in_use_ -= search->second.second->message.bodyLength();
+    slot.erase(search->second.second);
+    index_.erase(search);
+  }
+
+  cancelled_.fetch_add(1, std::memory_order_relaxed);
+  SPDLOG_DEBUG("Delayed sending of message[msg-id={}] is cancelled", message_id);
+  if (callback) {
+    callback->onFailure(std::make_error_code(std::errc::operation_canceled));
+  }
+  return true;
+}
+
+void DelayedSendQueue::advance() {
+  auto now = clock_();
+  std::uint64_t now_tick = tickOf(now);
+  std::vector<Entry> due;
+  {
+    absl::MutexLock lk(&mtx_);
+    if (now_tick <= current_tick_) {
+      return;
+    }
+
+    if (now_tick - current_tick_ >= wheel_.size()) {
+      // Fell behind by a revolution or more: every slot may hold messages that are due.
+      for (std::size_t slot = 0; slot < wheel_.size(); slot++) {
+        collect(wheel_[slot], now_tick, due);
+      }
+    } else {
+      for (std::uint64_t tick = current_tick_ + 1; tick <= now_tick; tick++) {
+        collect(wheel_[tick % wheel_.size()], now_tick, due);
+      }
+    }
+    current_tick_ = now_tick;
+  }
+
+  if (due.empty()) {
+    return;
+  }
+  std::sort(due.begin(), due.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.due < rhs.due; });
+  dispatch(due, now);
+}
+
+void DelayedSendQueue::collect(Slot& slot, std::uint64_t tick, std::vector<Entry>& due) {
+  for (auto it = slot.begin(); it != slot.end();) {
+    // Messages of later revolutions stay in the slot.
+    if (it->deadline_tick > tick) {
+      it++;
+      continue;
+    }
+    index_.erase(it->message.getMsgId());
+    memory_in_use_ -= it->message.bodyLength();
+    due.push_back(std::move(*it));
+    it = slot.erase(it);
+  }
+}
+
+void DelayedSendQueue::dispatch(std::vector<Entry>& due, std::chrono::steady_clock::time_point now) {
+  for (auto& entry : due) {
+    std::int64_t lateness = 0;
+    if (now > entry.due) {
+      lateness = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.due).count();
+    }
+    lateness_histogram_.countIn(static_cast<int>(std::min<std::int64_t>(lateness / 10, 10)));
+    std::int64_t max_lateness = max_lateness_.load(std::memory_order_relaxed);
+    while (lateness > max_lateness &&
+           !max_lateness_.compare_exchange_weak(max_lateness, lateness, std::memory_order_relaxed)) {
+    }
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    dispatcher_(entry.message, entry.callback);
+  }
+}
+
+void DelayedSendQueue::clear(const std::error_code& ec) {
+  std::vector<Entry> dropped;
+  {
+    absl::MutexLock lk(&mtx_);
+    for (auto& slot : wheel_) {
+      for (auto& entry : slot) {
+        dropped.push_back(std::move(entry));
+      }
+      slot.clear();
+    }
+    index_.clear();
+    memory_in_use_ = 0;
+  }
+
+  if (!dropped.empty()) {
+    SPDLOG_WARN("Drop {} messages that are yet to be sent. Cause: {}", dropped.size(), ec.message());
+  }
+  for (auto& entry : dropped) {
+    if (entry.callback) {
+      entry.callback->onFailure(ec);
+    }
+  }
+}
+
+std::size_t DelayedSendQueue::size() const {
+  absl::MutexLock lk(&mtx_);
+  return index_.size();
+}
+
+std::uint64_t DelayedSendQueue::memoryInUse() const {
+  absl::MutexLock lk(&mtx_);
+  return memory_in_use_;
+}
+
+void DelayedSendQueue::reportAndReset(std::string& stats) {
+  std::string lateness;
+  lateness_histogram_.reportAndReset(lateness);
+  std::size_t held;
+  std::uint64_t memory_in_use;
+  {
+    absl::MutexLock lk(&mtx_);
+    held = index_.size();
+    memory_in_use = memory_in_use_;
+  }
+  stats = fmt::format("DelayedSend: held={}, memory={}/{}, sent={}, cancelled={}, rejected={}, max-lateness={}ms, {}",
+                      held, memory_in_use, memory_budget_, sent_.exchange(0, std::memory_order_relaxed),
+                      cancelled_.exchange(0, std::memory_order_relaxed),
+                      rejected_.exchange(0, std::memory_order_relaxed),
+                      max_lateness_.exchange(0, std::memory_order_relaxed), lateness);
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DuplicateFilter.h"
+
+#include <algorithm>
+
+#include "absl/hash/hash.h"
+#include "fmt/format.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+DuplicateFilter::DuplicateFilter(absl::Duration window, std::size_t capacity)
+    : half_window_(window / 2), generation_capacity_(std::max<std::size_t>(capacity / 2, 1)),
+      current_since_(absl::Now()) {
+}
+
+bool DuplicateFilter::seen(const std::string& message_id, absl::Time now) {
+  std::uint64_t key = fingerprint(message_id);
+  bool hit;
+  {
+    absl::MutexLock lk(&mtx_);
+    rotate(now);
+    hit = current_.contains(key) || previous_.contains(key);
+  }
+
+  lookups_.fetch_add(1, std::memory_order_relaxed);
+  if (hit) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return hit;
+}
+
+void DuplicateFilter::record(const std::string& message_id, absl::Time now) {
+  std::uint64_t key = fingerprint(message_id);
+  absl::MutexLock lk(&mtx_);
+  rotate(now);
+  if (current_.size() >= generation_capacity_) {
+    previous_.swap(current_);
+    current_.clear();
+    current_since_ = now;
+  }
+  current_.insert(key);
+}
+
+std::size_t DuplicateFilter::size() const {
+  absl::MutexLock lk(&mtx_);
+  return current_.size() + previous_.size();
+}
+
+void DuplicateFilter::reportAndReset(std::string& stats) {
+  std::uint64_t lookups = lookups_.exchange(0, std::memory_order_relaxed);
+  std::uint64_t hits = hits_.exchange(0, std::memory_order_relaxed);
+  double hit_rate = lookups ? 100.0 * hits / lookups : 0;
+  stats = fmt::format("Deduplication: lookups={}, hits={}, hit-rate={:.2f}%, fingerprints={}", lookups, hits, hit_rate,
+                      size());
+}
+
+void DuplicateFilter::rotate(absl::Time now) {
+  absl::Duration age = now - current_since_;
+  if (age < half_window_) {
+    return;
+  }
+
+  if (age >= 2 * half_window_) {
+    // Idle for a whole window: both generations are outdated.
+    previous_.clear();
+  } else {
+    previous_.swap(current_);
+  }
+  current_.clear();
+  current_since_ = now;
+}
+
+std::uint64_t DuplicateFilter::fingerprint(const std::string& message_id) {
+  return absl::Hash<std::string>{}(message_id);
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -16,25 +16,44 @@
  */
 #include "FilterExpression.h"
 
-ROCKETMQ_NAMESPACE_BEGIN
+#include "Sql92Filter.h"
+#include "TagFilter.h"
+#include "rocketmq/Logger.h"
+#include "spdlog/spdlog.h"
 
-bool FilterExpression::accept(const MQMessageExt& message) const {
+ROCKETMQ_NAMESPACE_BEGIN
 
+FilterExpression::FilterExpression(std::string expression, ExpressionType expression_type)
+    : content_(std::move(expression)), type_(expression_type), version_(std::chrono::steady_clock::now()) {
   switch (type_) {
     case ExpressionType::TAG: {
-      if (WILD_CARD_TAG == content_) {
-        return true;
-      } else {
-        return message.getTags() == content_;
+      if (content_.empty()) {
+        content_ = WILD_CARD_TAG;
+      }
+
+      if (WILD_CARD_TAG != content_) {
+        filter_ = std::make_shared<TagFilter>(content_);
       }
+      break;
     }
 
     case ExpressionType::SQL92: {
-      // Server should have strictly filtered.
-      return true;
+      std::string error;
+      filter_ = Sql92Filter::compile(content_, error);
+      if (!filter_) {
+        // Server rejects malformed expressions anyway; leave filtering to server.
+        SPDLOG_WARN("Failed to compile SQL92 expression: {}. Cause: {}", content_, error);
+      }
+      break;
     }
   }
-  return true;
+}
+
+bool FilterExpression::accept(const MQMessageExt& message) const {
+  if (!filter_) {
+    return true;
+  }
+  return filter_->accept(message);
 }
 
 const char* FilterExpression::WILD_CARD_TAG = "*";
@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "InflightMessageTable.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+void InflightMessageTable::add(InflightMessage message) {
+  absl::MutexLock lk(&mtx_);
+  std::string message_id = message.message_id;
+  table_[message_id] = std::move(message);
+}
+
+void InflightMessageTable::remove(const std::string& message_id) {
+  absl::MutexLock lk(&mtx_);
+  table_.erase(message_id);
+}
+
+bool InflightMessageTable::receiptHandle(const std::string& message_id, std::string& receipt_handle) const {
+  absl::MutexLock lk(&mtx_);
+  auto it = table_.find(message_id);
+  if (table_.end() == it) {
+    return false;
+  }
+  receipt_handle = it->second.receipt_handle;
+  return true;
+}
+
+bool InflightMessageTable::deadline(const std::string& message_id, absl::Time& deadline) const {
+  absl::MutexLock lk(&mtx_);
+  auto it = table_.find(message_id);
+  if (table_.end() == it) {
+    return false;
+  }
+  deadline = it->second.deadline;
+  return true;
+}
+
+absl::flat_hash_map<std::string, std::vector<InflightMessage>> InflightMessageTable::expiring(absl::Time horizon) {
+  absl::flat_hash_map<std::string, std::vector<InflightMessage>> result;
+  absl::MutexLock lk(&mtx_);
+  for (auto& entry : table_) {
+    InflightMessage& message = entry.second;
+    if (message.renewing || message.deadline > horizon) {
+      continue;
+    }
+    message.renewing = true;
+    result[message.endpoint].push_back(message);
+  }
+  return result;
+}
+
+void InflightMessageTable::renewed(const std::string& message_id, const std::string& receipt_handle,
+                                   absl::Time deadline) {
+  absl::MutexLock lk(&mtx_);
+  auto it = table_.find(message_id);
+  if (table_.end() == it) {
+    // Completed while being renewed.
+    return;
+  }
+  it->second.receipt_handle = receipt_handle;
+  it->second.deadline = deadline;
+  it->second.renewing = false;
+}
+
+void InflightMessageTable::renewFailed(const std::string& message_id) {
+  absl::MutexLock lk(&mtx_);
+  auto it = table_.find(message_id);
+  if (table_.end() != it) {
+    it->second.renewing = false;
+  }
+}
+
+std::size_t InflightMessageTable::size() const {
+  absl::MutexLock lk(&mtx_);
+  return table_.size();
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LagSampler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "absl/strings/str_join.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+LagSampler::LagSampler(EndOffsetQuery query, std::size_t max_inflight_per_broker)
+    : query_(std::move(query)), max_inflight_per_broker_(std::max<std::size_t>(1, max_inflight_per_broker)) {
+}
+
+void LagSampler::sample(const absl::flat_hash_map<MQMessageQueue, std::int64_t>& positions) {
+  absl::flat_hash_map<std::string, std::shared_ptr<Round>> rounds;
+  absl::flat_hash_set<std::string> skipped;
+  {
+    absl::MutexLock lk(&mtx_);
+    tracked_.clear();
+    for (const auto& item : positions) {
+      tracked_.insert(item.first);
+    }
+    for (auto it = lags_.begin(); it != lags_.end();) {
+      if (!tracked_.contains(it->first)) {
+        lags_.erase(it++);
+      } else {
+        it++;
+      }
+    }
+
+    for (const auto& item : positions) {
+      // Consumed offset is unknown until the queue is first received from, or pulled.
+      if (item.second < 0) {
+        continue;
+      }
+      const std::string& broker = item.first.serviceAddress();
+      if (broker.empty()) {
+        continue;
+      }
+      if (busy_brokers_.contains(broker)) {
+        skipped.insert(broker);
+        continue;
+      }
+      auto& round = rounds[broker];
+      if (!round) {
+        round = std::make_shared<Round>();
+        round->broker = broker;
+      }
+      round->positions.emplace_back(item.first, item.second);
+    }
+
+    for (const auto& item : rounds) {
+      busy_brokers_.insert(item.first);
+    }
+  }
+
+  if (!skipped.empty()) {
+    skipped_.fetch_add(skipped.size(), std::memory_order_relaxed);
+    SPDLOG_INFO("Skip sampling lag of queues served by {} as previous rounds are still in flight",
+                absl::StrJoin(skipped, ","));
+  }
+
+  for (const auto& item : rounds) {
+    const auto& round = item.second;
+    round->end_offsets.resize(round->positions.size(), -1);
+    round->remaining.store(round->positions.size(), std::memory_order_relaxed);
+    SPDLOG_DEBUG("Query end offsets of {} queues from {}", round->positions.size(), round->broker);
+    std::size_t window = std::min(max_inflight_per_broker_, round->positions.size());
+    for (std::size_t i = 0; i < window; i++) {
+      issueNext(round);
+    }
+  }
+}
+
+void LagSampler::issueNext(const std::shared_ptr<Round>& round) {
+  std::size_t index = round->next.fetch_add(1, std::memory_order_relaxed);
+  if (index >= round->positions.size()) {
+    return;
+  }
+
+  queries_.fetch_add(1, std::memory_order_relaxed);
+  std::weak_ptr<LagSampler> sampler(shared_from_this());
+  auto callback = [sampler, round, index](const std::error_code& ec, std::int64_t end_offset) {
+    auto ptr = sampler.lock();
+    if (!ptr) {
+      return;
+    }
+
+    if (ec) {
+      ptr->failures_.fetch_add(1, std::memory_order_relaxed);
+      SPDLOG_DEBUG("Failed to query end offset of {} from {}. Cause: {}", round->positions[index].first.simpleName(),
+                   round->broker, ec.message());
+    } else {
+      round->end_offsets[index] = end_offset;
+    }
+
+    // The last completion observes end offsets written by all others through acq_rel ordering of remaining.
+    if (1 == round->remaining.fetch_sub(1, std::memory_order_acq_rel)) {
+      ptr->complete(*round);
+      return;
+    }
+    ptr->issueNext(round);
+  };
+  query_(round->positions[index].first, callback);
+}
+
+void LagSampler::complete(const Round& round) {
+  auto now = std::chrono::system_clock::now();
+  absl::MutexLock lk(&mtx_);
+  busy_brokers_.erase(round.broker);
+  for (std::size_t i = 0; i < round.positions.size(); i++) {
+    const MQMessageQueue& message_queue = round.positions[i].first;
+    std::int64_t end_offset = round.end_offsets[i];
+    if (end_offset < 0 || !tracked_.contains(message_queue)) {
+      continue;
+    }
+    std::int64_t consumed_offset = round.positions[i].second;
+    QueueLag& lag = lags_[message_queue];
+    lag.message_queue = message_queue;
+    lag.consumed_offset = consumed_offset;
+    lag.end_offset = end_offset;
+    lag.lag = std::max<std::int64_t>(0, end_offset - consumed_offset);
+    lag.sampled_at = now;
+  }
+}
+
+std::vector<QueueLag> LagSampler::queueLags() const {
+  std::vector<QueueLag> result;
+  absl::MutexLock lk(&mtx_);
+  result.reserve(lags_.size());
+  for (const auto& item : lags_) {
+    result.push_back(item.second);
+  }
+  return result;
+}
+
+absl::flat_hash_map<std::string, std::int64_t> LagSampler::topicLags() const {
+  absl::flat_hash_map<std::string, std::int64_t> result;
+  absl::MutexLock lk(&mtx_);
+  for (const auto& item : lags_) {
+    result[item.first.getTopic()] += item.second.lag;
+  }
+  return result;
+}
+
+void LagSampler::reportAndReset(std::string& stats) {
+  struct TopicLag {
+    std::int64_t backlog{0};
+    std::size_t queues{0};
+    const QueueLag* max{nullptr};
+  };
+
+  std::vector<std::string> topics;
+  {
+    absl::MutexLock lk(&mtx_);
+    absl::flat_hash_map<std::string, TopicLag> table;
+    for (const auto& item : lags_) {
+      TopicLag& topic_lag = table[item.first.getTopic()];
+      topic_lag.backlog += item.second.lag;
+      topic_lag.queues++;
+      if (!topic_lag.max || topic_lag.max->lag < item.second.lag) {
+        topic_lag.max = &item.second;
+      }
+    }
+    for (const auto& item : table) {
+      topics.push_back(fmt::format("{}[backlog={}, queues={}, max={}:{}]", item.first, item.second.backlog,
+                                   item.second.queues, item.second.max->message_queue.simpleName(),
+                                   item.second.max->lag));
+    }
+  }
+  std::sort(topics.begin(), topics.end());
+
+  stats = fmt::format("ConsumerLag: {}, queries={}, failures={}, skipped-brokers={}", absl::StrJoin(topics, ", "),
+                      queries_.exchange(0, std::memory_order_relaxed), failures_.exchange(0, std::memory_order_relaxed),
+                      skipped_.exchange(0, std::memory_order_relaxed));
+}
+
+ROCKETMQ_NAMESPACE_END
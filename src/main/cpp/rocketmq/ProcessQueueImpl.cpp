@@ -16,6 +16,7 @@
  */
 #include "ProcessQueueImpl.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -24,6 +25,7 @@
 
 #include "AsyncReceiveMessageCallback.h"
 #include "ClientManagerImpl.h"
+#include "LockContention.h"
 #include "MetadataConstants.h"
 #include "Protocol.h"
 #include "PushConsumerImpl.h"
@@ -41,13 +43,22 @@ ROCKETMQ_NAMESPACE_BEGIN
 ProcessQueueImpl::ProcessQueueImpl(MQMessageQueue message_queue, FilterExpression filter_expression,
                                    std::weak_ptr<PushConsumer> consumer, std::shared_ptr<ClientManager> client_instance)
     : message_queue_(std::move(message_queue)), filter_expression_(std::move(filter_expression)),
-      invisible_time_(MixAll::millisecondsOf(MixAll::DEFAULT_INVISIBLE_TIME_)),
       simple_name_(message_queue_.simpleName()), consumer_(std::move(consumer)),
       client_manager_(std::move(client_instance)), cached_message_quantity_(0), cached_message_memory_(0) {
+  LockContention::instance().track(&broadcast_messages_mtx_, "ProcessQueueImpl::broadcast_messages_mtx_");
   SPDLOG_DEBUG("Created ProcessQueue={}", simpleName());
 }
 
 ProcessQueueImpl::~ProcessQueueImpl() {
+  LockContention::instance().untrack(&broadcast_messages_mtx_);
+  std::uint64_t bytes = cached_message_memory_.load(std::memory_order_relaxed);
+  if (bytes) {
+    // Messages still cached are dropped along with this queue.
+    auto memory_quota = client_manager_->memoryQuota();
+    if (memory_quota) {
+      memory_quota->release(bytes);
+    }
+  }
   SPDLOG_INFO("ProcessQueue={} should have been re-balanced away, thus, is destructed", simpleName());
 }
 
@@ -56,6 +67,11 @@ void ProcessQueueImpl::callback(std::shared_ptr<AsyncReceiveMessageCallback> cal
 }
 
 bool ProcessQueueImpl::expired() const {
+  if (paused()) {
+    // Paused queues idle on purpose.
+    return false;
+  }
+
   auto duration = std::chrono::steady_clock::now() - idle_since_;
   if (duration > MixAll::PROCESS_QUEUE_EXPIRATION_THRESHOLD_) {
     SPDLOG_WARN("ProcessQueue={} is expired. It remains idle for {}ms", simpleName(), MixAll::millisecondsOf(duration));
@@ -97,9 +113,36 @@ bool ProcessQueueImpl::shouldThrottle() const {
       return true;
     }
   }
+
+  auto memory_quota = client_manager_->memoryQuota();
+  if (memory_quota && memory_quota->nearLimit()) {
+    SPDLOG_WARN("{}: Received messages of all queues take {} bytes, approaching memory quota={}", simple_name_,
+                memory_quota->used(), memory_quota->limit());
+    return true;
+  }
   return false;
 }
 
+bool ProcessQueueImpl::park() {
+  if (!paused()) {
+    return false;
+  }
+
+  parked_.store(true, std::memory_order_release);
+  if (paused()) {
+    SPDLOG_DEBUG("Receive cycle of {} is parked", simple_name_);
+    return true;
+  }
+
+  // resume() raced in between. Unless it has claimed the parked cycle, carry on receiving.
+  return !parked_.exchange(false, std::memory_order_acq_rel);
+}
+
+bool ProcessQueueImpl::resume() {
+  paused_.store(false, std::memory_order_release);
+  return parked_.exchange(false, std::memory_order_acq_rel);
+}
+
 void ProcessQueueImpl::receiveMessage() {
   auto consumer = consumer_.lock();
   if (!consumer) {
@@ -120,7 +163,7 @@ void ProcessQueueImpl::receiveMessage() {
 
 void ProcessQueueImpl::popMessage() {
   rmq::ReceiveMessageRequest request;
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   auto consumer_client = consumer_.lock();
   if (!consumer_client) {
     return;
@@ -142,9 +185,22 @@ void ProcessQueueImpl::accountCache(const std::vector<MQMessageExt>& messages) {
     return;
   }
 
+  std::uint64_t bytes = 0;
+  std::int64_t received_offset = -1;
   for (const auto& message : messages) {
     cached_message_quantity_.fetch_add(1, std::memory_order_relaxed);
     cached_message_memory_.fetch_add(message.getBody().size(), std::memory_order_relaxed);
+    bytes += message.getBody().size();
+    received_offset = std::max(received_offset, message.getQueueOffset() + 1);
+  }
+  std::int64_t current = received_offset_.load(std::memory_order_relaxed);
+  while (received_offset > current &&
+         !received_offset_.compare_exchange_weak(current, received_offset, std::memory_order_relaxed)) {
+  }
+
+  auto memory_quota = client_manager_->memoryQuota();
+  if (memory_quota) {
+    memory_quota->acquire(bytes);
   }
 
   SPDLOG_DEBUG("Cache of process-queue={} has {} messages, body of them taking up {} bytes", simple_name_,
@@ -162,6 +218,10 @@ void ProcessQueueImpl::release(uint64_t body_size) {
                cached_message_quantity_.load(std::memory_order_relaxed));
 
   auto prev_memory = cached_message_memory_.fetch_sub(body_size);
+  auto memory_quota = client_manager_->memoryQuota();
+  if (memory_quota) {
+    memory_quota->release(body_size);
+  }
   SPDLOG_DEBUG("Cached memory changed from {} --> {}", prev_memory,
                cached_message_memory_.load(std::memory_order_relaxed));
 }
@@ -191,8 +251,7 @@ void ProcessQueueImpl::wrapFilterExpression(rmq::FilterExpression* filter_expres
   }
 }
 
-void ProcessQueueImpl::wrapPopMessageRequest(absl::flat_hash_map<std::string, std::string>& metadata,
-                                             rmq::ReceiveMessageRequest& request) {
+void ProcessQueueImpl::wrapPopMessageRequest(Metadata& metadata, rmq::ReceiveMessageRequest& request) {
   std::shared_ptr<PushConsumer> consumer = consumer_.lock();
   assert(consumer);
 
@@ -222,9 +281,10 @@ void ProcessQueueImpl::wrapPopMessageRequest(absl::flat_hash_map<std::string, st
   request.set_batch_size(consumer->receiveBatchSize());
 
   // Set invisible time
+  auto invisible_time = consumer->invisibleDuration();
   request.mutable_invisible_duration()->set_seconds(
-      std::chrono::duration_cast<std::chrono::seconds>(invisible_time_).count());
-  auto fraction = invisible_time_ - std::chrono::duration_cast<std::chrono::seconds>(invisible_time_);
+      std::chrono::duration_cast<std::chrono::seconds>(invisible_time).count());
+  auto fraction = invisible_time - std::chrono::duration_cast<std::chrono::seconds>(invisible_time);
   int32_t nano_seconds = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(fraction).count());
   request.mutable_invisible_duration()->set_nanos(nano_seconds);
 
@@ -253,7 +313,7 @@ void ProcessQueueImpl::pullMessage() {
   }
 
   rmq::PullMessageRequest request;
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
 
   Signature::sign(consumer_client.get(), metadata);
   wrapPullMessageRequest(metadata, request);
@@ -275,8 +335,7 @@ void ProcessQueueImpl::pullMessage() {
       absl::ToChronoMilliseconds(consumer_client->getLongPollingTimeout() + consumer_client->getIoTimeout()), callback);
 }
 
-void ProcessQueueImpl::wrapPullMessageRequest(absl::flat_hash_map<std::string, std::string>& metadata,
-                                              rmq::PullMessageRequest& request) {
+void ProcessQueueImpl::wrapPullMessageRequest(Metadata& metadata, rmq::PullMessageRequest& request) {
   std::shared_ptr<PushConsumer> consumer = consumer_.lock();
   if (!consumer) {
     return;
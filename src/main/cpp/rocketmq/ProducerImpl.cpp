@@ -16,6 +16,7 @@
  */
 #include "ProducerImpl.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <limits>
@@ -23,6 +24,7 @@
 #include <utility>
 
 #include "Client.h"
+#include "CountdownLatch.h"
 #include "absl/strings/str_join.h"
 #include "opencensus/trace/propagation/trace_context.h"
 #include "opencensus/trace/span.h"
@@ -38,6 +40,7 @@
 #include "SendMessageContext.h"
 #include "Signature.h"
 #include "TracingUtility.h"
+#include "TransactionCheckExecutor.h"
 #include "TransactionImpl.h"
 #include "UniqueIdGenerator.h"
 #include "UtilAll.h"
@@ -67,9 +70,70 @@ void ProducerImpl::start() {
     return;
   }
 
+  // Producers that do not send transactional messages never get checks to run.
+  if (transaction_state_checker_) {
+    transaction_check_executor_ =
+        std::make_shared<TransactionCheckExecutor>(transaction_check_workers_, transaction_check_capacity_);
+    transaction_check_executor_->start();
+    std::weak_ptr<TransactionCheckExecutor> executor(transaction_check_executor_);
+    auto transaction_check_stats_functor = [executor]() {
+      auto ptr = executor.lock();
+      if (ptr) {
+        std::string stats;
+        ptr->reportAndReset(stats);
+        SPDLOG_INFO("{}", stats);
+      }
+    };
+    transaction_check_stats_handle_ = client_manager_->getScheduler()->schedule(
+        transaction_check_stats_functor, TRANSACTION_CHECK_STATS_TASK_NAME, std::chrono::seconds(10),
+        std::chrono::seconds(10));
+  }
+
+  if (delayed_send_memory_budget_) {
+    std::weak_ptr<ProducerImpl> producer(shared_from_this());
+    auto dispatcher = [producer](const MQMessage& message, SendCallback* callback) {
+      auto ptr = producer.lock();
+      if (!ptr) {
+        std::error_code ec = ErrorCode::IllegalState;
+        callback->onFailure(ec);
+        return;
+      }
+      ptr->send(message, callback);
+    };
+    delayed_send_queue_ = std::make_shared<DelayedSendQueue>(
+        dispatcher, delayed_send_memory_budget_, MixAll::DELAYED_SEND_TICK, MixAll::DELAYED_SEND_WHEEL_SIZE);
+
+    std::weak_ptr<DelayedSendQueue> queue(delayed_send_queue_);
+    auto delayed_send_tick_functor = [queue]() {
+      auto ptr = queue.lock();
+      if (ptr) {
+        ptr->advance();
+      }
+    };
+    delayed_send_tick_handle_ = client_manager_->getScheduler()->schedule(
+        delayed_send_tick_functor, DELAYED_SEND_TICK_TASK_NAME, MixAll::DELAYED_SEND_TICK, MixAll::DELAYED_SEND_TICK);
+
+    auto delayed_send_stats_functor = [queue]() {
+      auto ptr = queue.lock();
+      if (ptr) {
+        std::string stats;
+        ptr->reportAndReset(stats);
+        SPDLOG_INFO("{}", stats);
+      }
+    };
+    delayed_send_stats_handle_ = client_manager_->getScheduler()->schedule(
+        delayed_send_stats_functor, DELAYED_SEND_STATS_TASK_NAME, std::chrono::seconds(10), std::chrono::seconds(10));
+  }
+
   client_manager_->addClientObserver(shared_from_this());
 }
 
+const char* ProducerImpl::TRANSACTION_CHECK_STATS_TASK_NAME = "transaction-check-stats-task";
+
+const char* ProducerImpl::DELAYED_SEND_TICK_TASK_NAME = "delayed-send-tick-task";
+
+const char* ProducerImpl::DELAYED_SEND_STATS_TASK_NAME = "delayed-send-stats-task";
+
 void ProducerImpl::shutdown() {
   State expected = State::STARTED;
   if (!state_.compare_exchange_strong(expected, State::STOPPING)) {
@@ -78,6 +142,24 @@ void ProducerImpl::shutdown() {
     return;
   }
 
+  if (transaction_check_stats_handle_) {
+    client_manager_->getScheduler()->cancel(transaction_check_stats_handle_);
+  }
+  if (transaction_check_executor_) {
+    transaction_check_executor_->shutdown();
+  }
+
+  if (delayed_send_tick_handle_) {
+    client_manager_->getScheduler()->cancel(delayed_send_tick_handle_);
+  }
+  if (delayed_send_stats_handle_) {
+    client_manager_->getScheduler()->cancel(delayed_send_stats_handle_);
+  }
+  if (delayed_send_queue_) {
+    // Messages yet to fall due are not sent by a stopping producer.
+    delayed_send_queue_->clear(ErrorCode::IllegalState);
+  }
+
   notifyClientTermination();
 
   ClientImpl::shutdown();
@@ -345,7 +427,7 @@ void ProducerImpl::sendImpl(RetrySendCallback* callback) {
   Metadata metadata;
   Signature::sign(this, metadata);
 
-  client_manager_->send(target, metadata, request, callback);
+  client_manager_->send(target, metadata, request, absl::ToChronoMilliseconds(callback->remaining()), callback);
 }
 
 void ProducerImpl::send0(const MQMessage& message, SendCallback* callback, std::vector<MQMessageQueue> list,
@@ -370,8 +452,9 @@ void ProducerImpl::send0(const MQMessage& message, SendCallback* callback, std::
     return;
   }
   MQMessageQueue message_queue = list[0];
-  auto retry_callback =
-      new RetrySendCallback(shared_from_this(), message, max_attempt_times, callback, std::move(list));
+  // The send timeout bounds the whole operation rather than each attempt: retries spend what is left of it.
+  auto retry_callback = new RetrySendCallback(shared_from_this(), message, max_attempt_times, absl::Now() + io_timeout_,
+                                              callback, std::move(list));
   sendImpl(retry_callback);
   const_cast<MQMessage&>(message).traceContext(
       opencensus::trace::propagation::ToTraceParentHeader(retry_callback->span().context()));
@@ -379,7 +462,19 @@ void ProducerImpl::send0(const MQMessage& message, SendCallback* callback, std::
 
 bool ProducerImpl::endTransaction0(const std::string& target, const MQMessage& message,
                                    const std::string& transaction_id, TransactionState resolution) {
+  bool success = false;
+  CountdownLatch latch(1);
+  endTransaction0(target, message, transaction_id, resolution, [&](bool result) {
+    success = result;
+    latch.countdown();
+  });
+  latch.await();
+  return success;
+}
 
+void ProducerImpl::endTransaction0(const std::string& target, const MQMessage& message,
+                                   const std::string& transaction_id, TransactionState resolution,
+                                   const std::function<void(bool)>& callback) {
   EndTransactionRequest request;
   request.set_message_id(message.getMsgId());
   request.set_transaction_id(transaction_id);
@@ -397,10 +492,8 @@ bool ProducerImpl::endTransaction0(const std::string& target, const MQMessage& m
       action = "rollback";
       break;
   }
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
-  bool completed = false;
-  bool success = false;
   // Trace transactional message
   opencensus::trace::SpanContext span_context =
       opencensus::trace::propagation::FromTraceParentHeader(message.traceContext());
@@ -418,10 +511,7 @@ bool ProducerImpl::endTransaction0(const std::string& target, const MQMessage& m
   span.AddAttribute(MixAll::SPAN_ATTRIBUTE_KEY_ROCKETMQ_OPERATION, trace_operation_name);
   TracingUtility::addUniversalSpanAttributes(message, *this, span);
 
-  absl::Mutex mtx;
-  absl::CondVar cv;
-  auto cb = [&, span](const std::error_code& ec, const EndTransactionResponse& response) {
-    completed = true;
+  auto cb = [action, target, span, callback](const std::error_code& ec, const EndTransactionResponse& response) {
     if (ec) {
       {
         span.SetStatus(opencensus::trace::StatusCode::ABORTED);
@@ -429,27 +519,17 @@ bool ProducerImpl::endTransaction0(const std::string& target, const MQMessage& m
         span.End();
       }
       SPDLOG_WARN("Failed to send {} transaction request to {}. Cause: ", action, target, ec.message());
-      success = false;
+      callback(false);
     } else {
       {
         span.SetStatus(opencensus::trace::StatusCode::OK);
         span.End();
       }
-      success = true;
-    }
-
-    {
-      absl::MutexLock lk(&mtx);
-      cv.SignalAll();
+      callback(true);
     }
   };
 
   client_manager_->endTransaction(target, metadata, request, absl::ToChronoMilliseconds(io_timeout_), cb);
-  {
-    absl::MutexLock lk(&mtx);
-    cv.Wait(&mtx);
-  }
-  return success;
 }
 
 void ProducerImpl::isolatedEndpoints(absl::flat_hash_set<std::string>& endpoints) {
@@ -548,25 +628,18 @@ void ProducerImpl::asyncPublishInfo(const std::string& topic,
 }
 
 TopicPublishInfoPtr ProducerImpl::getPublishInfo(const std::string& topic) {
-  bool complete = false;
-  absl::Mutex mtx;
-  absl::CondVar cv;
+  CountdownLatch latch(1);
   TopicPublishInfoPtr topic_publish_info;
   std::error_code error_code;
   auto cb = [&](const std::error_code& ec, const TopicPublishInfoPtr& ptr) {
-    absl::MutexLock lk(&mtx);
     topic_publish_info = ptr;
     error_code = ec;
-    complete = true;
-    cv.SignalAll();
+    latch.countdown();
   };
   asyncPublishInfo(topic, cb);
 
   // Wait till acquiring topic publish info completes
-  while (!complete) {
-    absl::MutexLock lk(&mtx);
-    cv.Wait(&mtx);
-  }
+  latch.await();
 
   // TODO: propogate error_code to caller
   return topic_publish_info;
@@ -581,24 +654,16 @@ void ProducerImpl::takeMessageQueuesRoundRobin(const TopicPublishInfoPtr& publis
 }
 
 std::vector<MQMessageQueue> ProducerImpl::listMessageQueue(const std::string& topic, std::error_code& ec) {
-  absl::Mutex mtx;
-  absl::CondVar cv;
-  bool completed = false;
+  CountdownLatch latch(1);
   TopicPublishInfoPtr ptr;
   auto await_callback = [&](const std::error_code& error_code, const TopicPublishInfoPtr& publish_info) {
-    absl::MutexLock lk(&mtx);
     ptr = publish_info;
     ec = error_code;
-    completed = true;
-    cv.SignalAll();
+    latch.countdown();
   };
 
   asyncPublishInfo(topic, await_callback);
-
-  while (!completed) {
-    absl::MutexLock lk(&mtx);
-    cv.Wait(&mtx);
-  }
+  latch.await();
 
   if (ec) {
     return {};
@@ -614,13 +679,73 @@ void ProducerImpl::prepareHeartbeatData(HeartbeatRequest& request) {
 }
 
 void ProducerImpl::resolveOrphanedTransactionalMessage(const std::string& transaction_id, const MQMessageExt& message) {
-  if (transaction_state_checker_) {
-    TransactionState state = transaction_state_checker_->checkLocalTransactionState(message);
-    const std::string& target_host = MessageAccessor::targetEndpoint(message);
-    endTransaction0(target_host, message, transaction_id, state);
-  } else {
+  if (!transaction_state_checker_) {
     SPDLOG_WARN("LocalTransactionStateChecker is unexpectedly nullptr");
+    return;
+  }
+
+  if (!transaction_check_executor_) {
+    SPDLOG_WARN("LocalTransactionStateChecker was set after start. Skip checking transaction[id={}]", transaction_id);
+    return;
+  }
+
+  // The checker may take its time, so it runs on the check executor and the resolution is reported asynchronously.
+  std::weak_ptr<ProducerImpl> producer(shared_from_this());
+  auto task = [producer, transaction_id, message](const TransactionCheckExecutor::Completion& completion) {
+    auto ptr = producer.lock();
+    if (!ptr) {
+      completion();
+      return;
+    }
+    TransactionState state = ptr->transaction_state_checker_->checkLocalTransactionState(message);
+    const std::string& target_host = MessageAccessor::targetEndpoint(message);
+    ptr->endTransaction0(target_host, message, transaction_id, state, [completion](bool) { completion(); });
+  };
+  transaction_check_executor_->submit(transaction_id, task);
+}
+
+void ProducerImpl::transactionCheckExecutor(std::uint16_t workers, std::size_t capacity) {
+  if (State::CREATED != state_.load(std::memory_order_relaxed)) {
+    SPDLOG_WARN("Transaction check executor can only be configured prior to start");
+    return;
+  }
+  transaction_check_workers_ = std::max<std::uint16_t>(1, workers);
+  transaction_check_capacity_ = std::max<std::size_t>(1, capacity);
+}
+
+void ProducerImpl::delayedSend(std::uint64_t memory_budget) {
+  if (State::CREATED != state_.load(std::memory_order_relaxed)) {
+    SPDLOG_WARN("Delayed send can only be enabled prior to start");
+    return;
+  }
+  delayed_send_memory_budget_ = memory_budget;
+}
+
+void ProducerImpl::sendDelayed(const MQMessage& message, std::chrono::milliseconds delay, SendCallback* callback) {
+  std::error_code ec;
+  ensureRunning(ec);
+  if (!ec && !delayed_send_queue_) {
+    SPDLOG_WARN("Delayed send is not enabled for producer group {}", group_name_);
+    ec = ErrorCode::BadConfiguration;
+  }
+  if (!ec && !validate(message)) {
+    ec = ErrorCode::BadRequest;
+  }
+  if (ec) {
+    callback->onFailure(ec);
+    return;
+  }
+
+  if (!delayed_send_queue_->schedule(message, delay, callback, ec)) {
+    callback->onFailure(ec);
+  }
+}
+
+bool ProducerImpl::cancelDelayed(const std::string& message_id) {
+  if (!delayed_send_queue_) {
+    return false;
   }
+  return delayed_send_queue_->cancel(message_id);
 }
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -16,7 +16,9 @@
  */
 #include "PullConsumerImpl.h"
 #include "InvocationContext.h"
+#include "MixAll.h"
 #include "Signature.h"
+#include "absl/types/optional.h"
 #include "apache/rocketmq/v1/definition.pb.h"
 #include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQClientException.h"
@@ -34,10 +36,33 @@ void PullConsumerImpl::start() {
     return;
   }
   client_manager_->addClientObserver(shared_from_this());
+
+  std::weak_ptr<PullConsumerImpl> consumer_weak_ptr(shared_from_this());
+  auto end_offset_query = [consumer_weak_ptr](const MQMessageQueue& message_queue,
+                                              const LagSampler::EndOffsetCallback& cb) {
+    auto consumer = consumer_weak_ptr.lock();
+    if (consumer) {
+      consumer->queryEndOffset(message_queue, cb);
+    }
+  };
+  lag_sampler_ = std::make_shared<LagSampler>(end_offset_query, MixAll::LAG_SAMPLE_INFLIGHT_PER_BROKER);
+  auto lag_sample_functor = [consumer_weak_ptr]() {
+    auto consumer = consumer_weak_ptr.lock();
+    if (consumer) {
+      consumer->sampleLag();
+    }
+  };
+  lag_sample_handle_ = client_manager_->getScheduler()->schedule(
+      lag_sample_functor, LAG_SAMPLE_TASK_NAME, MixAll::LAG_SAMPLE_INTERVAL, MixAll::LAG_SAMPLE_INTERVAL);
 }
 
+const char* PullConsumerImpl::LAG_SAMPLE_TASK_NAME = "lag-sample-task";
+
 void PullConsumerImpl::shutdown() {
   // Shutdown services started by current tier
+  if (lag_sample_handle_) {
+    client_manager_->getScheduler()->cancel(lag_sample_handle_);
+  }
 
   notifyClientTermination();
 
@@ -107,7 +132,7 @@ std::future<int64_t> PullConsumerImpl::queryOffset(const OffsetQuery& query) {
 
   request.mutable_partition()->set_id(query.message_queue.getQueueId());
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
 
   Signature::sign(this, metadata);
 
@@ -145,23 +170,94 @@ void PullConsumerImpl::pull(const PullMessageQuery& query, PullCallback* cb) {
   std::string target_host = query.message_queue.serviceAddress();
   assert(!target_host.empty());
 
-  auto callback = [target_host, cb](const std::error_code& ec, const ReceiveMessageResult& result) {
+  absl::optional<FilterExpression> filter_expression;
+  {
+    absl::MutexLock lk(&topic_filter_expression_table_mtx_);
+    auto search = topic_filter_expression_table_.find(query.message_queue.getTopic());
+    if (topic_filter_expression_table_.end() != search) {
+      filter_expression = search->second;
+    }
+  }
+
+  if (filter_expression.has_value()) {
+    auto expression = request.mutable_filter_expression();
+    expression->set_type(ExpressionType::SQL92 == filter_expression->type_ ? rmq::FilterType::SQL
+                                                                            : rmq::FilterType::TAG);
+    expression->set_expression(filter_expression->content_);
+  }
+
+  // Messages are moved, never copied, from the response into the PullResult handed over to cb.
+  std::weak_ptr<PullConsumerImpl> consumer_weak_ptr(shared_from_this());
+  MQMessageQueue message_queue = query.message_queue;
+  auto callback = [target_host, cb, filter_expression, consumer_weak_ptr, message_queue](const std::error_code& ec,
+                                                                                         ReceiveMessageResult& result) {
     if (ec) {
       cb->onFailure(ec);
       return;
     }
 
-    PullResult pull_result(result.min_offset, result.max_offset, result.next_offset, result.messages);
-    cb->onSuccess(pull_result);
+    auto consumer = consumer_weak_ptr.lock();
+    if (consumer) {
+      consumer->pulled(message_queue, result.next_offset);
+    }
+
+    if (!filter_expression.has_value()) {
+      PullResult pull_result(result.min_offset, result.max_offset, result.next_offset, std::move(result.messages));
+      cb->onSuccess(std::move(pull_result));
+      return;
+    }
+
+    // Offsets are left intact so that next pull skips the dropped messages as well.
+    std::vector<MQMessageExt> messages;
+    messages.reserve(result.messages.size());
+    for (auto& message : result.messages) {
+      if (filter_expression->accept(message)) {
+        messages.push_back(std::move(message));
+      }
+    }
+    PullResult pull_result(result.min_offset, result.max_offset, result.next_offset, std::move(messages));
+    cb->onSuccess(std::move(pull_result));
   };
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
 
   client_manager_->pullMessage(target_host, metadata, request, absl::ToChronoMilliseconds(long_polling_timeout_),
                                callback);
 }
 
+void PullConsumerImpl::pulled(const MQMessageQueue& message_queue, std::int64_t next_offset) {
+  absl::MutexLock lk(&pulled_offsets_mtx_);
+  pulled_offsets_[message_queue] = next_offset;
+}
+
+std::vector<QueueLag> PullConsumerImpl::queueLags() const {
+  if (!lag_sampler_) {
+    return {};
+  }
+  return lag_sampler_->queueLags();
+}
+
+void PullConsumerImpl::sampleLag() {
+  std::string stats;
+  lag_sampler_->reportAndReset(stats);
+  SPDLOG_INFO("{}", stats);
+
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions;
+  {
+    absl::MutexLock lk(&pulled_offsets_mtx_);
+    positions = pulled_offsets_;
+  }
+  lag_sampler_->sample(positions);
+}
+
+void PullConsumerImpl::subscribe(const std::string& topic, const std::string& expression,
+                                 ExpressionType expression_type) {
+  absl::MutexLock lk(&topic_filter_expression_table_mtx_);
+  topic_filter_expression_table_.erase(topic);
+  topic_filter_expression_table_.emplace(topic, FilterExpression(expression, expression_type));
+}
+
 void PullConsumerImpl::prepareHeartbeatData(HeartbeatRequest& request) {
   request.set_client_id(clientId());
   auto consumer_data = request.mutable_consumer_data();
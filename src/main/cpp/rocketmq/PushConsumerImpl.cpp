@@ -16,6 +16,7 @@
  */
 #include "PushConsumerImpl.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
@@ -29,6 +30,9 @@
 #include "ProcessQueueImpl.h"
 #include "RpcClient.h"
 #include "Signature.h"
+#include "absl/time/clock.h"
+#include "google/rpc/code.pb.h"
+#include "rocketmq/ErrorCode.h"
 #include "rocketmq/MessageListener.h"
 #include "rocketmq/MessageModel.h"
 #include "spdlog/spdlog.h"
@@ -43,32 +47,108 @@ PushConsumerImpl::~PushConsumerImpl() {
 }
 
 void PushConsumerImpl::start() {
+  std::future<void> readiness = startAsync();
+  if (std::future_status::ready == readiness.wait_for(startup_timeout_)) {
+    return;
+  }
+
+  std::string stages;
+  if (startup_tracker_) {
+    startup_tracker_->pendingStages(stages);
+  }
+  SPDLOG_WARN("PushConsumer[group={}] is not ready in {}ms, still waiting for {}. Start-up goes on in background",
+              group_name_, startup_timeout_.count(), stages);
+}
+
+std::future<void> PushConsumerImpl::startAsync() {
   ClientImpl::start();
 
   State expecting = State::STARTING;
   if (!state_.compare_exchange_strong(expecting, State::STARTED)) {
     SPDLOG_ERROR("Unexpected consumer state. Expecting: {}, Actual: {}", State::STARTING,
                  state_.load(std::memory_order_relaxed));
-    return;
+    std::promise<void> promise;
+    promise.set_value();
+    return promise.get_future();
   }
 
   if (!message_listener_) {
     SPDLOG_ERROR("Required message listener is nullptr");
     abort();
-    return;
   }
 
   client_manager_->addClientObserver(shared_from_this());
 
-  fetchRoutes();
-
-  consume_message_service_ =
-      std::make_shared<ConsumeMessageServiceImpl>(shared_from_this(), consume_thread_pool_size_, message_listener_);
+  auto consume_message_service = std::make_shared<ConsumeMessageServiceImpl>(
+      shared_from_this(), consume_thread_pool_size_, max_consume_thread_pool_size_, message_listener_);
+  consume_message_service->retryPolicy(consume_retry_policy_);
+  consume_message_service->deduplication(deduplication_window_, deduplication_capacity_, duplicate_action_);
+  consume_message_service_ = consume_message_service;
   consume_message_service_->start();
   SPDLOG_INFO("ConsumeMessageService started");
 
+  if (consume_message_service->elastic()) {
+    std::weak_ptr<ConsumeMessageServiceImpl> service_weak_ptr(consume_message_service);
+    auto adjust_thread_pool_functor = [service_weak_ptr]() {
+      auto service = service_weak_ptr.lock();
+      if (service) {
+        service->adjustThreadPool();
+      }
+    };
+    adjust_thread_pool_handle_ = client_manager_->getScheduler()->schedule(
+        adjust_thread_pool_functor, ADJUST_THREAD_POOL_TASK_NAME, std::chrono::seconds(1), std::chrono::seconds(1));
+  }
+
+  if (consume_retry_policy_.enabled() || consume_message_service->deduplicating()) {
+    std::weak_ptr<ConsumeMessageServiceImpl> service_weak_ptr(consume_message_service);
+    auto consume_stats_functor = [service_weak_ptr]() {
+      auto service = service_weak_ptr.lock();
+      if (service) {
+        std::string stats;
+        service->reportAndReset(stats);
+        SPDLOG_INFO("{}", stats);
+      }
+    };
+    consume_stats_handle_ = client_manager_->getScheduler()->schedule(
+        consume_stats_functor, CONSUME_STATS_TASK_NAME, std::chrono::seconds(10), std::chrono::seconds(10));
+  }
+
+  // Lag is sampled in both message models; only where consumed positions come from differs.
+  {
+    std::weak_ptr<PushConsumerImpl> consumer_weak_ptr(shared_from_this());
+    auto end_offset_query = [consumer_weak_ptr](const MQMessageQueue& message_queue,
+                                                const LagSampler::EndOffsetCallback& cb) {
+      auto consumer = consumer_weak_ptr.lock();
+      if (consumer) {
+        consumer->queryEndOffset(message_queue, cb);
+      }
+    };
+    lag_sampler_ = std::make_shared<LagSampler>(end_offset_query, MixAll::LAG_SAMPLE_INFLIGHT_PER_BROKER);
+    auto lag_sample_functor = [consumer_weak_ptr]() {
+      auto consumer = consumer_weak_ptr.lock();
+      if (consumer) {
+        consumer->sampleLag();
+      }
+    };
+    lag_sample_handle_ = client_manager_->getScheduler()->schedule(
+        lag_sample_functor, LAG_SAMPLE_TASK_NAME, MixAll::LAG_SAMPLE_INTERVAL, MixAll::LAG_SAMPLE_INTERVAL);
+  }
+
+  if (MessageModel::CLUSTERING == message_model_) {
+    std::weak_ptr<PushConsumerImpl> consumer_weak_ptr(shared_from_this());
+    auto renew_invisible_duration_functor = [consumer_weak_ptr]() {
+      auto consumer = consumer_weak_ptr.lock();
+      if (consumer) {
+        consumer->renewInvisibleDuration();
+      }
+    };
+    renew_invisible_duration_handle_ =
+        client_manager_->getScheduler()->schedule(renew_invisible_duration_functor, RENEW_INVISIBLE_DURATION_TASK_NAME,
+                                                  std::chrono::seconds(1), std::chrono::seconds(1));
+  }
+
   // Heartbeat depends on initialization of consume-message-service
-  heartbeat();
+  std::future<void> readiness = bootstrap();
 
   std::weak_ptr<PushConsumerImpl> consumer_weak_ptr(shared_from_this());
   auto scan_assignment_functor = [consumer_weak_ptr]() {
@@ -78,14 +158,88 @@ void PushConsumerImpl::start() {
     }
   };
 
+  // The first round is driven by bootstrap().
   scan_assignment_handle_ = client_manager_->getScheduler()->schedule(
-      scan_assignment_functor, SCAN_ASSIGNMENT_TASK_NAME, std::chrono::milliseconds(100), std::chrono::seconds(5));
+      scan_assignment_functor, SCAN_ASSIGNMENT_TASK_NAME, std::chrono::seconds(5), std::chrono::seconds(5));
 
   SPDLOG_INFO("PushConsumer started, groupName={}", group_name_);
+  return readiness;
+}
+
+std::future<void> PushConsumerImpl::bootstrap() {
+  std::vector<std::pair<std::string, FilterExpression>> subscriptions;
+  {
+    absl::MutexLock lk(&topic_filter_expression_table_mtx_);
+    subscriptions.insert(subscriptions.end(), topic_filter_expression_table_.begin(),
+                         topic_filter_expression_table_.end());
+  }
+
+  std::vector<std::string> topics;
+  topics.reserve(subscriptions.size());
+  for (const auto& subscription : subscriptions) {
+    topics.push_back(subscription.first);
+  }
+  auto tracker = std::make_shared<StartupTracker>(topics);
+  std::future<void> readiness = tracker->readiness();
+  startup_tracker_ = tracker;
+
+  std::weak_ptr<PushConsumerImpl> consumer_weak_ptr(shared_from_this());
+  for (const auto& subscription : subscriptions) {
+    std::string topic = subscription.first;
+    FilterExpression filter_expression = subscription.second;
+
+    auto assignment_callback = [consumer_weak_ptr, tracker, topic, filter_expression](
+                                   const std::error_code& ec, const TopicAssignmentPtr& assignments) {
+      auto consumer = consumer_weak_ptr.lock();
+      if (ec) {
+        SPDLOG_WARN("Failed to acquire assignments for topic={} during start-up. Cause: {}", topic, ec.message());
+      } else if (consumer && assignments && !assignments->assignmentList().empty()) {
+        consumer->syncProcessQueue(topic, assignments, filter_expression);
+      }
+      tracker->assigned(topic, !ec);
+    };
+
+    auto route_callback = [consumer_weak_ptr, tracker, topic, assignment_callback](const std::error_code& ec,
+                                                                                 const TopicRouteDataPtr& route) {
+      auto consumer = consumer_weak_ptr.lock();
+      if (ec || !route || !consumer) {
+        SPDLOG_WARN("Failed to fetch route for topic={} during start-up. Cause: {}", topic, ec.message());
+        tracker->routeFetched(topic, false);
+        return;
+      }
+      tracker->routeFetched(topic, true);
+
+      // Register with brokers of this route before querying assignment, each broker once per start-up.
+      absl::flat_hash_set<std::string> hosts;
+      for (const auto& partition : route->partitions()) {
+        hosts.insert(partition.asMessageQueue().serviceAddress());
+      }
+      tracker->firstContact(hosts);
+      if (!hosts.empty()) {
+        consumer->heartbeat(hosts);
+      }
+
+      // Route is cached by now, so the assignment query goes out right away.
+      consumer->queryAssignment(topic, assignment_callback);
+    };
+
+    getRouteFor(topic, route_callback);
+  }
+  return readiness;
 }
 
 const char* PushConsumerImpl::SCAN_ASSIGNMENT_TASK_NAME = "scan-assignment-task";
 
+const char* PushConsumerImpl::ADJUST_THREAD_POOL_TASK_NAME = "adjust-consume-thread-pool-task";
+
+const char* PushConsumerImpl::CONSUME_STATS_TASK_NAME = "consume-stats-task";
+
+const char* PushConsumerImpl::LAG_SAMPLE_TASK_NAME = "lag-sample-task";
+
+const std::chrono::seconds PushConsumerImpl::ASSIGNMENT_RESYNC_INTERVAL = std::chrono::seconds(30);
+
+const char* PushConsumerImpl::RENEW_INVISIBLE_DURATION_TASK_NAME = "renew-invisible-duration-task";
+
 void PushConsumerImpl::shutdown() {
   State expecting = State::STARTED;
   if (state_.compare_exchange_strong(expecting, State::STOPPING)) {
@@ -94,11 +248,40 @@ void PushConsumerImpl::shutdown() {
       SPDLOG_DEBUG("Scan assignment periodic task cancelled");
     }
 
+    // Receiving has stopped now that the consumer is no longer active. Release what is not yet consumed and let
+    // in-flight listener calls and acknowledgements complete before tearing down.
+    drain();
+
+    if (adjust_thread_pool_handle_) {
+      client_manager_->getScheduler()->cancel(adjust_thread_pool_handle_);
+      SPDLOG_DEBUG("Adjust consume thread pool periodic task cancelled");
+    }
+
+    if (consume_stats_handle_) {
+      client_manager_->getScheduler()->cancel(consume_stats_handle_);
+      SPDLOG_DEBUG("Consume stats periodic task cancelled");
+    }
+
+    if (renew_invisible_duration_handle_) {
+      client_manager_->getScheduler()->cancel(renew_invisible_duration_handle_);
+      SPDLOG_DEBUG("Renew invisible duration periodic task cancelled");
+    }
+
+    if (lag_sample_handle_) {
+      client_manager_->getScheduler()->cancel(lag_sample_handle_);
+      SPDLOG_DEBUG("Lag sample periodic task cancelled");
+    }
+
     {
       absl::MutexLock lock(&process_queue_table_mtx_);
       process_queue_table_.clear();
     }
 
+    {
+      absl::MutexLock lk(&applied_assignments_mtx_);
+      applied_assignments_.clear();
+    }
+
     if (consume_message_service_) {
       consume_message_service_->shutdown();
     }
@@ -121,8 +304,12 @@ void PushConsumerImpl::subscribe(const std::string& topic, const std::string& ex
 }
 
 void PushConsumerImpl::unsubscribe(const std::string& topic) {
-  absl::MutexLock lock(&topic_filter_expression_table_mtx_);
-  topic_filter_expression_table_.erase(topic);
+  {
+    absl::MutexLock lock(&topic_filter_expression_table_mtx_);
+    topic_filter_expression_table_.erase(topic);
+  }
+  absl::MutexLock lk(&applied_assignments_mtx_);
+  applied_assignments_.erase(topic);
 }
 
 absl::optional<FilterExpression> PushConsumerImpl::getFilterExpression(const std::string& topic) const {
@@ -147,22 +334,26 @@ void PushConsumerImpl::scanAssignments() {
     return;
   }
 
+  // Callbacks may run synchronously once routes are cached; do not hold the subscription table lock over them.
+  std::vector<std::pair<std::string, FilterExpression>> subscriptions;
   {
     absl::MutexLock lk(&topic_filter_expression_table_mtx_);
-    for (auto& entry : topic_filter_expression_table_) {
-      std::string topic = entry.first;
-      const auto& filter_expression = entry.second;
-      SPDLOG_DEBUG("Scan assignments for {}", topic);
-      auto callback = [this, topic, filter_expression](const std::error_code& ec,
-                                                       const TopicAssignmentPtr& assignments) {
-        if (ec) {
-          SPDLOG_WARN("Failed to acquire assignments for topic={} from load balancer. Cause: {}", topic, ec.message());
-        } else if (assignments && !assignments->assignmentList().empty()) {
-          syncProcessQueue(topic, assignments, filter_expression);
-        }
-      };
-      queryAssignment(topic, callback);
-    } // end of for-loop
+    subscriptions.insert(subscriptions.end(), topic_filter_expression_table_.begin(),
+                         topic_filter_expression_table_.end());
+  }
+
+  for (const auto& entry : subscriptions) {
+    const std::string& topic = entry.first;
+    const auto& filter_expression = entry.second;
+    SPDLOG_DEBUG("Scan assignments for {}", topic);
+    auto callback = [this, topic, filter_expression](const std::error_code& ec, const TopicAssignmentPtr& assignments) {
+      if (ec) {
+        SPDLOG_WARN("Failed to acquire assignments for topic={} from load balancer. Cause: {}", topic, ec.message());
+      } else if (assignments && !assignments->assignmentList().empty()) {
+        syncProcessQueue(topic, assignments, filter_expression);
+      }
+    };
+    queryAssignment(topic, callback);
   }
   SPDLOG_DEBUG("End of assignment scanning.");
 }
@@ -204,6 +395,7 @@ void PushConsumerImpl::queryAssignment(
       if (ec) {
         SPDLOG_WARN("Failed to get valid route entries for topic={}. Cause: {}", topic, ec.message());
         cb(ec, topic_assignment);
+        return;
       }
 
       std::vector<Assignment> assignments;
@@ -226,7 +418,7 @@ void PushConsumerImpl::queryAssignment(
     wrapQueryAssignmentRequest(topic, group_name_, clientId(), MixAll::DEFAULT_LOAD_BALANCER_STRATEGY_NAME_, request);
     SPDLOG_DEBUG("QueryAssignmentRequest: {}", request.DebugString());
 
-    absl::flat_hash_map<std::string, std::string> metadata;
+    Metadata metadata;
     Signature::sign(this, metadata);
     auto assignment_callback = [this, cb, topic, broker_host](const std::error_code& ec,
                                                               const QueryAssignmentResponse& response) {
@@ -256,6 +448,17 @@ void PushConsumerImpl::queryAssignment(
 void PushConsumerImpl::syncProcessQueue(const std::string& topic,
                                         const std::shared_ptr<TopicAssignment>& topic_assignment,
                                         const FilterExpression& filter_expression) {
+  auto now = std::chrono::steady_clock::now();
+  {
+    absl::MutexLock lk(&applied_assignments_mtx_);
+    auto search = applied_assignments_.find(topic);
+    if (applied_assignments_.end() != search && *search->second.assignment == *topic_assignment &&
+        now - search->second.synced_at < ASSIGNMENT_RESYNC_INTERVAL) {
+      SPDLOG_DEBUG("Assignment of topic={} remains unchanged", topic);
+      return;
+    }
+  }
+
   const std::vector<Assignment>& assignment_list = topic_assignment->assignmentList();
   std::vector<MQMessageQueue> message_queue_list;
   message_queue_list.reserve(assignment_list.size());
@@ -290,19 +493,28 @@ void PushConsumerImpl::syncProcessQueue(const std::string& topic,
     }
   }
 
+  bool synced = true;
   for (const auto& message_queue : message_queue_list) {
     if (std::none_of(current.cbegin(), current.cend(),
                      [&](const MQMessageQueue& item) { return item == message_queue; })) {
       SPDLOG_INFO("Start to receive message from {} according to latest assignment info from load balancer",
                   message_queue.simpleName());
       if (!receiveMessage(message_queue, filter_expression)) {
+        synced = false;
         if (!active()) {
           SPDLOG_WARN("Failed to initiate receive message request-response-cycle for {}", message_queue.simpleName());
-          // TODO: remove it from current assignment such that a second attempt will be made again in the next round.
         }
       }
     }
   }
+
+  // Leave a partially applied assignment unrecorded such that the next round makes a second attempt.
+  absl::MutexLock lk(&applied_assignments_mtx_);
+  if (synced) {
+    applied_assignments_[topic] = AppliedAssignment{topic_assignment, now};
+  } else {
+    applied_assignments_.erase(topic);
+  }
 }
 
 ProcessQueueSharedPtr PushConsumerImpl::getOrCreateProcessQueue(const MQMessageQueue& message_queue,
@@ -322,6 +534,9 @@ ProcessQueueSharedPtr PushConsumerImpl::getOrCreateProcessQueue(const MQMessageQ
       // create ProcessQueue
       process_queue =
           std::make_shared<ProcessQueueImpl>(message_queue, filter_expression, shared_from_this(), client_manager_);
+      if (paused(message_queue)) {
+        process_queue->pause();
+      }
       std::shared_ptr<AsyncReceiveMessageCallback> receive_callback =
           std::make_shared<AsyncReceiveMessageCallback>(process_queue);
       process_queue->callback(receive_callback);
@@ -343,6 +558,11 @@ bool PushConsumerImpl::receiveMessage(const MQMessageQueue& message_queue, const
     return false;
   }
 
+  if (process_queue_ptr->park()) {
+    SPDLOG_INFO("{} is paused. Defer receiving messages until it is resumed", message_queue.simpleName());
+    return true;
+  }
+
   const std::string& broker_host = message_queue.serviceAddress();
   if (broker_host.empty()) {
     SPDLOG_ERROR("Failed to resolve address for brokerName={}", message_queue.getBrokerName());
@@ -360,7 +580,7 @@ bool PushConsumerImpl::receiveMessage(const MQMessageQueue& message_queue, const
         request.mutable_partition()->set_id(message_queue.getQueueId());
         request.mutable_partition()->mutable_broker()->set_name(message_queue.getBrokerName());
         request.set_policy(rmq::QueryOffsetPolicy::END);
-        absl::flat_hash_map<std::string, std::string> metadata;
+        Metadata metadata;
         Signature::sign(this, metadata);
         auto callback = [broker_host, message_queue, process_queue_ptr](const std::error_code& ec,
                                                                         const QueryOffsetResponse& response) {
@@ -387,6 +607,112 @@ bool PushConsumerImpl::receiveMessage(const MQMessageQueue& message_queue, const
   return true;
 }
 
+void PushConsumerImpl::pause(const std::string& topic) {
+  {
+    absl::MutexLock lk(&paused_table_mtx_);
+    paused_topics_.insert(topic);
+  }
+  SPDLOG_INFO("Pause receiving messages of topic={}", topic);
+  syncPauseState(topic);
+}
+
+void PushConsumerImpl::pause(const MQMessageQueue& message_queue) {
+  {
+    absl::MutexLock lk(&paused_table_mtx_);
+    paused_queues_.insert(message_queue);
+  }
+  SPDLOG_INFO("Pause receiving messages from {}", message_queue.simpleName());
+  syncPauseState(message_queue.getTopic());
+}
+
+void PushConsumerImpl::resume(const std::string& topic) {
+  {
+    absl::MutexLock lk(&paused_table_mtx_);
+    paused_topics_.erase(topic);
+    for (auto it = paused_queues_.begin(); it != paused_queues_.end();) {
+      if (it->getTopic() == topic) {
+        paused_queues_.erase(it++);
+      } else {
+        it++;
+      }
+    }
+  }
+  SPDLOG_INFO("Resume receiving messages of topic={}", topic);
+  syncPauseState(topic);
+}
+
+void PushConsumerImpl::resume(const MQMessageQueue& message_queue) {
+  {
+    absl::MutexLock lk(&paused_table_mtx_);
+    paused_queues_.erase(message_queue);
+  }
+  SPDLOG_INFO("Resume receiving messages from {}", message_queue.simpleName());
+  syncPauseState(message_queue.getTopic());
+}
+
+bool PushConsumerImpl::paused(const MQMessageQueue& message_queue) {
+  absl::MutexLock lk(&paused_table_mtx_);
+  return paused_topics_.contains(message_queue.getTopic()) || paused_queues_.contains(message_queue);
+}
+
+std::vector<QueueLag> PushConsumerImpl::queueLags() const {
+  if (!lag_sampler_) {
+    return {};
+  }
+  return lag_sampler_->queueLags();
+}
+
+void PushConsumerImpl::sampleLag() {
+  if (!lag_sampler_) {
+    return;
+  }
+
+  std::string stats;
+  lag_sampler_->reportAndReset(stats);
+  SPDLOG_INFO("{}", stats);
+
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions;
+  {
+    absl::MutexLock lk(&process_queue_table_mtx_);
+    for (const auto& item : process_queue_table_) {
+      std::int64_t next_offset = MessageModel::BROADCASTING == message_model_ ? item.second->nextOffset()
+                                                                              : item.second->receivedOffset();
+      if (next_offset >= 0) {
+        // Messages cached locally are pulled, yet not consumed.
+        std::int64_t cached = static_cast<std::int64_t>(item.second->cachedMessageQuantity());
+        next_offset = std::max<std::int64_t>(0, next_offset - cached);
+      }
+      positions.insert({item.first, next_offset});
+    }
+  }
+  lag_sampler_->sample(positions);
+}
+
+void PushConsumerImpl::syncPauseState(const std::string& topic) {
+  std::vector<ProcessQueueSharedPtr> parked;
+  {
+    absl::MutexLock lk(&process_queue_table_mtx_);
+    for (const auto& entry : process_queue_table_) {
+      if (entry.first.getTopic() != topic) {
+        continue;
+      }
+
+      const ProcessQueueSharedPtr& process_queue = entry.second;
+      if (paused(entry.first)) {
+        process_queue->pause();
+      } else if (process_queue->paused() && process_queue->resume()) {
+        parked.push_back(process_queue);
+      }
+    }
+  }
+
+  // Restart parked receive cycles straight away rather than on the next scan.
+  for (const auto& process_queue : parked) {
+    SPDLOG_DEBUG("Restart receive cycle of {}", process_queue->simpleName());
+    process_queue->callback()->checkThrottleThenReceive();
+  }
+}
+
 std::shared_ptr<ConsumeMessageService> PushConsumerImpl::getConsumeMessageService() {
   return consume_message_service_;
 }
@@ -398,15 +724,25 @@ void PushConsumerImpl::ack(const MQMessageExt& msg, const std::function<void(con
                msg.getTopic(), msg.getQueueId(), msg.getMsgId());
   AckMessageRequest request;
   wrapAckMessageRequest(msg, request);
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
-  client_manager_->ack(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_), callback);
+
+  std::weak_ptr<PushConsumerImpl> consumer(shared_from_this());
+  std::string message_id = msg.getMsgId();
+  auto cb = [consumer, message_id, callback](const std::error_code& ec) {
+    auto consumer_ptr = consumer.lock();
+    if (!ec && consumer_ptr) {
+      consumer_ptr->inflight_messages_.remove(message_id);
+    }
+    callback(ec);
+  };
+  client_manager_->ack(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_), cb);
 }
 
 void PushConsumerImpl::nack(const MQMessageExt& msg, const std::function<void(const std::error_code&)>& callback) {
   std::string target_host = MessageAccessor::targetEndpoint(msg);
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
 
   rmq::NackMessageRequest request;
@@ -418,19 +754,30 @@ void PushConsumerImpl::nack(const MQMessageExt& msg, const std::function<void(co
   request.mutable_topic()->set_resource_namespace(resource_namespace_);
   request.mutable_topic()->set_name(msg.getTopic());
   request.set_client_id(clientId());
-  request.set_receipt_handle(msg.receiptHandle());
+  std::string receipt_handle = msg.receiptHandle();
+  inflight_messages_.receiptHandle(msg.getMsgId(), receipt_handle);
+  request.set_receipt_handle(receipt_handle);
   request.set_message_id(msg.getMsgId());
   request.set_delivery_attempt(msg.getDeliveryAttempt() + 1);
   request.set_max_delivery_attempts(max_delivery_attempts_);
 
-  client_manager_->nack(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_), callback);
+  std::weak_ptr<PushConsumerImpl> consumer(shared_from_this());
+  std::string message_id = msg.getMsgId();
+  auto cb = [consumer, message_id, callback](const std::error_code& ec) {
+    auto consumer_ptr = consumer.lock();
+    if (!ec && consumer_ptr) {
+      consumer_ptr->inflight_messages_.remove(message_id);
+    }
+    callback(ec);
+  };
+  client_manager_->nack(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_), cb);
   SPDLOG_DEBUG("Send message nack to broker server[host={}]", target_host);
 }
 
 void PushConsumerImpl::forwardToDeadLetterQueue(const MQMessageExt& message, const std::function<void(bool)>& cb) {
   std::string target_host = MessageAccessor::targetEndpoint(message);
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(this, metadata);
 
   ForwardMessageToDeadLetterQueueRequest request;
@@ -446,6 +793,9 @@ void PushConsumerImpl::forwardToDeadLetterQueue(const MQMessageExt& message, con
   request.set_delivery_attempt(message.getDeliveryAttempt());
   request.set_max_delivery_attempts(max_delivery_attempts_);
 
+  // Once forwarded, the message no longer needs its invisible duration renewed.
+  inflight_messages_.remove(message.getMsgId());
+
   client_manager_->forwardMessageToDeadLetterQueue(target_host, metadata, request,
                                                    absl::ToChronoMilliseconds(io_timeout_), cb);
 }
@@ -457,7 +807,221 @@ void PushConsumerImpl::wrapAckMessageRequest(const MQMessageExt& msg, AckMessage
   request.mutable_topic()->set_name(msg.getTopic());
   request.set_client_id(clientId());
   request.set_message_id(msg.getMsgId());
-  request.set_receipt_handle(msg.receiptHandle());
+  std::string receipt_handle = msg.receiptHandle();
+  inflight_messages_.receiptHandle(msg.getMsgId(), receipt_handle);
+  request.set_receipt_handle(receipt_handle);
+}
+
+void PushConsumerImpl::invisibleDuration(std::chrono::milliseconds invisible_duration) {
+  if (invisible_duration.count() > 0) {
+    invisible_duration_ = invisible_duration;
+  }
+}
+
+void PushConsumerImpl::trackInflight(const std::vector<MQMessageExt>& messages) {
+  for (const auto& message : messages) {
+    InflightMessage inflight_message;
+    inflight_message.endpoint = MessageAccessor::targetEndpoint(message);
+    inflight_message.topic = message.getTopic();
+    inflight_message.message_id = message.getMsgId();
+    inflight_message.receipt_handle = message.receiptHandle();
+    inflight_message.deadline = invisibleDeadline(message);
+    inflight_messages_.add(std::move(inflight_message));
+  }
+}
+
+absl::Time PushConsumerImpl::invisibleDeadline(const MQMessageExt& message) {
+  absl::Time deadline;
+  if (inflight_messages_.deadline(message.getMsgId(), deadline)) {
+    return deadline;
+  }
+
+  absl::Duration invisible_period = MessageAccessor::invisiblePeriod(message);
+  if (invisible_period <= absl::ZeroDuration()) {
+    invisible_period = absl::FromChrono(invisible_duration_);
+  }
+  return MessageAccessor::decodedTimestamp(message) + invisible_period;
+}
+
+void PushConsumerImpl::renewInvisibleDuration() {
+  if (!renew_invisible_duration_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // Renew once a third of the invisible duration remains, leaving room for a couple of attempts.
+  absl::Duration invisible_duration = absl::FromChrono(invisible_duration_);
+  auto expiring = inflight_messages_.expiring(absl::Now() + invisible_duration / 3);
+
+  for (const auto& entry : expiring) {
+    const std::string& target_host = entry.first;
+
+    ChangeInvisibleDurationRequest request;
+    request.mutable_group()->set_resource_namespace(resource_namespace_);
+    request.mutable_group()->set_name(group_name_);
+    request.set_client_id(clientId());
+    request.mutable_invisible_duration()->set_seconds(absl::ToInt64Seconds(invisible_duration));
+    request.mutable_invisible_duration()->set_nanos(
+        static_cast<int32_t>(absl::ToInt64Nanoseconds(invisible_duration % absl::Seconds(1))));
+
+    std::vector<std::string> message_ids;
+    for (const auto& message : entry.second) {
+      auto item = request.add_entries();
+      item->mutable_topic()->set_resource_namespace(resource_namespace_);
+      item->mutable_topic()->set_name(message.topic);
+      item->set_receipt_handle(message.receipt_handle);
+      item->set_message_id(message.message_id);
+      message_ids.push_back(message.message_id);
+    }
+
+    Metadata metadata;
+    Signature::sign(this, metadata);
+
+    std::weak_ptr<PushConsumerImpl> consumer(shared_from_this());
+    absl::Time start = absl::Now();
+    auto callback = [consumer, message_ids, start, invisible_duration, target_host](
+                        const std::error_code& ec, const ChangeInvisibleDurationResponse& response) {
+      auto consumer_ptr = consumer.lock();
+      if (!consumer_ptr) {
+        return;
+      }
+
+      if (ec) {
+        if (ErrorCode::NotImplemented == ec) {
+          SPDLOG_WARN("Broker[host={}] does not support changing invisible duration. Stop renewing", target_host);
+          consumer_ptr->renew_invisible_duration_.store(false, std::memory_order_relaxed);
+        } else if (ErrorCode::NotFound == ec) {
+          // Some receipt handle of the batch is stale, failing the request as a whole. Retrying the same batch would
+          // fail forever, so these messages are left to be redelivered, just as entries that fail one by one.
+          SPDLOG_WARN("Stop renewing invisible duration of {} messages against {}. Cause: {}", message_ids.size(),
+                      target_host, ec.message());
+          for (const auto& message_id : message_ids) {
+            consumer_ptr->inflight_messages_.remove(message_id);
+          }
+          return;
+        } else {
+          SPDLOG_WARN("Failed to renew invisible duration of {} messages against {}. Cause: {}", message_ids.size(),
+                      target_host, ec.message());
+        }
+        for (const auto& message_id : message_ids) {
+          consumer_ptr->inflight_messages_.renewFailed(message_id);
+        }
+        return;
+      }
+
+      // Deadline is counted conservatively from when the request was sent.
+      absl::Time deadline = start + invisible_duration;
+      for (const auto& item : response.entries()) {
+        if (google::rpc::Code::OK == item.status().code()) {
+          consumer_ptr->inflight_messages_.renewed(item.message_id(), item.receipt_handle(), deadline);
+        } else {
+          // Receipt handle is stale: the message has been redelivered already.
+          SPDLOG_WARN("Failed to renew invisible duration of message[message-id={}]. Cause: {}", item.message_id(),
+                      item.status().message());
+          consumer_ptr->inflight_messages_.remove(item.message_id());
+        }
+      }
+
+      // Messages left unanswered are picked up again by the next round.
+      for (const auto& message_id : message_ids) {
+        consumer_ptr->inflight_messages_.renewFailed(message_id);
+      }
+      SPDLOG_DEBUG("Renewed invisible duration of {} messages against {}", response.entries_size(), target_host);
+    };
+    client_manager_->changeInvisibleDuration(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_),
+                                             callback);
+  }
+}
+
+void PushConsumerImpl::release(const std::vector<MQMessageExt>& messages) {
+  absl::flat_hash_map<std::string, std::vector<const MQMessageExt*>> batches;
+  for (const auto& message : messages) {
+    batches[MessageAccessor::targetEndpoint(message)].push_back(&message);
+  }
+
+  for (const auto& batch : batches) {
+    const std::string& target_host = batch.first;
+
+    ChangeInvisibleDurationRequest request;
+    request.mutable_group()->set_resource_namespace(resource_namespace_);
+    request.mutable_group()->set_name(group_name_);
+    request.set_client_id(clientId());
+    // Zero invisible duration makes the messages visible to consumers of the group right away.
+    request.mutable_invisible_duration()->set_seconds(0);
+
+    for (const auto message : batch.second) {
+      std::string receipt_handle = message->receiptHandle();
+      inflight_messages_.receiptHandle(message->getMsgId(), receipt_handle);
+      // Released messages must no longer have their invisible duration renewed.
+      inflight_messages_.remove(message->getMsgId());
+
+      auto item = request.add_entries();
+      item->mutable_topic()->set_resource_namespace(resource_namespace_);
+      item->mutable_topic()->set_name(message->getTopic());
+      item->set_receipt_handle(receipt_handle);
+      item->set_message_id(message->getMsgId());
+    }
+
+    if (!renew_invisible_duration_.load(std::memory_order_relaxed)) {
+      // Broker cannot change invisible duration; messages are redelivered once it elapses.
+      continue;
+    }
+
+    Metadata metadata;
+    Signature::sign(this, metadata);
+
+    pending_releases_.fetch_add(1, std::memory_order_relaxed);
+    std::weak_ptr<PushConsumerImpl> consumer(shared_from_this());
+    auto callback = [consumer, target_host](const std::error_code& ec,
+                                            const ChangeInvisibleDurationResponse& response) {
+      auto consumer_ptr = consumer.lock();
+      if (!consumer_ptr) {
+        return;
+      }
+      consumer_ptr->pending_releases_.fetch_sub(1, std::memory_order_relaxed);
+
+      if (ec) {
+        SPDLOG_WARN("Failed to release messages to {}. Cause: {}", target_host, ec.message());
+        return;
+      }
+      SPDLOG_DEBUG("Released {} messages to {}", response.entries_size(), target_host);
+    };
+    client_manager_->changeInvisibleDuration(target_host, metadata, request, absl::ToChronoMilliseconds(io_timeout_),
+                                             callback);
+  }
+}
+
+void PushConsumerImpl::drainTimeout(std::chrono::milliseconds drain_timeout) {
+  if (drain_timeout.count() >= 0) {
+    drain_timeout_ = drain_timeout;
+  }
+}
+
+void PushConsumerImpl::startupTimeout(std::chrono::milliseconds startup_timeout) {
+  if (startup_timeout.count() >= 0) {
+    startup_timeout_ = startup_timeout;
+  }
+}
+
+void PushConsumerImpl::drain() {
+  if (!consume_message_service_ || drain_timeout_.count() <= 0) {
+    return;
+  }
+
+  consume_message_service_->drain();
+
+  absl::Time deadline = absl::Now() + absl::FromChrono(drain_timeout_);
+  while (absl::Now() < deadline) {
+    if (consume_message_service_->idle() && !inflight_messages_.size() &&
+        !pending_releases_.load(std::memory_order_relaxed)) {
+      SPDLOG_INFO("PushConsumer[group={}] drained", group_name_);
+      return;
+    }
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+
+  SPDLOG_WARN("PushConsumer[group={}] failed to drain in {}ms. {} messages left in flight will be redelivered once "
+              "their invisible duration elapses",
+              group_name_, drain_timeout_.count(), inflight_messages_.size());
 }
 
 uint32_t PushConsumerImpl::consumeThreadPoolSize() const {
@@ -470,6 +1034,30 @@ void PushConsumerImpl::consumeThreadPoolSize(int thread_pool_size) {
   }
 }
 
+uint32_t PushConsumerImpl::maxConsumeThreadPoolSize() const {
+  return std::max(consume_thread_pool_size_, max_consume_thread_pool_size_);
+}
+
+void PushConsumerImpl::maxConsumeThreadPoolSize(int max_thread_pool_size) {
+  if (max_thread_pool_size >= 1) {
+    max_consume_thread_pool_size_ = max_thread_pool_size;
+  }
+}
+
+void PushConsumerImpl::consumeRetryPolicy(uint32_t max_local_attempts, std::chrono::milliseconds initial_backoff) {
+  consume_retry_policy_.max_local_attempts = max_local_attempts;
+  if (initial_backoff.count() > 0) {
+    consume_retry_policy_.initial_backoff = initial_backoff;
+  }
+}
+
+void PushConsumerImpl::deduplication(std::chrono::milliseconds window, std::size_t capacity,
+                                     DuplicateAction action) {
+  deduplication_window_ = window;
+  deduplication_capacity_ = capacity;
+  duplicate_action_ = action;
+}
+
 uint32_t PushConsumerImpl::consumeBatchSize() const {
   return consume_batch_size_;
 }
@@ -495,43 +1083,6 @@ std::size_t PushConsumerImpl::getProcessQueueTableSize() {
   return process_queue_table_.size();
 }
 
-void PushConsumerImpl::fetchRoutes() {
-  std::vector<std::string> topics;
-  {
-    absl::MutexLock lk(&topic_filter_expression_table_mtx_);
-    for (const auto& item : topic_filter_expression_table_) {
-      topics.emplace_back(item.first);
-    }
-  }
-
-  if (topics.empty()) {
-    return;
-  }
-
-  std::vector<std::string>::size_type countdown = topics.size();
-  absl::Mutex mtx;
-  absl::CondVar cv;
-  int acquired = 0;
-  auto callback = [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
-    absl::MutexLock lk(&mtx);
-    countdown--;
-    cv.SignalAll();
-    if (!ec) {
-      acquired++;
-    }
-  };
-
-  for (const auto& topic : topics) {
-    getRouteFor(topic, callback);
-  }
-
-  while (countdown) {
-    absl::MutexLock lk(&mtx);
-    cv.Wait(&mtx);
-  }
-  SPDLOG_INFO("Fetched route for {} out of {} topics", acquired, topics.size());
-}
-
 void PushConsumerImpl::prepareHeartbeatData(HeartbeatRequest& request) {
   request.set_client_id(clientId());
 
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RouteCache.h"
+
+#include <utility>
+
+#include "LoggerImpl.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+RouteCache& RouteCache::instance() {
+  // Leaked on purpose: clients may still be completing route queries during static destruction.
+  static RouteCache* cache = new RouteCache();
+  return *cache;
+}
+
+std::uint64_t RouteCache::subscribe(const RouteKey& key, Listener listener) {
+  absl::MutexLock lk(&mtx_);
+  std::uint64_t id = ++next_subscription_id_;
+  entries_[key].listeners.insert({id, std::move(listener)});
+  return id;
+}
+
+void RouteCache::unsubscribe(const RouteKey& key, std::uint64_t id) {
+  absl::MutexLock lk(&mtx_);
+  auto search = entries_.find(key);
+  if (entries_.end() == search) {
+    return;
+  }
+  Entry& entry = search->second;
+  entry.listeners.erase(id);
+  if (entry.listeners.empty() && !entry.fetching) {
+    SPDLOG_DEBUG("Evict route of topic={} from cache as it has no more subscribers", key.topic);
+    entries_.erase(search);
+  }
+}
+
+void RouteCache::getRoute(const RouteKey& key, const Fetcher& fetcher, const Callback& callback,
+                          absl::Duration timeout) {
+  TopicRouteDataPtr route;
+  bool query = false;
+  {
+    absl::MutexLock lk(&mtx_);
+    Entry& entry = entries_[key];
+    if (entry.route) {
+      route = entry.route;
+    } else {
+      entry.callbacks.push_back(callback);
+      absl::Time now = absl::Now();
+      if (!entry.fetching || now - entry.fetch_started_at > timeout) {
+        entry.fetching = true;
+        entry.fetch_started_at = now;
+        query = true;
+      } else {
+        SPDLOG_DEBUG("Would reuse prior route request for topic={}", key.topic);
+      }
+    }
+  }
+
+  if (route) {
+    std::error_code ec;
+    callback(ec, route);
+    return;
+  }
+
+  if (query) {
+    fetch(key, fetcher);
+  }
+}
+
+void RouteCache::refresh(const RouteKey& key, const Fetcher& fetcher, absl::Duration max_age,
+                         absl::Duration timeout) {
+  {
+    absl::MutexLock lk(&mtx_);
+    auto search = entries_.find(key);
+    if (entries_.end() == search) {
+      return;
+    }
+    Entry& entry = search->second;
+    absl::Time now = absl::Now();
+    if (now - entry.fetched_at < max_age) {
+      return;
+    }
+    if (entry.fetching && now - entry.fetch_started_at <= timeout) {
+      return;
+    }
+    entry.fetching = true;
+    entry.fetch_started_at = now;
+  }
+  fetch(key, fetcher);
+}
+
+TopicRouteDataPtr RouteCache::route(const RouteKey& key) const {
+  absl::MutexLock lk(&mtx_);
+  auto search = entries_.find(key);
+  if (entries_.end() == search) {
+    return nullptr;
+  }
+  return search->second.route;
+}
+
+std::size_t RouteCache::subscribers(const RouteKey& key) const {
+  absl::MutexLock lk(&mtx_);
+  auto search = entries_.find(key);
+  if (entries_.end() == search) {
+    return 0;
+  }
+  return search->second.listeners.size();
+}
+
+void RouteCache::fetch(const RouteKey& key, const Fetcher& fetcher) {
+  SPDLOG_DEBUG("Query route of topic={} from {}", key.topic, key.access_point);
+  fetcher([this, key](const std::error_code& ec, const TopicRouteDataPtr& route) { onRouteFetched(key, ec, route); });
+}
+
+void RouteCache::onRouteFetched(const RouteKey& key, const std::error_code& ec, const TopicRouteDataPtr& route) {
+  std::vector<Callback> callbacks;
+  std::vector<Listener> listeners;
+  TopicRouteDataPtr result = route;
+  {
+    absl::MutexLock lk(&mtx_);
+    auto search = entries_.find(key);
+    if (entries_.end() == search) {
+      return;
+    }
+    Entry& entry = search->second;
+    entry.fetching = false;
+    callbacks.swap(entry.callbacks);
+
+    bool valid = !ec && route && !route->partitions().empty();
+    if (valid) {
+      entry.fetched_at = absl::Now();
+      if (!entry.route || *entry.route != *route) {
+        entry.route = route;
+        for (const auto& item : entry.listeners) {
+          listeners.push_back(item.second);
+        }
+      }
+      result = entry.route;
+    }
+
+    if (entry.listeners.empty()) {
+      entries_.erase(search);
+    }
+  }
+
+  for (const auto& listener : listeners) {
+    listener(result);
+  }
+
+  for (const auto& callback : callbacks) {
+    callback(ec, result);
+  }
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -40,24 +40,17 @@ OnewaySendCallback* onewaySendCallback() {
 }
 
 void AwaitSendCallback::await() {
-  absl::MutexLock lk(&mtx_);
-  while (!completed_) {
-    cv_.Wait(&mtx_);
-  }
+  latch_.await();
 }
 
 void AwaitSendCallback::onSuccess(SendResult& send_result) noexcept {
   send_result_ = send_result;
-  completed_ = true;
-  absl::MutexLock lk(&mtx_);
-  cv_.SignalAll();
+  latch_.countdown();
 }
 
 void AwaitSendCallback::onFailure(const std::error_code& ec) noexcept {
-  completed_ = true;
   ec_ = ec;
-  absl::MutexLock lk(&mtx_);
-  cv_.SignalAll();
+  latch_.countdown();
 }
 
 void RetrySendCallback::onSuccess(SendResult& send_result) noexcept {
@@ -86,6 +79,14 @@ void RetrySendCallback::onFailure(const std::error_code& ec) noexcept {
     return;
   }
 
+  if (remaining() <= absl::ZeroDuration()) {
+    SPDLOG_WARN("Send budget exhausted after {} attempt(s)", attempt_times_);
+    std::error_code timeout = ErrorCode::RequestTimeout;
+    callback_->onFailure(timeout);
+    delete this;
+    return;
+  }
+
   std::shared_ptr<ProducerImpl> producer = producer_.lock();
   if (!producer) {
     SPDLOG_WARN("Producer has been destructed");
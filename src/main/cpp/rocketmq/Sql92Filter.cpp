@@ -0,0 +1,812 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Sql92Filter.h"
+
+#include <cctype>
+#include <limits>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "fmt/format.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+namespace {
+
+enum class TokenType : std::uint8_t
+{
+  End,
+  Identifier,
+  String,
+  Long,
+  Double,
+  LeftParenthesis,
+  RightParenthesis,
+  Comma,
+  Minus,
+  Equal,
+  NotEqual,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual,
+  And,
+  Or,
+  Not,
+  Is,
+  Null,
+  Between,
+  In,
+  True,
+  False,
+};
+
+struct Token {
+  TokenType type{TokenType::End};
+  std::string text;
+  std::int64_t long_value{0};
+  double double_value{0};
+  std::size_t position{0};
+};
+
+bool isIdentifierStart(char c) {
+  return std::isalpha(static_cast<unsigned char>(c)) || '_' == c || '$' == c;
+}
+
+bool isIdentifierPart(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || '_' == c || '$' == c || '.' == c;
+}
+
+class Lexer {
+public:
+  explicit Lexer(absl::string_view expression) : expression_(expression) {
+  }
+
+  bool tokenize(std::vector<Token>& tokens, std::string& error) {
+    while (true) {
+      while (pos_ < expression_.size() && absl::ascii_isspace(expression_[pos_])) {
+        pos_++;
+      }
+
+      Token token;
+      token.position = pos_;
+      if (pos_ >= expression_.size()) {
+        tokens.push_back(token);
+        return true;
+      }
+
+      char c = expression_[pos_];
+      if (isIdentifierStart(c)) {
+        std::size_t begin = pos_;
+        while (pos_ < expression_.size() && isIdentifierPart(expression_[pos_])) {
+          pos_++;
+        }
+        token.text = std::string(expression_.substr(begin, pos_ - begin));
+        token.type = keyword(token.text);
+      } else if (std::isdigit(static_cast<unsigned char>(c))) {
+        if (!number(token, error)) {
+          return false;
+        }
+      } else if ('\'' == c) {
+        if (!string(token, error)) {
+          return false;
+        }
+      } else {
+        pos_++;
+        switch (c) {
+          case '(':
+            token.type = TokenType::LeftParenthesis;
+            break;
+          case ')':
+            token.type = TokenType::RightParenthesis;
+            break;
+          case ',':
+            token.type = TokenType::Comma;
+            break;
+          case '-':
+            token.type = TokenType::Minus;
+            break;
+          case '=':
+            token.type = TokenType::Equal;
+            break;
+          case '<':
+            token.type = TokenType::Less;
+            if (accept('=')) {
+              token.type = TokenType::LessEqual;
+            } else if (accept('>')) {
+              token.type = TokenType::NotEqual;
+            }
+            break;
+          case '>':
+            token.type = accept('=') ? TokenType::GreaterEqual : TokenType::Greater;
+            break;
+          case '!':
+            if (accept('=')) {
+              token.type = TokenType::NotEqual;
+              break;
+            }
+            error = fmt::format("Unexpected character '!' at {}", token.position);
+            return false;
+          default:
+            error = fmt::format("Unexpected character '{}' at {}", c, token.position);
+            return false;
+        }
+      }
+      tokens.push_back(std::move(token));
+    }
+  }
+
+private:
+  absl::string_view expression_;
+  std::size_t pos_{0};
+
+  bool accept(char c) {
+    if (pos_ < expression_.size() && c == expression_[pos_]) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  static TokenType keyword(const std::string& text) {
+    static const struct {
+      const char* text;
+      TokenType type;
+    } keywords[] = {
+        {"AND", TokenType::And},         {"OR", TokenType::Or},     {"NOT", TokenType::Not},
+        {"IS", TokenType::Is},           {"NULL", TokenType::Null}, {"BETWEEN", TokenType::Between},
+        {"IN", TokenType::In},           {"TRUE", TokenType::True}, {"FALSE", TokenType::False},
+    };
+    for (const auto& item : keywords) {
+      if (absl::EqualsIgnoreCase(text, item.text)) {
+        return item.type;
+      }
+    }
+    return TokenType::Identifier;
+  }
+
+  bool number(Token& token, std::string& error) {
+    std::size_t begin = pos_;
+    bool floating = false;
+    while (pos_ < expression_.size()) {
+      char c = expression_[pos_];
+      if (std::isdigit(static_cast<unsigned char>(c))) {
+        pos_++;
+      } else if ('.' == c || 'e' == c || 'E' == c) {
+        floating = true;
+        pos_++;
+        if (('e' == c || 'E' == c) && pos_ < expression_.size() &&
+            ('+' == expression_[pos_] || '-' == expression_[pos_])) {
+          pos_++;
+        }
+      } else {
+        break;
+      }
+    }
+    absl::string_view text = expression_.substr(begin, pos_ - begin);
+
+    // Optional suffix of long literals
+    if (!floating) {
+      accept('L') || accept('l');
+    }
+
+    if (!floating && absl::SimpleAtoi(text, &token.long_value)) {
+      token.type = TokenType::Long;
+      return true;
+    }
+
+    if (absl::SimpleAtod(text, &token.double_value)) {
+      token.type = TokenType::Double;
+      return true;
+    }
+    error = fmt::format("Malformed number '{}' at {}", std::string(text), begin);
+    return false;
+  }
+
+  bool string(Token& token, std::string& error) {
+    std::size_t begin = pos_++;
+    while (pos_ < expression_.size()) {
+      char c = expression_[pos_++];
+      if ('\'' == c) {
+        // Two consecutive quotes stand for one quote.
+        if (accept('\'')) {
+          token.text.push_back('\'');
+          continue;
+        }
+        token.type = TokenType::String;
+        return true;
+      }
+      token.text.push_back(c);
+    }
+    error = fmt::format("Unterminated string literal at {}", begin);
+    return false;
+  }
+};
+
+} // namespace
+
+/**
+ * @brief Recursive-descent parser emitting bytecode of Sql92Filter.
+ */
+class Sql92Compiler {
+public:
+  Sql92Compiler(std::vector<Token> tokens, Sql92Filter& filter) : tokens_(std::move(tokens)), filter_(filter) {
+  }
+
+  bool compile(std::string& error) {
+    if (!orExpression()) {
+      error = error_;
+      return false;
+    }
+
+    if (TokenType::End != peek().type) {
+      error = fmt::format("Unexpected token at {}", peek().position);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  std::vector<Token> tokens_;
+  std::size_t current_{0};
+  Sql92Filter& filter_;
+  std::int64_t depth_{0};
+  std::string error_;
+
+  const Token& peek() const {
+    return tokens_[current_];
+  }
+
+  bool accept(TokenType type) {
+    if (type == tokens_[current_].type) {
+      if (TokenType::End != type) {
+        current_++;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool fail(const char* expected) {
+    if (error_.empty()) {
+      error_ = fmt::format("Expecting {} at {}", expected, peek().position);
+    }
+    return false;
+  }
+
+  void emit(Sql92Filter::OpCode op_code, std::uint32_t operand, int stack_delta) {
+    filter_.instructions_.push_back({op_code, operand});
+    depth_ += stack_delta;
+    if (static_cast<std::size_t>(depth_) > filter_.max_stack_depth_) {
+      filter_.max_stack_depth_ = static_cast<std::size_t>(depth_);
+    }
+  }
+
+  void pushConstant(const Sql92Filter::Value& value) {
+    filter_.constants_.push_back(value);
+    emit(Sql92Filter::OpCode::PushConstant, filter_.constants_.size() - 1, 1);
+  }
+
+  const std::string* intern(const std::string& text) {
+    filter_.strings_.emplace_back(new std::string(text));
+    return filter_.strings_.back().get();
+  }
+
+  bool orExpression() {
+    if (!andExpression()) {
+      return false;
+    }
+    while (accept(TokenType::Or)) {
+      std::size_t jump = filter_.instructions_.size();
+      emit(Sql92Filter::OpCode::JumpIfTrue, 0, 0);
+      if (!andExpression()) {
+        return false;
+      }
+      emit(Sql92Filter::OpCode::Or, 0, -1);
+      filter_.instructions_[jump].operand = filter_.instructions_.size();
+    }
+    return true;
+  }
+
+  bool andExpression() {
+    if (!notExpression()) {
+      return false;
+    }
+    while (accept(TokenType::And)) {
+      std::size_t jump = filter_.instructions_.size();
+      emit(Sql92Filter::OpCode::JumpIfFalse, 0, 0);
+      if (!notExpression()) {
+        return false;
+      }
+      emit(Sql92Filter::OpCode::And, 0, -1);
+      filter_.instructions_[jump].operand = filter_.instructions_.size();
+    }
+    return true;
+  }
+
+  bool notExpression() {
+    if (accept(TokenType::Not)) {
+      if (!notExpression()) {
+        return false;
+      }
+      emit(Sql92Filter::OpCode::Not, 0, 0);
+      return true;
+    }
+    return predicate();
+  }
+
+  bool predicate() {
+    if (!operand()) {
+      return false;
+    }
+
+    Sql92Filter::OpCode op_code;
+    switch (peek().type) {
+      case TokenType::Equal:
+        op_code = Sql92Filter::OpCode::Equal;
+        break;
+      case TokenType::NotEqual:
+        op_code = Sql92Filter::OpCode::NotEqual;
+        break;
+      case TokenType::Less:
+        op_code = Sql92Filter::OpCode::Less;
+        break;
+      case TokenType::LessEqual:
+        op_code = Sql92Filter::OpCode::LessEqual;
+        break;
+      case TokenType::Greater:
+        op_code = Sql92Filter::OpCode::Greater;
+        break;
+      case TokenType::GreaterEqual:
+        op_code = Sql92Filter::OpCode::GreaterEqual;
+        break;
+
+      case TokenType::Is: {
+        current_++;
+        bool negative = accept(TokenType::Not);
+        if (!accept(TokenType::Null)) {
+          return fail("NULL");
+        }
+        emit(negative ? Sql92Filter::OpCode::IsNotNull : Sql92Filter::OpCode::IsNull, 0, 0);
+        return true;
+      }
+
+      case TokenType::Not: {
+        current_++;
+        if (TokenType::Between == peek().type) {
+          return between(true);
+        }
+        if (TokenType::In == peek().type) {
+          return in(true);
+        }
+        return fail("BETWEEN or IN");
+      }
+
+      case TokenType::Between:
+        return between(false);
+
+      case TokenType::In:
+        return in(false);
+
+      default:
+        return true;
+    }
+
+    current_++;
+    if (!operand()) {
+      return false;
+    }
+    emit(op_code, 0, -1);
+    return true;
+  }
+
+  bool between(bool negative) {
+    accept(TokenType::Between);
+    if (!operand()) {
+      return false;
+    }
+    if (!accept(TokenType::And)) {
+      return fail("AND");
+    }
+    if (!operand()) {
+      return false;
+    }
+    emit(negative ? Sql92Filter::OpCode::NotBetween : Sql92Filter::OpCode::Between, 0, -2);
+    return true;
+  }
+
+  bool in(bool negative) {
+    accept(TokenType::In);
+    if (!accept(TokenType::LeftParenthesis)) {
+      return fail("(");
+    }
+
+    absl::flat_hash_set<std::string> set;
+    do {
+      if (TokenType::String != peek().type) {
+        return fail("string literal");
+      }
+      set.insert(peek().text);
+      current_++;
+    } while (accept(TokenType::Comma));
+
+    if (!accept(TokenType::RightParenthesis)) {
+      return fail(")");
+    }
+
+    filter_.sets_.push_back(std::move(set));
+    emit(negative ? Sql92Filter::OpCode::NotIn : Sql92Filter::OpCode::In, filter_.sets_.size() - 1, 0);
+    return true;
+  }
+
+  bool operand() {
+    const Token& token = peek();
+    Sql92Filter::Value value;
+    switch (token.type) {
+      case TokenType::Identifier: {
+        current_++;
+        if ("TAGS" == token.text) {
+          emit(Sql92Filter::OpCode::LoadTag, 0, 1);
+          return true;
+        }
+
+        std::uint32_t index = 0;
+        while (index < filter_.properties_.size() && filter_.properties_[index] != token.text) {
+          index++;
+        }
+        if (index == filter_.properties_.size()) {
+          filter_.properties_.push_back(token.text);
+        }
+        emit(Sql92Filter::OpCode::LoadProperty, index, 1);
+        return true;
+      }
+
+      case TokenType::String: {
+        value.type = Sql92Filter::ValueType::String;
+        value.string = intern(token.text);
+        current_++;
+        pushConstant(value);
+        return true;
+      }
+
+      case TokenType::Minus:
+      case TokenType::Long:
+      case TokenType::Double: {
+        bool negative = accept(TokenType::Minus);
+        const Token& number = peek();
+        if (TokenType::Long == number.type) {
+          value.type = Sql92Filter::ValueType::Long;
+          value.long_value = negative ? -number.long_value : number.long_value;
+        } else if (TokenType::Double == number.type) {
+          value.type = Sql92Filter::ValueType::Double;
+          value.double_value = negative ? -number.double_value : number.double_value;
+        } else {
+          return fail("number");
+        }
+        current_++;
+        pushConstant(value);
+        return true;
+      }
+
+      case TokenType::True:
+      case TokenType::False: {
+        value.type = Sql92Filter::ValueType::Boolean;
+        value.boolean = TokenType::True == token.type;
+        current_++;
+        pushConstant(value);
+        return true;
+      }
+
+      case TokenType::LeftParenthesis: {
+        current_++;
+        if (!orExpression()) {
+          return false;
+        }
+        if (!accept(TokenType::RightParenthesis)) {
+          return fail(")");
+        }
+        return true;
+      }
+
+      default:
+        return fail("operand");
+    }
+  }
+};
+
+std::unique_ptr<Sql92Filter> Sql92Filter::compile(const std::string& expression, std::string& error) {
+  std::vector<Token> tokens;
+  Lexer lexer(expression);
+  if (!lexer.tokenize(tokens, error)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<Sql92Filter> filter(new Sql92Filter());
+  Sql92Compiler compiler(std::move(tokens), *filter);
+  if (!compiler.compile(error)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+namespace {
+
+using Value = Sql92Filter::Value;
+using ValueType = Sql92Filter::ValueType;
+using OpCode = Sql92Filter::OpCode;
+
+Value nullValue() {
+  return Value();
+}
+
+Value booleanValue(bool b) {
+  Value value;
+  value.type = ValueType::Boolean;
+  value.boolean = b;
+  return value;
+}
+
+/**
+ * @brief Coerce the given value into a number. Property values are strings on the wire, thus parsed on demand.
+ */
+bool numeric(const Value& value, Value& result) {
+  switch (value.type) {
+    case ValueType::Long:
+    case ValueType::Double:
+      result = value;
+      return true;
+    case ValueType::String: {
+      if (absl::SimpleAtoi(*value.string, &result.long_value)) {
+        result.type = ValueType::Long;
+        return true;
+      }
+      if (absl::SimpleAtod(*value.string, &result.double_value)) {
+        result.type = ValueType::Double;
+        return true;
+      }
+      return false;
+    }
+    default:
+      return false;
+  }
+}
+
+bool boolean(const Value& value, bool& result) {
+  if (ValueType::Boolean == value.type) {
+    result = value.boolean;
+    return true;
+  }
+
+  if (ValueType::String == value.type) {
+    if (absl::EqualsIgnoreCase(*value.string, "true")) {
+      result = true;
+      return true;
+    }
+    if (absl::EqualsIgnoreCase(*value.string, "false")) {
+      result = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+Value compare(T lhs, T rhs, OpCode op_code) {
+  switch (op_code) {
+    case OpCode::Equal:
+      return booleanValue(lhs == rhs);
+    case OpCode::NotEqual:
+      return booleanValue(lhs != rhs);
+    case OpCode::Less:
+      return booleanValue(lhs < rhs);
+    case OpCode::LessEqual:
+      return booleanValue(lhs <= rhs);
+    case OpCode::Greater:
+      return booleanValue(lhs > rhs);
+    case OpCode::GreaterEqual:
+      return booleanValue(lhs >= rhs);
+    default:
+      return nullValue();
+  }
+}
+
+Value compare(const Value& lhs, const Value& rhs, OpCode op_code) {
+  if (ValueType::Null == lhs.type || ValueType::Null == rhs.type) {
+    return nullValue();
+  }
+
+  bool equality = OpCode::Equal == op_code || OpCode::NotEqual == op_code;
+
+  if (ValueType::String == lhs.type && ValueType::String == rhs.type) {
+    // Strings are only comparable for equality.
+    return equality ? compare(absl::string_view(*lhs.string), absl::string_view(*rhs.string), op_code) : nullValue();
+  }
+
+  if (ValueType::Boolean == lhs.type || ValueType::Boolean == rhs.type) {
+    bool l, r;
+    if (!equality || !boolean(lhs, l) || !boolean(rhs, r)) {
+      return nullValue();
+    }
+    return compare(l, r, op_code);
+  }
+
+  Value l, r;
+  if (!numeric(lhs, l) || !numeric(rhs, r)) {
+    return nullValue();
+  }
+
+  if (ValueType::Long == l.type && ValueType::Long == r.type) {
+    return compare(l.long_value, r.long_value, op_code);
+  }
+
+  double x = ValueType::Long == l.type ? static_cast<double>(l.long_value) : l.double_value;
+  double y = ValueType::Long == r.type ? static_cast<double>(r.long_value) : r.double_value;
+  return compare(x, y, op_code);
+}
+
+Value negate(const Value& value) {
+  if (ValueType::Boolean != value.type) {
+    return nullValue();
+  }
+  return booleanValue(!value.boolean);
+}
+
+Value conjunct(const Value& lhs, const Value& rhs) {
+  bool l_false = ValueType::Boolean == lhs.type && !lhs.boolean;
+  bool r_false = ValueType::Boolean == rhs.type && !rhs.boolean;
+  if (l_false || r_false) {
+    return booleanValue(false);
+  }
+  if (ValueType::Boolean != lhs.type || ValueType::Boolean != rhs.type) {
+    return nullValue();
+  }
+  return booleanValue(true);
+}
+
+Value disjunct(const Value& lhs, const Value& rhs) {
+  bool l_true = ValueType::Boolean == lhs.type && lhs.boolean;
+  bool r_true = ValueType::Boolean == rhs.type && rhs.boolean;
+  if (l_true || r_true) {
+    return booleanValue(true);
+  }
+  if (ValueType::Boolean != lhs.type || ValueType::Boolean != rhs.type) {
+    return nullValue();
+  }
+  return booleanValue(false);
+}
+
+} // namespace
+
+bool Sql92Filter::accept(const MQMessageExt& message) const {
+  absl::InlinedVector<Value, 16> stack;
+  stack.reserve(max_stack_depth_);
+
+  const auto& properties = message.getProperties();
+  std::string tag;
+
+  std::size_t pc = 0;
+  const std::size_t end = instructions_.size();
+  while (pc < end) {
+    const Instruction& instruction = instructions_[pc++];
+    switch (instruction.op_code) {
+      case OpCode::PushConstant: {
+        stack.push_back(constants_[instruction.operand]);
+        break;
+      }
+
+      case OpCode::LoadProperty: {
+        Value value;
+        auto search = properties.find(properties_[instruction.operand]);
+        if (properties.end() != search) {
+          value.type = ValueType::String;
+          value.string = &search->second;
+        }
+        stack.push_back(value);
+        break;
+      }
+
+      case OpCode::LoadTag: {
+        Value value;
+        tag = message.getTags();
+        if (!tag.empty()) {
+          value.type = ValueType::String;
+          value.string = &tag;
+        }
+        stack.push_back(value);
+        break;
+      }
+
+      case OpCode::Equal:
+      case OpCode::NotEqual:
+      case OpCode::Less:
+      case OpCode::LessEqual:
+      case OpCode::Greater:
+      case OpCode::GreaterEqual: {
+        Value rhs = stack.back();
+        stack.pop_back();
+        stack.back() = compare(stack.back(), rhs, instruction.op_code);
+        break;
+      }
+
+      case OpCode::IsNull:
+      case OpCode::IsNotNull: {
+        bool null = ValueType::Null == stack.back().type;
+        stack.back() = booleanValue(OpCode::IsNull == instruction.op_code ? null : !null);
+        break;
+      }
+
+      case OpCode::Between:
+      case OpCode::NotBetween: {
+        Value upper = stack.back();
+        stack.pop_back();
+        Value lower = stack.back();
+        stack.pop_back();
+        Value result = conjunct(compare(stack.back(), lower, OpCode::GreaterEqual),
+                                compare(stack.back(), upper, OpCode::LessEqual));
+        stack.back() = OpCode::Between == instruction.op_code ? result : negate(result);
+        break;
+      }
+
+      case OpCode::In:
+      case OpCode::NotIn: {
+        if (ValueType::String != stack.back().type) {
+          stack.back() = nullValue();
+          break;
+        }
+        bool contained = sets_[instruction.operand].contains(*stack.back().string);
+        stack.back() = booleanValue(OpCode::In == instruction.op_code ? contained : !contained);
+        break;
+      }
+
+      case OpCode::Not: {
+        stack.back() = negate(stack.back());
+        break;
+      }
+
+      case OpCode::And:
+      case OpCode::Or: {
+        Value rhs = stack.back();
+        stack.pop_back();
+        stack.back() = OpCode::And == instruction.op_code ? conjunct(stack.back(), rhs) : disjunct(stack.back(), rhs);
+        break;
+      }
+
+      case OpCode::JumpIfFalse: {
+        // Short-circuit: FALSE AND x is FALSE regardless of x.
+        if (ValueType::Boolean == stack.back().type && !stack.back().boolean) {
+          pc = instruction.operand;
+        }
+        break;
+      }
+
+      case OpCode::JumpIfTrue: {
+        // Short-circuit: TRUE OR x is TRUE regardless of x.
+        if (ValueType::Boolean == stack.back().type && stack.back().boolean) {
+          pc = instruction.operand;
+        }
+        break;
+      }
+    }
+  }
+
+  return !stack.empty() && ValueType::Boolean == stack.back().type && stack.back().boolean;
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StartupTracker.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+StartupTracker::StartupTracker(const std::vector<std::string>& topics, absl::Time start)
+    : start_(start), pending_(topics.begin(), topics.end()), route_latency_(absl::ZeroDuration()),
+      assignment_latency_(absl::ZeroDuration()), ready_latency_(absl::ZeroDuration()) {
+  topics_ = pending_.size();
+  if (pending_.empty()) {
+    promise_.set_value();
+  }
+}
+
+std::future<void> StartupTracker::readiness() {
+  return promise_.get_future();
+}
+
+void StartupTracker::routeFetched(const std::string& topic, bool ok, absl::Time now) {
+  absl::MutexLock lk(&mtx_);
+  if (!pending_.contains(topic)) {
+    return;
+  }
+
+  route_latency_ = std::max(route_latency_, now - start_);
+  if (ok) {
+    route_arrivals_.insert({topic, now});
+  } else {
+    complete(topic, false, now);
+  }
+}
+
+void StartupTracker::assigned(const std::string& topic, bool ok, absl::Time now) {
+  absl::MutexLock lk(&mtx_);
+  if (!pending_.contains(topic)) {
+    return;
+  }
+
+  auto search = route_arrivals_.find(topic);
+  if (search != route_arrivals_.end()) {
+    assignment_latency_ = std::max(assignment_latency_, now - search->second);
+    route_arrivals_.erase(search);
+  }
+  complete(topic, ok, now);
+}
+
+void StartupTracker::complete(const std::string& topic, bool ok, absl::Time now) {
+  pending_.erase(topic);
+  if (!ok) {
+    failed_++;
+  }
+
+  if (pending_.empty()) {
+    ready_latency_ = now - start_;
+    std::string stats;
+    format(stats);
+    SPDLOG_INFO("{}", stats);
+    promise_.set_value();
+  }
+}
+
+void StartupTracker::firstContact(absl::flat_hash_set<std::string>& hosts) {
+  absl::MutexLock lk(&mtx_);
+  for (auto it = hosts.begin(); it != hosts.end();) {
+    if (contacted_hosts_.insert(*it).second) {
+      it++;
+    } else {
+      hosts.erase(it++);
+    }
+  }
+}
+
+bool StartupTracker::ready() const {
+  absl::MutexLock lk(&mtx_);
+  return pending_.empty();
+}
+
+void StartupTracker::pendingStages(std::string& stages) const {
+  std::vector<std::string> items;
+  {
+    absl::MutexLock lk(&mtx_);
+    for (const auto& topic : pending_) {
+      items.push_back(absl::StrCat(route_arrivals_.contains(topic) ? "assignment of " : "route of ", topic));
+    }
+  }
+  std::sort(items.begin(), items.end());
+  stages = absl::StrJoin(items, ", ");
+}
+
+void StartupTracker::report(std::string& stats) const {
+  absl::MutexLock lk(&mtx_);
+  format(stats);
+}
+
+void StartupTracker::format(std::string& stats) const {
+  stats = absl::StrFormat("Start latency breakdown: topics=%d, failed=%d, routes=%dms, assignments=%dms, ready=%dms",
+                          topics_, failed_, absl::ToInt64Milliseconds(route_latency_),
+                          absl::ToInt64Milliseconds(assignment_latency_), absl::ToInt64Milliseconds(ready_latency_));
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TagFilter.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_split.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+TagFilter::TagFilter(absl::string_view expression) {
+  for (absl::string_view tag : absl::StrSplit(expression, "||")) {
+    tag = absl::StripAsciiWhitespace(tag);
+    if (tag.empty()) {
+      continue;
+    }
+
+    if ("*" == tag) {
+      wildcard_ = true;
+      continue;
+    }
+    tags_.emplace(tag);
+  }
+
+  if (tags_.empty()) {
+    wildcard_ = true;
+  }
+}
+
+bool TagFilter::accept(const MQMessageExt& message) const {
+  if (wildcard_) {
+    return true;
+  }
+  return accept(message.getTags());
+}
+
+bool TagFilter::accept(absl::string_view tag) const {
+  return wildcard_ || tags_.contains(tag);
+}
+
+ROCKETMQ_NAMESPACE_END
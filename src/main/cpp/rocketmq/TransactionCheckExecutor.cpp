@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TransactionCheckExecutor.h"
+
+#include <exception>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+TransactionCheckExecutor::TransactionCheckExecutor(std::uint16_t workers, std::size_t capacity)
+    : pool_(absl::make_unique<ThreadPoolImpl>(workers)), capacity_(capacity) {
+  pool_->placement(ThreadRole::Callback, "rmq-txn-check");
+}
+
+void TransactionCheckExecutor::start() {
+  pool_->start();
+}
+
+void TransactionCheckExecutor::shutdown() {
+  pool_->shutdown();
+}
+
+bool TransactionCheckExecutor::submit(const std::string& transaction_id, Task task) {
+  {
+    absl::MutexLock lk(&mtx_);
+    if (pending_.contains(transaction_id)) {
+      deduplicated_.fetch_add(1, std::memory_order_relaxed);
+      SPDLOG_DEBUG("Check of transaction[id={}] is pending already", transaction_id);
+      return false;
+    }
+
+    if (pending_.size() >= capacity_) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      SPDLOG_WARN("Drop check of transaction[id={}] as {} checks are pending", transaction_id, pending_.size());
+      return false;
+    }
+    pending_.insert(transaction_id);
+  }
+  accepted_.fetch_add(1, std::memory_order_relaxed);
+
+  std::weak_ptr<TransactionCheckExecutor> executor(shared_from_this());
+  auto submitted = std::chrono::steady_clock::now();
+  Completion completion = [executor, transaction_id, submitted]() {
+    auto ptr = executor.lock();
+    if (ptr) {
+      ptr->complete(transaction_id, submitted);
+    }
+  };
+
+  pool_->submit([task, completion, transaction_id]() {
+    try {
+      task(completion);
+    } catch (const std::exception& e) {
+      SPDLOG_WARN("Check of transaction[id={}] raised an exception: {}", transaction_id, e.what());
+      completion();
+    } catch (...) {
+      SPDLOG_WARN("Check of transaction[id={}] raised an unknown exception", transaction_id);
+      completion();
+    }
+  });
+  return true;
+}
+
+void TransactionCheckExecutor::complete(const std::string& transaction_id,
+                                        std::chrono::steady_clock::time_point submitted) {
+  {
+    absl::MutexLock lk(&mtx_);
+    if (!pending_.erase(transaction_id)) {
+      return;
+    }
+  }
+  completed_.fetch_add(1, std::memory_order_relaxed);
+
+  std::int64_t latency =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - submitted).count();
+  std::int64_t max = max_latency_.load(std::memory_order_relaxed);
+  while (latency > max && !max_latency_.compare_exchange_weak(max, latency, std::memory_order_relaxed)) {
+  }
+}
+
+std::size_t TransactionCheckExecutor::pending() const {
+  absl::MutexLock lk(&mtx_);
+  return pending_.size();
+}
+
+void TransactionCheckExecutor::reportAndReset(std::string& stats) {
+  stats = fmt::format("TransactionCheck: pending={}, capacity={}, backlog={}, accepted={}, completed={}, "
+                      "deduplicated={}, rejected={}, max-latency={}ms",
+                      pending(), capacity_, pool_->backlog(), accepted_.exchange(0, std::memory_order_relaxed),
+                      completed_.exchange(0, std::memory_order_relaxed),
+                      deduplicated_.exchange(0, std::memory_order_relaxed),
+                      rejected_.exchange(0, std::memory_order_relaxed),
+                      max_latency_.exchange(0, std::memory_order_relaxed));
+}
+
+ROCKETMQ_NAMESPACE_END
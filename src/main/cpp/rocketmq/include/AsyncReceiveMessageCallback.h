@@ -37,6 +37,8 @@ public:
 
   void receiveMessageImmediately();
 
+  void checkThrottleThenReceive();
+
 private:
   /**
    * Hold a weak_ptr to ProcessQueue. Once ProcessQueue was released, stop the
@@ -46,8 +48,6 @@ private:
 
   std::function<void(void)> receive_message_later_;
 
-  void checkThrottleThenReceive();
-
   static const char* RECEIVE_LATER_TASK_NAME;
 };
 
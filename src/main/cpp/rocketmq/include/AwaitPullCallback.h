@@ -18,8 +18,7 @@
 
 #include <system_error>
 
-#include "absl/synchronization/mutex.h"
-
+#include "CountdownLatch.h"
 #include "rocketmq/AsyncCallback.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
@@ -31,6 +30,8 @@ public:
 
   void onSuccess(const PullResult& pull_result) noexcept override;
 
+  void onSuccess(PullResult&& pull_result) noexcept override;
+
   void onFailure(const std::error_code& ec) noexcept override;
 
   bool await();
@@ -40,7 +41,7 @@ public:
   }
 
   bool isCompleted() const {
-    return completed_;
+    return latch_.count() <= 0;
   }
 
   const std::error_code& errorCode() const noexcept {
@@ -49,10 +50,8 @@ public:
 
 private:
   PullResult& pull_result_;
-  absl::Mutex mtx_;
-  absl::CondVar cv_;
-  bool completed_{false};
   std::error_code ec_;
+  CountdownLatch latch_{1};
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -18,7 +18,10 @@
 
 #include <memory>
 #include <atomic>
+#include <vector>
 
+#include "ConsumeInvoker.h"
+#include "rocketmq/MQMessageExt.h"
 #include "rocketmq/RocketMQ.h"
 
 ROCKETMQ_NAMESPACE_BEGIN
@@ -28,7 +31,8 @@ class ConsumeMessageService;
 
 class BroadcastTask : public std::enable_shared_from_this<BroadcastTask> {
 public:
-  BroadcastTask(std::weak_ptr<ProcessQueue> process_queue, std::weak_ptr<ConsumeMessageService> consume_message_service);
+  BroadcastTask(std::weak_ptr<ProcessQueue> process_queue, std::weak_ptr<ConsumeMessageService> consume_message_service,
+                ConsumeInvoker invoker);
 
   void process();
 
@@ -40,6 +44,13 @@ private:
   std::weak_ptr<ProcessQueue> process_queue_;
   std::weak_ptr<ConsumeMessageService> consume_message_service_;
   std::atomic<bool> runnable_{false};
+  ConsumeInvoker invoker_;
+
+  /**
+   * @brief Single-slot batch handed to the listener, reused across messages. Only touched by the thread that owns
+   * runnable_.
+   */
+  std::vector<MQMessageExt> slot_;
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
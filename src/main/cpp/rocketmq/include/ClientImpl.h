@@ -33,7 +33,9 @@
 #include "InvocationContext.h"
 #include "NameServerResolver.h"
 #include "OtlpExporter.h"
+#include "RouteCache.h"
 #include "rocketmq/MQMessageExt.h"
+#include "rocketmq/MQMessageQueue.h"
 #include "rocketmq/MessageListener.h"
 #include "rocketmq/State.h"
 
@@ -43,14 +45,17 @@ class ClientImpl : public ClientConfigImpl, virtual public Client {
 public:
   explicit ClientImpl(absl::string_view group_name);
 
-  ~ClientImpl() override = default;
+  ~ClientImpl() override;
 
   virtual void start();
 
   virtual void shutdown();
 
+  /**
+   * @brief Look up route of the topic, subscribing this client to it in the process-wide RouteCache on first use.
+   */
   void getRouteFor(const std::string& topic, const std::function<void(const std::error_code&, TopicRouteDataPtr)>& cb)
-      LOCKS_EXCLUDED(inflight_route_requests_mtx_, topic_route_table_mtx_);
+      LOCKS_EXCLUDED(route_subscriptions_mtx_, topic_route_table_mtx_);
 
   /**
    * Gather collection of endpoints that are reachable from latest topic route
@@ -71,6 +76,8 @@ public:
 
   void healthCheck() override LOCKS_EXCLUDED(isolated_endpoints_mtx_);
 
+  void onEndpointRecovery(const std::string& endpoint) override LOCKS_EXCLUDED(isolated_endpoints_mtx_);
+
   void schedule(const std::string& task_name, const std::function<void(void)>& task,
                 std::chrono::milliseconds delay) override;
 
@@ -91,14 +98,26 @@ protected:
   std::atomic<State> state_;
 
   absl::flat_hash_map<std::string, TopicRouteDataPtr> topic_route_table_ GUARDED_BY(topic_route_table_mtx_);
-  absl::Mutex topic_route_table_mtx_ ACQUIRED_AFTER(inflight_route_requests_mtx_); // protects topic_route_table_
+  absl::Mutex topic_route_table_mtx_; // protects topic_route_table_
+
+  struct RouteSubscription {
+    RouteKey key;
+    std::uint64_t id;
+  };
 
-  absl::flat_hash_map<std::string, std::vector<std::function<void(const std::error_code&, const TopicRouteDataPtr&)>>>
-      inflight_route_requests_ GUARDED_BY(inflight_route_requests_mtx_);
-  absl::Mutex inflight_route_requests_mtx_ ACQUIRED_BEFORE(topic_route_table_mtx_); // Protects inflight_route_requests_
+  /**
+   * Topics this client has subscribed to in the shared RouteCache, which fans route changes out to the local table.
+   */
+  absl::flat_hash_map<std::string, RouteSubscription> route_subscriptions_ GUARDED_BY(route_subscriptions_mtx_);
+  absl::Mutex route_subscriptions_mtx_; // Protects route_subscriptions_
   static const char* UPDATE_ROUTE_TASK_NAME;
   std::uint32_t route_update_handle_{0};
 
+  /**
+   * Routes fetched more recently than this, by any client sharing the cache, are not re-queried on periodic update.
+   */
+  static const absl::Duration ROUTE_MAX_AGE;
+
   // Set Name Server Resolver
   std::shared_ptr<NameServerResolver> name_server_resolver_;
 
@@ -108,7 +127,7 @@ protected:
   absl::flat_hash_set<std::string> isolated_endpoints_ GUARDED_BY(isolated_endpoints_mtx_);
   absl::Mutex isolated_endpoints_mtx_;
 
-  void updateRouteInfo() LOCKS_EXCLUDED(topic_route_table_mtx_);
+  void updateRouteInfo() LOCKS_EXCLUDED(route_subscriptions_mtx_);
 
   /**
    * Sub-class is supposed to inherit from std::enable_shared_from_this.
@@ -143,6 +162,17 @@ protected:
 
   void setAccessPoint(rmq::Endpoints* endpoints);
 
+  /**
+   * @brief Query offset of the next message to be produced to the message queue, from the broker serving it.
+   */
+  void queryEndOffset(const MQMessageQueue& message_queue,
+                      const std::function<void(const std::error_code&, std::int64_t)>& cb);
+
+  /**
+   * @brief Send heartbeat to the given hosts only.
+   */
+  void heartbeat(const absl::flat_hash_set<std::string>& hosts);
+
   void notifyClientTermination() override;
 
   void notifyClientTermination(const NotifyClientTerminationRequest& request);
@@ -170,12 +200,24 @@ private:
                      const std::function<void(const std::error_code&, const TopicRouteDataPtr&)>& cb);
 
   /**
-   * Callback to execute once route data is fetched from name server.
-   * @param topic
-   * @param route
+   * @brief Key of the topic in RouteCache, as of the currently resolved access point and credentials.
+   */
+  RouteKey routeKeyOf(const std::string& topic);
+
+  RouteCache::Listener routeListenerOf(const std::string& topic);
+
+  /**
+   * @return false if no access point is resolved at present, in which case the topic is not subscribed to.
+   */
+  bool subscribeRoute(const std::string& topic, RouteKey& key) LOCKS_EXCLUDED(route_subscriptions_mtx_);
+
+  /**
+   * @brief Move the subscription of the topic over to the given key, once its access point or credentials change.
    */
-  void onTopicRouteReady(const std::string& topic, const std::error_code& ec, const TopicRouteDataPtr& route)
-      LOCKS_EXCLUDED(inflight_route_requests_mtx_);
+  void resubscribeRoute(const std::string& topic, const RouteKey& from, const RouteKey& to)
+      LOCKS_EXCLUDED(route_subscriptions_mtx_);
+
+  void unsubscribeRoutes() LOCKS_EXCLUDED(route_subscriptions_mtx_);
 
   /**
    * Update Trace candidate hosts.
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+
+#include "rocketmq/MQMessageExt.h"
+#include "rocketmq/MessageListener.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Calling convention of each listener type, expressed in terms of a single-message batch.
+ */
+template <typename Listener>
+struct ListenerTraits;
+
+template <>
+struct ListenerTraits<StandardMessageListener> {
+  static ConsumeMessageResult consume(StandardMessageListener* listener, const std::vector<MQMessageExt>& batch) {
+    return listener->consumeMessage(batch);
+  }
+};
+
+template <>
+struct ListenerTraits<FifoMessageListener> {
+  static ConsumeMessageResult consume(FifoMessageListener* listener, const std::vector<MQMessageExt>& batch) {
+    return listener->consumeMessage(batch.front());
+  }
+};
+
+/**
+ * @brief Invoke user-defined listener through a function pointer resolved once, when the consume service is created,
+ * instead of inspecting listener type and down-casting for each message.
+ */
+class ConsumeInvoker {
+public:
+  ConsumeInvoker() = default;
+
+  explicit ConsumeInvoker(MessageListener* listener);
+
+  /**
+   * @brief Hand the head of batch to the listener.
+   *
+   * @param batch Messages whose head is to consume. Standard listeners receive the whole batch, thus callers keep it
+   * at exactly one message and reuse the vector rather than building a temporary one per message.
+   */
+  ConsumeMessageResult operator()(const std::vector<MQMessageExt>& batch) const {
+    return function_(listener_, batch);
+  }
+
+  bool fifo() const {
+    return fifo_;
+  }
+
+  explicit operator bool() const {
+    return nullptr != function_;
+  }
+
+private:
+  using Function = ConsumeMessageResult (*)(MessageListener*, const std::vector<MQMessageExt>&);
+
+  MessageListener* listener_{nullptr};
+  Function function_{nullptr};
+  bool fifo_{false};
+
+  template <typename Listener>
+  static ConsumeMessageResult invoke(MessageListener* listener, const std::vector<MQMessageExt>& batch) {
+    // Type of the listener was verified on construction.
+    return ListenerTraits<Listener>::consume(static_cast<Listener*>(listener), batch);
+  }
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -62,6 +62,33 @@ public:
 
   virtual void schedule(std::shared_ptr<ConsumeTask> task, std::chrono::milliseconds delay) = 0;
 
+  /**
+   * @brief Decide whether a message failed by the listener should be consumed again locally rather than nacked.
+   *
+   * @param message The failed message.
+   * @param attempted Number of local attempts already made for the message.
+   * @param delay Backoff before the next local attempt, if permitted.
+   */
+  virtual bool retryLocally(const MQMessageExt& message, std::uint32_t attempted, std::chrono::milliseconds& delay) = 0;
+
+  /**
+   * @brief Enter drain mode: messages that are not yet handed to the listener are released back to broker rather
+   * than consumed, while in-flight listener calls and pending acknowledgements run to completion.
+   */
+  virtual void drain() = 0;
+
+  virtual bool draining() const = 0;
+
+  /**
+   * @brief Return received but unconsumed messages to broker such that they are redelivered immediately.
+   */
+  virtual void release(const std::vector<MQMessageExt>& messages) = 0;
+
+  /**
+   * @return true if no consume task is either queued or running.
+   */
+  virtual bool idle() const = 0;
+
   virtual std::size_t maxDeliveryAttempt() = 0;
 
   virtual std::weak_ptr<PushConsumer> consumer() = 0;
@@ -21,9 +21,14 @@
 #include <string>
 #include <system_error>
 
+#include "ConsumeInvoker.h"
 #include "ConsumeMessageService.h"
-#include "ThreadPool.h"
+#include "ConsumeRetryPolicy.h"
+#include "DuplicateFilter.h"
+#include "ThreadPoolImpl.h"
+#include "ThreadPoolScaler.h"
 #include "absl/container/flat_hash_map.h"
+#include "rocketmq/DuplicateAction.h"
 #include "rocketmq/MessageListener.h"
 #include "rocketmq/State.h"
 
@@ -37,6 +42,13 @@ public:
   ConsumeMessageServiceImpl(std::weak_ptr<PushConsumer> consumer, int thread_count,
                             MessageListener* message_listener);
 
+  /**
+   * @brief Create a service whose consume thread pool grows from thread_count up to max_thread_count according to
+   * backlog and queueing delay, and shrinks back once idle.
+   */
+  ConsumeMessageServiceImpl(std::weak_ptr<PushConsumer> consumer, int thread_count, int max_thread_count,
+                            MessageListener* message_listener);
+
   ~ConsumeMessageServiceImpl() override = default;
 
   /**
@@ -69,18 +81,89 @@ public:
 
   void schedule(std::shared_ptr<ConsumeTask> task, std::chrono::milliseconds delay) override;
 
+  bool retryLocally(const MQMessageExt& message, std::uint32_t attempted, std::chrono::milliseconds& delay) override;
+
+  void retryPolicy(const ConsumeRetryPolicy& retry_policy) {
+    retry_policy_ = retry_policy;
+  }
+
+  const ConsumeRetryPolicy& retryPolicy() const {
+    return retry_policy_;
+  }
+
+  void drain() override;
+
+  bool draining() const override {
+    return draining_.load(std::memory_order_relaxed);
+  }
+
+  void release(const std::vector<MQMessageExt>& messages) override;
+
+  bool idle() const override {
+    return pool_->idle();
+  }
+
+  /**
+   * @brief Suppress redeliveries of messages consumed successfully within the window. Must be called prior to start().
+   */
+  void deduplication(std::chrono::milliseconds window, std::size_t capacity, DuplicateAction action);
+
+  bool deduplicating() const {
+    return nullptr != duplicate_filter_;
+  }
+
   std::size_t maxDeliveryAttempt() override;
 
   std::weak_ptr<PushConsumer> consumer() override;
 
+  bool elastic() const {
+    return pool_->maxWorkers() > pool_->minWorkers();
+  }
+
+  /**
+   * @brief Evaluate load of the consume thread pool and resize it if necessary. Expected to be called periodically.
+   */
+  void adjustThreadPool();
+
+  /**
+   * @brief Report number of messages retried locally and of those nacked to broker since last call, along with
+   * hit-rate of deduplication if enabled.
+   */
+  void reportAndReset(std::string& stats);
+
 protected:
   std::atomic<State> state_;
 
+  std::atomic_bool draining_{false};
+
   int thread_count_;
-  std::unique_ptr<ThreadPool> pool_;
+  std::unique_ptr<ThreadPoolImpl> pool_;
+  std::unique_ptr<ThreadPoolScaler> pool_scaler_;
+  std::uint32_t pool_scaler_ticks_{0};
   std::weak_ptr<PushConsumer> consumer_;
 
   MessageListener* message_listener_;
+
+  /**
+   * @brief Listener entry resolved once from message_listener_, shared by all consume tasks.
+   */
+  ConsumeInvoker invoker_;
+
+  std::unique_ptr<DuplicateFilter> duplicate_filter_;
+  DuplicateAction duplicate_action_{DuplicateAction::DROP};
+
+  ConsumeRetryPolicy retry_policy_;
+  std::atomic<std::uint64_t> local_retry_count_{0};
+  std::atomic<std::uint64_t> broker_retry_count_{0};
+
+  static const char* CONSUME_RETRY_TASK_NAME;
+
+  /**
+   * @brief Drop or flag messages that have been consumed within the deduplication window.
+   */
+  void deduplicate(PushConsumer& consumer, std::vector<MQMessageExt>& messages);
+
+  static const std::uint32_t STATS_INTERVAL_TICKS;
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Client-side retry policy applied when a standard message listener reports failure.
+ *
+ * Instead of nacking the message immediately, the consumer re-invokes the listener locally with exponential backoff,
+ * as long as the retry fits into the remaining invisible window of the message. Messages that exhaust local attempts,
+ * or whose invisible window is about to close, are nacked to broker as before.
+ */
+struct ConsumeRetryPolicy {
+  /**
+   * @brief Maximum number of local re-attempts per message. 0 disables local retry.
+   */
+  std::uint32_t max_local_attempts{0};
+
+  std::chrono::milliseconds initial_backoff{100};
+
+  std::chrono::milliseconds max_backoff{5000};
+
+  double backoff_multiplier{2.0};
+
+  /**
+   * @brief Portion of the invisible window that is reserved for the nack RPC once local attempts are exhausted.
+   */
+  std::chrono::milliseconds reserved_window{3000};
+
+  bool enabled() const {
+    return max_local_attempts > 0;
+  }
+
+  /**
+   * @brief Backoff before the given local attempt, 1-based.
+   */
+  std::chrono::milliseconds backoff(std::uint32_t attempt) const;
+
+  /**
+   * @brief Decide whether the failed message should be retried locally.
+   *
+   * @param attempted Number of local attempts made so far.
+   * @param remaining Remaining invisible time of the message.
+   * @param delay Backoff to wait before the next local attempt, if permitted.
+   * @return true if the message should be retried locally; false if it should be nacked.
+   */
+  bool retryLocally(std::uint32_t attempted, std::chrono::milliseconds remaining,
+                    std::chrono::milliseconds& delay) const;
+};
+
+ROCKETMQ_NAMESPACE_END
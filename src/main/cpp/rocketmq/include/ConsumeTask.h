@@ -19,6 +19,7 @@
 #include <memory>
 #include <vector>
 
+#include "ConsumeInvoker.h"
 #include "ConsumeMessageService.h"
 #include "rocketmq/MQMessageExt.h"
 
@@ -50,14 +51,15 @@ enum class NextStep : std::uint8_t {
 
 class ConsumeTask : public std::enable_shared_from_this<ConsumeTask> {
 public:
-  ConsumeTask(ConsumeMessageServiceWeakPtr service, std::weak_ptr<ProcessQueue> process_queue, MQMessageExt message);
+  ConsumeTask(ConsumeMessageServiceWeakPtr service, std::weak_ptr<ProcessQueue> process_queue, MQMessageExt message,
+              ConsumeInvoker invoker);
 
   ConsumeTask(ConsumeMessageServiceWeakPtr service, std::weak_ptr<ProcessQueue> process_queue,
-              std::vector<MQMessageExt> messages);
+              std::vector<MQMessageExt> messages, ConsumeInvoker invoker);
 
   /**
-   * If the message model is cluster, the consume logic remains same with 5.x;
-   * If the message model is broadcast, TODO:
+   * Consume messages of the clustering model, one per invocation. Messages of the broadcasting model are handled by
+   * BroadcastTask instead.
    */
   void process();
 
@@ -69,9 +71,15 @@ private:
   ConsumeMessageServiceWeakPtr service_;
   std::weak_ptr<ProcessQueue> process_queue_;
   std::vector<MQMessageExt> messages_;
+  ConsumeInvoker invoker_;
   bool fifo_{false};
   NextStep next_step_{NextStep::Consume};
 
+  /**
+   * @brief Number of local attempts made for messages_[0] after its listener reported failure.
+   */
+  std::uint32_t local_attempts_{0};
+
   /**
    * @brief messages_[0] has completed its life-cycle.
    */
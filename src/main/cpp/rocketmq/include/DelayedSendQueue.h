@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+#include "Histogram.h"
+#include "rocketmq/AsyncCallback.h"
+#include "rocketmq/MQMessage.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Hold messages on producer side until they are due, then hand them over for sending.
+ *
+ * Messages are kept in a hashed timing wheel of wheel_size slots, each tick_duration wide, which advance() moves
+ * forward to the current time of the clock; it is expected to be called every tick, such that messages are sent at
+ * most about one tick late. Messages farther out than a revolution stay in their slot until the revolution in which
+ * they fall due. Bodies of held messages are bounded by the memory budget.
+ *
+ * Callbacks of messages that are cancelled, or dropped by clear(), are completed with failure; others are handed over
+ * to the dispatcher along with their message. Dispatcher and callbacks are invoked without holding the lock.
+ */
+class DelayedSendQueue {
+public:
+  using Clock = std::function<std::chrono::steady_clock::time_point(void)>;
+  using Dispatcher = std::function<void(const MQMessage&, SendCallback*)>;
+
+  DelayedSendQueue(Dispatcher dispatcher, std::uint64_t memory_budget, std::chrono::milliseconds tick_duration,
+                   std::size_t wheel_size, Clock clock = &std::chrono::steady_clock::now);
+
+  /**
+   * @return false if the message is not accepted, either because a message of the same id is held already, or
+   * because its body does not fit into what is left of the memory budget. ec tells which.
+   */
+  bool schedule(const MQMessage& message, std::chrono::milliseconds delay, SendCallback* callback, std::error_code& ec)
+      LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Drop the held message, failing its callback with std::errc::operation_canceled.
+   *
+   * @return false if no message of the id is held, for example, because it has been handed over for sending.
+   */
+  bool cancel(const std::string& message_id) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Hand over messages that have fallen due by now.
+   */
+  void advance() LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Drop all held messages, failing their callbacks with ec.
+   */
+  void clear(const std::error_code& ec) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t size() const LOCKS_EXCLUDED(mtx_);
+
+  std::uint64_t memoryInUse() const LOCKS_EXCLUDED(mtx_);
+
+  std::chrono::milliseconds tickDuration() const {
+    return tick_duration_;
+  }
+
+  /**
+   * @brief Report how late messages were handed over, along with messages held, sent and cancelled since last call.
+   */
+  void reportAndReset(std::string& stats);
+
+private:
+  struct Entry {
+    MQMessage message;
+    SendCallback* callback;
+    std::chrono::steady_clock::time_point due;
+    std::uint64_t deadline_tick;
+  };
+
+  using Slot = std::list<Entry>;
+
+  Dispatcher dispatcher_;
+  const std::uint64_t memory_budget_;
+  const std::chrono::milliseconds tick_duration_;
+  Clock clock_;
+  const std::chrono::steady_clock::time_point epoch_;
+
+  std::vector<Slot> wheel_ GUARDED_BY(mtx_);
+  absl::flat_hash_map<std::string, std::pair<std::size_t, Slot::iterator>> index_ GUARDED_BY(mtx_);
+  std::uint64_t current_tick_ GUARDED_BY(mtx_){0};
+  std::uint64_t memory_in_use_ GUARDED_BY(mtx_){0};
+  mutable absl::Mutex mtx_;
+
+  Histogram lateness_histogram_;
+  std::atomic<std::int64_t> max_lateness_{0};
+  std::atomic<std::uint64_t> sent_{0};
+  std::atomic<std::uint64_t> cancelled_{0};
+  std::atomic<std::uint64_t> rejected_{0};
+
+  std::uint64_t tickOf(std::chrono::steady_clock::time_point time_point) const;
+
+  void collect(Slot& slot, std::uint64_t tick, std::vector<Entry>& due) EXCLUSIVE_LOCKS_REQUIRED(mtx_);
+
+  void dispatch(std::vector<Entry>& due, std::chrono::steady_clock::time_point now);
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Remember ids of successfully consumed messages for a bounded time and memory, such that their redeliveries
+ * can be told apart.
+ *
+ * Ids are kept as 64-bit fingerprints in two generations. Fingerprints are recorded into the current generation, which
+ * retires to the previous one after half of the window or once it holds half of the capacity, evicting the previous
+ * one as a whole. A fingerprint is therefore remembered for at most the window and at least half of it, unless
+ * capacity is hit first. With 64-bit fingerprints, the chance of mistaking a new message for a duplicate is
+ * negligible, which matters as duplicates may be dropped.
+ */
+class DuplicateFilter {
+public:
+  DuplicateFilter(absl::Duration window, std::size_t capacity);
+
+  /**
+   * @brief Check if the message has been consumed within the window.
+   */
+  bool seen(const std::string& message_id, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  void record(const std::string& message_id, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t size() const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Report lookups and hits since last call.
+   */
+  void reportAndReset(std::string& stats) LOCKS_EXCLUDED(mtx_);
+
+private:
+  const absl::Duration half_window_;
+  const std::size_t generation_capacity_;
+
+  absl::flat_hash_set<std::uint64_t> current_ GUARDED_BY(mtx_);
+  absl::flat_hash_set<std::uint64_t> previous_ GUARDED_BY(mtx_);
+  absl::Time current_since_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+
+  std::atomic<std::uint64_t> lookups_{0};
+  std::atomic<std::uint64_t> hits_{0};
+
+  void rotate(absl::Time now) EXCLUSIVE_LOCKS_REQUIRED(mtx_);
+
+  static std::uint64_t fingerprint(const std::string& message_id);
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -16,8 +16,11 @@
  */
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <string>
 
+#include "MessageFilter.h"
 #include "rocketmq/ExpressionType.h"
 #include "rocketmq/MQMessageExt.h"
 
@@ -25,14 +28,12 @@ ROCKETMQ_NAMESPACE_BEGIN
 
 /**
  * Server supported message filtering expression. At present, two types are supported: tag and SQL92.
+ *
+ * The expression is compiled once on construction, so that messages may also be filtered on client side, where the
+ * server filters loosely or not at all, e.g. pull in broadcasting mode.
  */
 struct FilterExpression {
-  explicit FilterExpression(std::string expression, ExpressionType expression_type = ExpressionType::TAG)
-      : content_(std::move(expression)), type_(expression_type), version_(std::chrono::steady_clock::now()) {
-    if (ExpressionType::TAG == type_ && content_.empty()) {
-      content_ = WILD_CARD_TAG;
-    }
-  }
+  explicit FilterExpression(std::string expression, ExpressionType expression_type = ExpressionType::TAG);
 
   bool accept(const MQMessageExt& message) const;
 
@@ -40,6 +41,11 @@ struct FilterExpression {
   ExpressionType type_;
   std::chrono::steady_clock::time_point version_;
 
+  /**
+   * Compiled expression, shared among copies. nullptr accepts all messages.
+   */
+  std::shared_ptr<const MessageFilter> filter_;
+
   static const char* WILD_CARD_TAG;
 };
 
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief A message received from broker that has not been acked, nacked or forwarded yet.
+ */
+struct InflightMessage {
+  std::string endpoint;
+  std::string topic;
+  std::string message_id;
+  std::string receipt_handle;
+
+  /**
+   * @brief Time after which broker would redeliver the message, unless its invisible duration is extended.
+   */
+  absl::Time deadline;
+
+  /**
+   * @brief A change-invisible-duration request of the message is on the wire.
+   */
+  bool renewing{false};
+};
+
+/**
+ * @brief Book-keeping of in-flight messages, whose invisible duration gets extended before expiry.
+ *
+ * Each renewal yields a new receipt handle and invalidates the previous one, so the latest receipt handle is kept here
+ * and should be used when the message is eventually acked or nacked.
+ */
+class InflightMessageTable {
+public:
+  void add(InflightMessage message) LOCKS_EXCLUDED(mtx_);
+
+  void remove(const std::string& message_id) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Latest receipt handle of the given message.
+   *
+   * @return false if the message is not tracked.
+   */
+  bool receiptHandle(const std::string& message_id, std::string& receipt_handle) const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Deadline of the given message, taking renewals into account.
+   *
+   * @return false if the message is not tracked.
+   */
+  bool deadline(const std::string& message_id, absl::Time& deadline) const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Collect messages that expire before horizon and that are not being renewed, grouped by broker endpoint.
+   * Collected messages are marked as being renewed until either renewed() or renewFailed() is called.
+   */
+  absl::flat_hash_map<std::string, std::vector<InflightMessage>> expiring(absl::Time horizon) LOCKS_EXCLUDED(mtx_);
+
+  void renewed(const std::string& message_id, const std::string& receipt_handle, absl::Time deadline)
+      LOCKS_EXCLUDED(mtx_);
+
+  void renewFailed(const std::string& message_id) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t size() const LOCKS_EXCLUDED(mtx_);
+
+private:
+  absl::flat_hash_map<std::string, InflightMessage> table_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+};
+
+ROCKETMQ_NAMESPACE_END
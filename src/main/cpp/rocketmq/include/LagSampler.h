@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+#include "rocketmq/ConsumeType.h"
+#include "rocketmq/MQMessageQueue.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Estimate consumer lag by comparing consumed offsets with end offsets that brokers report.
+ *
+ * Each sample groups queues by the broker serving them and queries their end offsets with at most
+ * max_inflight_per_broker requests outstanding against any one broker. Lag of a broker's queues is refreshed together,
+ * once all of its queries complete; a broker whose previous round is still in flight is skipped, so a slow broker never
+ * accumulates queries. Queues that fail to answer keep their previous estimate.
+ */
+class LagSampler : public std::enable_shared_from_this<LagSampler> {
+public:
+  using EndOffsetCallback = std::function<void(const std::error_code&, std::int64_t)>;
+  using EndOffsetQuery = std::function<void(const MQMessageQueue&, const EndOffsetCallback&)>;
+
+  LagSampler(EndOffsetQuery query, std::size_t max_inflight_per_broker);
+
+  /**
+   * @param positions Offset of the next message to consume, per queue. Queues absent from positions are no longer
+   * reported.
+   */
+  void sample(const absl::flat_hash_map<MQMessageQueue, std::int64_t>& positions) LOCKS_EXCLUDED(mtx_);
+
+  std::vector<QueueLag> queueLags() const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @return Sum of lag of sampled queues, per topic.
+   */
+  absl::flat_hash_map<std::string, std::int64_t> topicLags() const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Report backlog per topic, along with its most lagging queue, and queries issued since last call.
+   */
+  void reportAndReset(std::string& stats) LOCKS_EXCLUDED(mtx_);
+
+private:
+  struct Round {
+    std::string broker;
+    std::vector<std::pair<MQMessageQueue, std::int64_t>> positions;
+    std::vector<std::int64_t> end_offsets;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> remaining{0};
+  };
+
+  EndOffsetQuery query_;
+  const std::size_t max_inflight_per_broker_;
+
+  absl::flat_hash_map<MQMessageQueue, QueueLag> lags_ GUARDED_BY(mtx_);
+  absl::flat_hash_set<MQMessageQueue> tracked_ GUARDED_BY(mtx_);
+  absl::flat_hash_set<std::string> busy_brokers_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+
+  std::atomic<std::uint64_t> queries_{0};
+  std::atomic<std::uint64_t> failures_{0};
+  std::atomic<std::uint64_t> skipped_{0};
+
+  void issueNext(const std::shared_ptr<Round>& round);
+
+  void complete(const Round& round) LOCKS_EXCLUDED(mtx_);
+};
+
+using LagSamplerSharedPtr = std::shared_ptr<LagSampler>;
+
+ROCKETMQ_NAMESPACE_END
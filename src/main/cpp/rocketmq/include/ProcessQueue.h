@@ -67,6 +67,26 @@ public:
 
   virtual void syncIdleState() = 0;
 
+  /**
+   * @brief Stop issuing receive requests for this queue while keeping its assignment and cached messages.
+   */
+  virtual void pause() = 0;
+
+  virtual bool paused() const = 0;
+
+  /**
+   * @brief Called by the receive cycle before issuing the next request. If the queue is paused, the cycle is parked
+   * and true is returned, such that the caller should stop; the cycle is resumed by resume().
+   */
+  virtual bool park() = 0;
+
+  /**
+   * @brief Lift the pause.
+   *
+   * @return true if a parked receive cycle is handed back to the caller, which is then responsible for restarting it.
+   */
+  virtual bool resume() = 0;
+
   virtual const FilterExpression& getFilterExpression() const = 0;
 
   virtual const MQMessageQueue& messageQueue() const = 0;
@@ -74,6 +94,11 @@ public:
   virtual std::int64_t nextOffset() const = 0;
   virtual void nextOffset(std::int64_t value) = 0;
 
+  /**
+   * @brief Offset following the highest queue offset among messages received, or -1 if none is received yet.
+   */
+  virtual std::int64_t receivedOffset() const = 0;
+
   virtual void enqueueBroadcastMessages(std::vector<MQMessageExt> messages) = 0;
   virtual absl::optional<MQMessageExt> dequeBroadcastMessage() = 0;
 
@@ -91,6 +91,18 @@ public:
     idle_since_ = std::chrono::steady_clock::now();
   }
 
+  void pause() override {
+    paused_.store(true, std::memory_order_release);
+  }
+
+  bool paused() const override {
+    return paused_.load(std::memory_order_acquire);
+  }
+
+  bool park() override;
+
+  bool resume() override;
+
   void release(uint64_t body_size) override;
 
   const MQMessageQueue& messageQueue() const override {
@@ -105,6 +117,10 @@ public:
     next_offset_ = value;
   }
 
+  std::int64_t receivedOffset() const override {
+    return received_offset_.load(std::memory_order_relaxed);
+  }
+
   void enqueueBroadcastMessages(std::vector<MQMessageExt> messages) override LOCKS_EXCLUDED(broadcast_messages_mtx_) {
     absl::MutexLock lk(&broadcast_messages_mtx_);
     for (const auto& message : messages) {
@@ -139,8 +155,6 @@ private:
    */
   const FilterExpression filter_expression_;
 
-  std::chrono::milliseconds invisible_time_;
-
   std::chrono::steady_clock::time_point idle_since_{std::chrono::steady_clock::now()};
 
   absl::Time create_timestamp_{absl::Now()};
@@ -166,18 +180,25 @@ private:
 
   std::int64_t next_offset_{-1};
 
+  std::atomic<std::int64_t> received_offset_{-1};
+
+  std::atomic_bool paused_{false};
+
+  /**
+   * @brief Set while the receive cycle stays parked on pause; whoever clears it owns restarting the cycle.
+   */
+  std::atomic_bool parked_{false};
+
   std::deque<MQMessageExt> broadcast_messages_ GUARDED_BY(broadcast_messages_mtx_);
   absl::Mutex broadcast_messages_mtx_;
 
   std::shared_ptr<BroadcastTask> broadcast_task_;
 
   void popMessage();
-  void wrapPopMessageRequest(absl::flat_hash_map<std::string, std::string>& metadata,
-                             rmq::ReceiveMessageRequest& request);
+  void wrapPopMessageRequest(Metadata& metadata, rmq::ReceiveMessageRequest& request);
 
   void pullMessage();
-  void wrapPullMessageRequest(absl::flat_hash_map<std::string, std::string>& metadata,
-                              rmq::PullMessageRequest& request);
+  void wrapPullMessageRequest(Metadata& metadata, rmq::PullMessageRequest& request);
 
   void wrapFilterExpression(rmq::FilterExpression* filter_expression);
 };
@@ -26,9 +26,11 @@
 
 #include "ClientImpl.h"
 #include "ClientManagerImpl.h"
+#include "DelayedSendQueue.h"
 #include "MixAll.h"
 #include "SendCallbacks.h"
 #include "TopicPublishInfo.h"
+#include "TransactionCheckExecutor.h"
 #include "TransactionImpl.h"
 #include "rocketmq/AsyncCallback.h"
 #include "rocketmq/LocalTransactionStateChecker.h"
@@ -58,8 +60,39 @@ public:
 
   void sendOneway(const MQMessage& message, std::error_code& ec);
 
+  /**
+   * @brief Hold messages sent through sendDelayed() on producer side until they are due. Must be called prior to
+   * start().
+   *
+   * @param memory_budget Bytes of message bodies that may be held at a time.
+   */
+  void delayedSend(std::uint64_t memory_budget);
+
+  /**
+   * @brief Send the message once delay elapses. Callback fails with TooManyRequest if the memory budget is exhausted,
+   * with std::errc::operation_canceled if the message is cancelled and with IllegalState if the producer shuts down
+   * before the message is due.
+   */
+  void sendDelayed(const MQMessage& message, std::chrono::milliseconds delay, SendCallback* callback);
+
+  /**
+   * @return true if the message, held by sendDelayed(), will not be sent.
+   */
+  bool cancelDelayed(const std::string& message_id);
+
+  /**
+   * @brief Expected to be set prior to start(), which creates the executor running checks only if a checker is set.
+   */
   void setLocalTransactionStateChecker(LocalTransactionStateCheckerPtr checker);
 
+  /**
+   * @brief Size the executor that runs local transaction state checks. Must be called prior to start().
+   *
+   * @param workers Threads running checks.
+   * @param capacity Checks allowed to be pending at a time; further ones are dropped until some complete.
+   */
+  void transactionCheckExecutor(std::uint16_t workers, std::size_t capacity);
+
   std::unique_ptr<TransactionImpl> prepare(MQMessage& message, std::error_code& ec);
 
   bool commit(const MQMessage& message, const std::string& transaction_id, const std::string& target);
@@ -134,6 +167,19 @@ private:
 
   LocalTransactionStateCheckerPtr transaction_state_checker_;
 
+  std::uint16_t transaction_check_workers_{MixAll::DEFAULT_TRANSACTION_CHECK_THREAD_POOL_SIZE};
+  std::size_t transaction_check_capacity_{MixAll::DEFAULT_TRANSACTION_CHECK_CAPACITY};
+  std::shared_ptr<TransactionCheckExecutor> transaction_check_executor_;
+  std::uint32_t transaction_check_stats_handle_{0};
+  static const char* TRANSACTION_CHECK_STATS_TASK_NAME;
+
+  std::uint64_t delayed_send_memory_budget_{0};
+  std::shared_ptr<DelayedSendQueue> delayed_send_queue_;
+  std::uint32_t delayed_send_tick_handle_{0};
+  std::uint32_t delayed_send_stats_handle_{0};
+  static const char* DELAYED_SEND_TICK_TASK_NAME;
+  static const char* DELAYED_SEND_STATS_TASK_NAME;
+
   void asyncPublishInfo(const std::string& topic,
                         const std::function<void(const std::error_code&, const TopicPublishInfoPtr&)>& cb)
       LOCKS_EXCLUDED(topic_publish_info_mtx_);
@@ -157,6 +203,9 @@ private:
   bool endTransaction0(const std::string& target, const MQMessage& message, const std::string& transaction_id,
                        TransactionState resolution);
 
+  void endTransaction0(const std::string& target, const MQMessage& message, const std::string& transaction_id,
+                       TransactionState resolution, const std::function<void(bool)>& callback);
+
   void isolatedEndpoints(absl::flat_hash_set<std::string>& endpoints) LOCKS_EXCLUDED(isolated_endpoints_mtx_);
 
   MQMessageQueue withServiceAddress(const MQMessageQueue& message_queue, std::error_code& ec);
@@ -24,7 +24,12 @@
 #include "ClientConfig.h"
 #include "ClientImpl.h"
 #include "ClientManagerImpl.h"
+#include "FilterExpression.h"
+#include "LagSampler.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "rocketmq/ConsumeType.h"
+#include "rocketmq/ExpressionType.h"
 #include "rocketmq/MQMessageQueue.h"
 #include "rocketmq/MessageModel.h"
 
@@ -43,10 +48,22 @@ public:
 
   std::future<int64_t> queryOffset(const OffsetQuery& query);
 
-  void pull(const PullMessageQuery& query, PullCallback* callback);
+  void pull(const PullMessageQuery& query, PullCallback* callback) LOCKS_EXCLUDED(topic_filter_expression_table_mtx_);
+
+  /**
+   * @brief Filter messages pulled from the given topic. Expression is sent to server and also evaluated on client
+   * side, dropping non-matching messages before they are returned.
+   */
+  void subscribe(const std::string& topic, const std::string& expression, ExpressionType expression_type)
+      LOCKS_EXCLUDED(topic_filter_expression_table_mtx_);
 
   void prepareHeartbeatData(HeartbeatRequest& request) override;
 
+  /**
+   * @brief Backlog of queues pulled from, as of the last lag sample.
+   */
+  std::vector<QueueLag> queueLags() const;
+
 protected:
   std::shared_ptr<ClientImpl> self() override {
     return shared_from_this();
@@ -55,6 +72,29 @@ protected:
   void notifyClientTermination() override;
 
   MessageModel message_model_{MessageModel::CLUSTERING};
+
+private:
+  absl::flat_hash_map<std::string, FilterExpression>
+      topic_filter_expression_table_ GUARDED_BY(topic_filter_expression_table_mtx_);
+  absl::Mutex topic_filter_expression_table_mtx_;
+
+  /**
+   * @brief Offset to pull next from each queue, as of the latest successful pull; messages before it are handed over
+   * to application and thus regarded as consumed.
+   */
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> pulled_offsets_ GUARDED_BY(pulled_offsets_mtx_);
+  absl::Mutex pulled_offsets_mtx_;
+
+  LagSamplerSharedPtr lag_sampler_;
+  std::uint32_t lag_sample_handle_{0};
+  static const char* LAG_SAMPLE_TASK_NAME;
+
+  void pulled(const MQMessageQueue& message_queue, std::int64_t next_offset) LOCKS_EXCLUDED(pulled_offsets_mtx_);
+
+  /**
+   * @brief Log lag of the previous sample, then sample again from pulled offsets.
+   */
+  void sampleLag() LOCKS_EXCLUDED(pulled_offsets_mtx_);
 };
 
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -16,12 +16,14 @@
  */
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <system_error>
 
 #include "Consumer.h"
 #include "ProcessQueue.h"
+#include "absl/time/time.h"
 #include "rocketmq/Executor.h"
 #include "rocketmq/MessageListener.h"
 #include "rocketmq/MessageModel.h"
@@ -50,6 +52,27 @@ public:
   virtual bool receiveMessage(const MQMessageQueue& message_queue, const FilterExpression& filter_expression) = 0;
 
   virtual MessageListener* messageListener() = 0;
+
+  /**
+   * @brief Duration that received messages stay invisible to other consumers before broker redelivers them.
+   */
+  virtual std::chrono::milliseconds invisibleDuration() const = 0;
+
+  /**
+   * @brief Start tracking received messages so that their invisible duration is extended while being consumed.
+   */
+  virtual void trackInflight(const std::vector<MQMessageExt>& messages) = 0;
+
+  /**
+   * @brief Time after which broker redelivers the given message, taking invisible-duration renewals into account.
+   */
+  virtual absl::Time invisibleDeadline(const MQMessageExt& message) = 0;
+
+  /**
+   * @brief Make received but unconsumed messages visible again right away, such that broker redelivers them without
+   * waiting for their invisible duration to elapse.
+   */
+  virtual void release(const std::vector<MQMessageExt>& messages) = 0;
 };
 
 using PushConsumerSharedPtr = std::shared_ptr<PushConsumer>;
@@ -16,26 +16,36 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <system_error>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 
 #include "ClientConfigImpl.h"
 #include "ClientImpl.h"
 #include "ClientManagerImpl.h"
 #include "ConsumeMessageService.h"
+#include "ConsumeRetryPolicy.h"
 #include "FilterExpression.h"
+#include "InflightMessageTable.h"
+#include "LagSampler.h"
 #include "ProcessQueue.h"
 #include "PushConsumer.h"
 #include "Scheduler.h"
+#include "StartupTracker.h"
 #include "TopicAssignmentInfo.h"
 #include "TopicPublishInfo.h"
 #include "UtilAll.h"
 #include "apache/rocketmq/v1/service.pb.h"
 #include "rocketmq/DefaultMQPushConsumer.h"
+#include "rocketmq/DuplicateAction.h"
 #include "rocketmq/OffsetStore.h"
 #include "rocketmq/State.h"
 
@@ -53,8 +63,22 @@ public:
 
   void prepareHeartbeatData(HeartbeatRequest& request) override LOCKS_EXCLUDED(topic_filter_expression_table_mtx_);
 
+  /**
+   * @brief Start and block until the first round of assignments completes, or startup_timeout_ elapses, whichever
+   * comes first. Stages still pending by then are logged, and start-up goes on in the background.
+   */
   void start() override;
 
+  /**
+   * @brief Start without waiting for routes and assignments.
+   *
+   * Route of every subscribed topic is fetched in parallel and its assignment queried as soon as the route arrives,
+   * with process queues spun up right away.
+   *
+   * @return Future that becomes ready once every subscribed topic completes, or fails, its first assignment round.
+   */
+  std::future<void> startAsync();
+
   void shutdown() override;
 
   void subscribe(const std::string& topic, const std::string& expression,
@@ -91,7 +115,8 @@ public:
                        const std::function<void(const std::error_code&, const TopicAssignmentPtr&)>& cb);
 
   void syncProcessQueue(const std::string& topic, const TopicAssignmentPtr& topic_assignment,
-                        const FilterExpression& filter_expression) LOCKS_EXCLUDED(process_queue_table_mtx_);
+                        const FilterExpression& filter_expression)
+      LOCKS_EXCLUDED(process_queue_table_mtx_, applied_assignments_mtx_);
 
   ProcessQueueSharedPtr getOrCreateProcessQueue(const MQMessageQueue& message_queue,
                                                 const FilterExpression& filter_expression)
@@ -100,14 +125,123 @@ public:
   bool receiveMessage(const MQMessageQueue& message_queue, const FilterExpression& filter_expression) override
       LOCKS_EXCLUDED(process_queue_table_mtx_);
 
+  /**
+   * @brief Stop receiving messages from all queues of the topic, keeping their assignments and cached messages.
+   */
+  void pause(const std::string& topic) LOCKS_EXCLUDED(paused_table_mtx_, process_queue_table_mtx_);
+
+  void pause(const MQMessageQueue& message_queue) LOCKS_EXCLUDED(paused_table_mtx_, process_queue_table_mtx_);
+
+  /**
+   * @brief Resume receiving from all queues of the topic, including queues paused individually. Parked queues issue
+   * receive requests right away.
+   */
+  void resume(const std::string& topic) LOCKS_EXCLUDED(paused_table_mtx_, process_queue_table_mtx_);
+
+  /**
+   * @brief Resume receiving from the queue, unless its topic remains paused.
+   */
+  void resume(const MQMessageQueue& message_queue) LOCKS_EXCLUDED(paused_table_mtx_, process_queue_table_mtx_);
+
+  bool paused(const MQMessageQueue& message_queue) LOCKS_EXCLUDED(paused_table_mtx_);
+
+  std::vector<QueueLag> queueLags() const;
+
+  /**
+   * @brief Log lag of the previous sample, then sample again from offsets of process queues. Expected to be called
+   * periodically.
+   *
+   * Consumed position of a queue is the offset following the last message pulled, in broadcasting mode, or received,
+   * in clustering mode, less messages still cached.
+   */
+  void sampleLag() LOCKS_EXCLUDED(process_queue_table_mtx_);
+
   uint32_t consumeThreadPoolSize() const;
 
   void consumeThreadPoolSize(int thread_pool_size);
 
+  uint32_t maxConsumeThreadPoolSize() const;
+
+  /**
+   * @brief Allow the consume thread pool to grow beyond consumeThreadPoolSize() under load. If it is not greater than
+   * consumeThreadPoolSize(), the pool keeps a fixed size.
+   */
+  void maxConsumeThreadPoolSize(int max_thread_pool_size);
+
+  const ConsumeRetryPolicy& consumeRetryPolicy() const {
+    return consume_retry_policy_;
+  }
+
+  /**
+   * @brief Re-consume messages failed by standard listeners locally, with exponential backoff, before nacking them to
+   * broker. Local attempts are bounded by the invisible window of each message.
+   *
+   * @param max_local_attempts Maximum number of local attempts per message; 0 disables local retry.
+   * @param initial_backoff Backoff before the first local attempt, doubled for each subsequent attempt.
+   */
+  void consumeRetryPolicy(uint32_t max_local_attempts, std::chrono::milliseconds initial_backoff);
+
+  /**
+   * @brief Suppress redeliveries of messages consumed successfully within the window.
+   *
+   * @param window How long ids of consumed messages are remembered; zero disables deduplication.
+   * @param capacity Maximum number of ids remembered, bounding memory footprint.
+   * @param action Whether to drop duplicates or hand them to the listener flagged.
+   */
+  void deduplication(std::chrono::milliseconds window, std::size_t capacity, DuplicateAction action);
+
   int32_t maxDeliveryAttempts() const override {
     return max_delivery_attempts_;
   }
 
+  std::chrono::milliseconds invisibleDuration() const override {
+    return invisible_duration_;
+  }
+
+  /**
+   * @brief Shorter invisible duration gets messages of a failed consumer redelivered sooner; longer one spares
+   * renewals for slow listeners. Invisible duration of in-flight messages is extended automatically either way.
+   */
+  void invisibleDuration(std::chrono::milliseconds invisible_duration);
+
+  void trackInflight(const std::vector<MQMessageExt>& messages) override;
+
+  absl::Time invisibleDeadline(const MQMessageExt& message) override;
+
+  /**
+   * @brief Extend invisible duration of in-flight messages nearing expiry, in one request per broker. Expected to be
+   * called periodically.
+   */
+  void renewInvisibleDuration();
+
+  void release(const std::vector<MQMessageExt>& messages) override;
+
+  /**
+   * Expose for test purpose only.
+   */
+  std::size_t inflightMessages() const {
+    return inflight_messages_.size();
+  }
+
+  std::chrono::milliseconds drainTimeout() const {
+    return drain_timeout_;
+  }
+
+  std::chrono::milliseconds startupTimeout() const {
+    return startup_timeout_;
+  }
+
+  /**
+   * @brief Bound the time start() blocks waiting for the first round of assignments.
+   */
+  void startupTimeout(std::chrono::milliseconds startup_timeout);
+
+  /**
+   * @brief Bound the time shutdown spends draining: waiting for in-flight listener calls and acknowledgements to
+   * complete while releasing unconsumed messages back to broker. Zero skips draining.
+   */
+  void drainTimeout(std::chrono::milliseconds drain_timeout);
+
   uint32_t consumeBatchSize() const override;
 
   void consumeBatchSize(uint32_t consume_batch_size);
@@ -186,6 +320,11 @@ protected:
   void notifyClientTermination() override;
 
 private:
+  /**
+   * @brief Wait, up to drain_timeout_, until consumption in progress completes and unconsumed messages are released.
+   */
+  void drain();
+
   absl::flat_hash_map<std::string, FilterExpression>
       topic_filter_expression_table_ GUARDED_BY(topic_filter_expression_table_mtx_);
   mutable absl::Mutex topic_filter_expression_table_mtx_;
@@ -195,6 +334,11 @@ private:
    */
   uint32_t consume_thread_pool_size_{MixAll::DEFAULT_CONSUME_THREAD_POOL_SIZE};
 
+  /**
+   * Upper bound of the consume thread pool size. 0 means the pool is fixed-sized.
+   */
+  uint32_t max_consume_thread_pool_size_{0};
+
   MessageListener* message_listener_{nullptr};
 
   std::shared_ptr<ConsumeMessageService> consume_message_service_;
@@ -205,6 +349,60 @@ private:
   std::uintptr_t scan_assignment_handle_{0};
   static const char* SCAN_ASSIGNMENT_TASK_NAME;
 
+  /**
+   * @brief Assignment the process queues of each topic were last reconciled against. Reconciliation against an equal
+   * assignment is skipped until ASSIGNMENT_RESYNC_INTERVAL elapses, which bounds how late expired queues are replaced.
+   */
+  struct AppliedAssignment {
+    TopicAssignmentPtr assignment;
+    std::chrono::steady_clock::time_point synced_at;
+  };
+  absl::flat_hash_map<std::string, AppliedAssignment> applied_assignments_ GUARDED_BY(applied_assignments_mtx_);
+  absl::Mutex applied_assignments_mtx_;
+  static const std::chrono::seconds ASSIGNMENT_RESYNC_INTERVAL;
+
+  std::uintptr_t adjust_thread_pool_handle_{0};
+  static const char* ADJUST_THREAD_POOL_TASK_NAME;
+
+  ConsumeRetryPolicy consume_retry_policy_;
+
+  std::chrono::milliseconds deduplication_window_{0};
+  std::size_t deduplication_capacity_{0};
+  DuplicateAction duplicate_action_{DuplicateAction::DROP};
+
+  std::uintptr_t consume_stats_handle_{0};
+  static const char* CONSUME_STATS_TASK_NAME;
+
+  LagSamplerSharedPtr lag_sampler_;
+  std::uintptr_t lag_sample_handle_{0};
+  static const char* LAG_SAMPLE_TASK_NAME;
+
+  std::chrono::milliseconds invisible_duration_{MixAll::millisecondsOf(MixAll::DEFAULT_INVISIBLE_TIME_)};
+
+  InflightMessageTable inflight_messages_;
+
+  /**
+   * @brief Cleared once broker turns out not to support changing invisible duration.
+   */
+  std::atomic_bool renew_invisible_duration_{true};
+
+  std::uintptr_t renew_invisible_duration_handle_{0};
+  static const char* RENEW_INVISIBLE_DURATION_TASK_NAME;
+
+  std::chrono::milliseconds drain_timeout_{std::chrono::seconds(5)};
+
+  std::chrono::milliseconds startup_timeout_{std::chrono::seconds(10)};
+
+  /**
+   * @brief Follows the start-up pipeline kicked off by bootstrap().
+   */
+  std::shared_ptr<StartupTracker> startup_tracker_;
+
+  /**
+   * @brief Number of release requests on the wire.
+   */
+  std::atomic<std::uint32_t> pending_releases_{0};
+
   absl::flat_hash_map<MQMessageQueue, ProcessQueueSharedPtr> process_queue_table_ GUARDED_BY(process_queue_table_mtx_);
   absl::Mutex process_queue_table_mtx_;
 
@@ -221,7 +419,19 @@ private:
 
   mutable std::unique_ptr<OffsetStore> offset_store_;
 
-  void fetchRoutes() LOCKS_EXCLUDED(topic_filter_expression_table_mtx_);
+  absl::flat_hash_set<std::string> paused_topics_ GUARDED_BY(paused_table_mtx_);
+  absl::flat_hash_set<MQMessageQueue> paused_queues_ GUARDED_BY(paused_table_mtx_);
+  absl::Mutex paused_table_mtx_ ACQUIRED_AFTER(process_queue_table_mtx_);
+
+  /**
+   * @brief Kick off the start-up pipeline: per topic, fetch route, then query assignment and sync process queues.
+   */
+  std::future<void> bootstrap() LOCKS_EXCLUDED(topic_filter_expression_table_mtx_);
+
+  /**
+   * @brief Apply the pause table to process queues of the topic, restarting receive cycles of those no longer paused.
+   */
+  void syncPauseState(const std::string& topic) LOCKS_EXCLUDED(paused_table_mtx_, process_queue_table_mtx_);
 
   friend class ConsumeMessageService;
   friend class ConsumeFifoMessageService;
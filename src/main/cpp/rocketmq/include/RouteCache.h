@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "TopicRouteData.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * Clients share a route only if they query it from the same access point with the same credentials, such that neither
+ * a route nor an authorization failure leaks to clients that are not entitled to it.
+ */
+struct RouteKey {
+  std::string access_point;
+  std::string access_key;
+  std::string resource_namespace;
+  std::string topic;
+
+  bool operator==(const RouteKey& other) const {
+    return std::tie(access_point, access_key, resource_namespace, topic) ==
+           std::tie(other.access_point, other.access_key, other.resource_namespace, other.topic);
+  }
+
+  bool operator!=(const RouteKey& other) const {
+    return !(*this == other);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const RouteKey& key) {
+    return H::combine(std::move(h), key.access_point, key.access_key, key.resource_namespace, key.topic);
+  }
+};
+
+/**
+ * @brief Process-wide topic route cache, shared by all clients that talk to the same access point with the same
+ * credentials.
+ *
+ * Clients subscribe to the routes they use; an entry lives as long as it has subscribers. Concurrent lookups of an
+ * uncached route, or refreshes of a cached one, are folded into a single query issued through the fetcher of whichever
+ * client comes first. Whenever a query yields a route that differs from the cached one, it is fanned out to every
+ * subscriber.
+ *
+ * Fetchers, listeners and callbacks are always invoked without holding the cache lock.
+ */
+class RouteCache {
+public:
+  using Callback = std::function<void(const std::error_code&, const TopicRouteDataPtr&)>;
+  using Fetcher = std::function<void(const Callback&)>;
+  using Listener = std::function<void(const TopicRouteDataPtr&)>;
+
+  static RouteCache& instance();
+
+  RouteCache() = default;
+
+  RouteCache(const RouteCache&) = delete;
+
+  RouteCache& operator=(const RouteCache&) = delete;
+
+  /**
+   * @return Subscription id, required to unsubscribe.
+   */
+  std::uint64_t subscribe(const RouteKey& key, Listener listener) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Drop the subscription; the entry is evicted along with its last subscriber.
+   */
+  void unsubscribe(const RouteKey& key, std::uint64_t id) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Complete callback with the cached route, querying it through fetcher unless cached or in flight already.
+   *
+   * @param timeout Period after which an in-flight query is considered lost and may be issued again.
+   */
+  void getRoute(const RouteKey& key, const Fetcher& fetcher, const Callback& callback, absl::Duration timeout)
+      LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Re-query the route unless it has been fetched within max_age or a query is in flight.
+   */
+  void refresh(const RouteKey& key, const Fetcher& fetcher, absl::Duration max_age, absl::Duration timeout)
+      LOCKS_EXCLUDED(mtx_);
+
+  TopicRouteDataPtr route(const RouteKey& key) const LOCKS_EXCLUDED(mtx_);
+
+  std::size_t subscribers(const RouteKey& key) const LOCKS_EXCLUDED(mtx_);
+
+private:
+  struct Entry {
+    TopicRouteDataPtr route;
+    absl::Time fetched_at{absl::InfinitePast()};
+
+    bool fetching{false};
+    absl::Time fetch_started_at{absl::InfinitePast()};
+    std::vector<Callback> callbacks;
+
+    absl::flat_hash_map<std::uint64_t, Listener> listeners;
+  };
+
+  absl::flat_hash_map<RouteKey, Entry> entries_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+  std::uint64_t next_subscription_id_ GUARDED_BY(mtx_){0};
+
+  void fetch(const RouteKey& key, const Fetcher& fetcher);
+
+  void onRouteFetched(const RouteKey& key, const std::error_code& ec, const TopicRouteDataPtr& route)
+      LOCKS_EXCLUDED(mtx_);
+};
+
+ROCKETMQ_NAMESPACE_END
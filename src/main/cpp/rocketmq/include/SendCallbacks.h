@@ -21,9 +21,11 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "apache/rocketmq/v1/service.grpc.pb.h"
 #include "opencensus/trace/span.h"
 
+#include "CountdownLatch.h"
 #include "TransactionImpl.h"
 #include "rocketmq/AsyncCallback.h"
 #include "rocketmq/ErrorCode.h"
@@ -64,11 +66,9 @@ public:
   }
 
 private:
-  absl::Mutex mtx_;
-  absl::CondVar cv_;
-  bool completed_{false};
   SendResult send_result_;
   std::error_code ec_;
+  CountdownLatch latch_{1};
 };
 
 class ProducerImpl;
@@ -76,9 +76,10 @@ class ProducerImpl;
 class RetrySendCallback : public SendCallback {
 public:
   RetrySendCallback(std::weak_ptr<ProducerImpl> producer, MQMessage message, int max_attempt_times,
-                    SendCallback* callback, std::vector<MQMessageQueue> candidates)
+                    absl::Time deadline, SendCallback* callback, std::vector<MQMessageQueue> candidates)
       : producer_(std::move(producer)), message_(std::move(message)), max_attempt_times_(max_attempt_times),
-        callback_(callback), candidates_(std::move(candidates)), span_(opencensus::trace::Span::BlankSpan()) {
+        deadline_(deadline), callback_(callback), candidates_(std::move(candidates)),
+        span_(opencensus::trace::Span::BlankSpan()) {
   }
 
   void onSuccess(SendResult& send_result) noexcept override;
@@ -93,6 +94,13 @@ public:
     return attempt_times_;
   }
 
+  /**
+   * @brief Time budget left for the current and following attempts.
+   */
+  absl::Duration remaining() const {
+    return deadline_ - absl::Now();
+  }
+
   const MQMessageQueue& messageQueue() const {
     int index = attempt_times_ % candidates_.size();
     return candidates_[index];
@@ -107,6 +115,12 @@ private:
   MQMessage message_;
   int attempt_times_{0};
   int max_attempt_times_;
+
+  /**
+   * @brief Deadline of the whole send operation, shared by all attempts.
+   */
+  absl::Time deadline_;
+
   SendCallback* callback_{nullptr};
 
   /**
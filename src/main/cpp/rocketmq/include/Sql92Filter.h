@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MessageFilter.h"
+#include "absl/container/flat_hash_set.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief SQL92 filter expression compiled into bytecode of a small stack machine, evaluated over message properties.
+ *
+ * Supported syntax is the subset accepted by brokers: comparisons (=, <>, <, <=, >, >=), [NOT] BETWEEN ... AND ...,
+ * [NOT] IN (...), IS [NOT] NULL, AND, OR, NOT and parentheses over identifiers, string, numeric and boolean literals.
+ * Identifiers resolve to user properties of the message, except TAGS, which resolves to its tag. Evaluation follows
+ * the three-valued logic of SQL: a missing property yields NULL and only expressions evaluated to TRUE are accepted.
+ */
+class Sql92Filter : public MessageFilter {
+public:
+  /**
+   * @brief Compile the given expression.
+   *
+   * @param expression SQL92 expression.
+   * @param error Reason of failure, if any.
+   * @return Compiled filter, or nullptr if the expression is malformed.
+   */
+  static std::unique_ptr<Sql92Filter> compile(const std::string& expression, std::string& error);
+
+  bool accept(const MQMessageExt& message) const override;
+
+  enum class OpCode : std::uint8_t
+  {
+    PushConstant,
+    LoadProperty,
+    LoadTag,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    IsNull,
+    IsNotNull,
+    Between,
+    NotBetween,
+    In,
+    NotIn,
+    Not,
+    And,
+    Or,
+    JumpIfFalse,
+    JumpIfTrue,
+  };
+
+  struct Instruction {
+    OpCode op_code;
+    std::uint32_t operand;
+  };
+
+  enum class ValueType : std::uint8_t
+  {
+    Null,
+    Boolean,
+    Long,
+    Double,
+    String,
+  };
+
+  struct Value {
+    ValueType type{ValueType::Null};
+    bool boolean{false};
+    std::int64_t long_value{0};
+    double double_value{0};
+    const std::string* string{nullptr};
+  };
+
+  const std::vector<Instruction>& instructions() const {
+    return instructions_;
+  }
+
+private:
+  friend class Sql92Compiler;
+
+  Sql92Filter() = default;
+
+  std::vector<Instruction> instructions_;
+  std::vector<Value> constants_;
+
+  /**
+   * @brief Storage of string literals, referred by constants_.
+   */
+  std::vector<std::unique_ptr<std::string>> strings_;
+
+  std::vector<std::string> properties_;
+  std::vector<absl::flat_hash_set<std::string>> sets_;
+  std::size_t max_stack_depth_{0};
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Follows the start-up pipeline of a push consumer, in which route of each subscribed topic is fetched and its
+ * assignment queried as soon as the route arrives, all topics in parallel.
+ *
+ * The consumer is ready once every topic has either completed its first assignment round or failed it; failed topics
+ * are retried by the periodic assignment scan. Readiness is signalled through a future, and a start-latency breakdown
+ * is logged at the same time.
+ */
+class StartupTracker {
+public:
+  explicit StartupTracker(const std::vector<std::string>& topics, absl::Time start = absl::Now());
+
+  /**
+   * @brief Can be called only once.
+   */
+  std::future<void> readiness();
+
+  /**
+   * @brief Route of the topic is resolved. A failure completes the topic.
+   */
+  void routeFetched(const std::string& topic, bool ok, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief First assignment round of the topic completes.
+   */
+  void assigned(const std::string& topic, bool ok, absl::Time now = absl::Now()) LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Remove hosts that have been contacted earlier in the start-up from the given set, marking the rest as
+   * contacted.
+   */
+  void firstContact(absl::flat_hash_set<std::string>& hosts) LOCKS_EXCLUDED(mtx_);
+
+  bool ready() const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Describe which stage each topic that is not yet complete waits for, e.g. "route of T0, assignment of T1".
+   */
+  void pendingStages(std::string& stages) const LOCKS_EXCLUDED(mtx_);
+
+  /**
+   * @brief Slowest route fetch, slowest assignment query measured from arrival of the route of the same topic, and
+   * elapsed time until ready.
+   */
+  void report(std::string& stats) const LOCKS_EXCLUDED(mtx_);
+
+private:
+  const absl::Time start_;
+  std::size_t topics_;
+
+  absl::flat_hash_set<std::string> pending_ GUARDED_BY(mtx_);
+  absl::flat_hash_map<std::string, absl::Time> route_arrivals_ GUARDED_BY(mtx_);
+  absl::flat_hash_set<std::string> contacted_hosts_ GUARDED_BY(mtx_);
+
+  absl::Duration route_latency_ GUARDED_BY(mtx_);
+  absl::Duration assignment_latency_ GUARDED_BY(mtx_);
+  absl::Duration ready_latency_ GUARDED_BY(mtx_);
+  std::size_t failed_ GUARDED_BY(mtx_){0};
+
+  mutable absl::Mutex mtx_;
+
+  std::promise<void> promise_;
+
+  void complete(const std::string& topic, bool ok, absl::Time now) EXCLUSIVE_LOCKS_REQUIRED(mtx_);
+
+  void format(std::string& stats) const EXCLUSIVE_LOCKS_REQUIRED(mtx_);
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+#include "ThreadPoolImpl.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * @brief Run local transaction state checks on dedicated threads, such that a slow checker never stalls command
+ * handling or heartbeats of the client.
+ *
+ * A check stays pending from submission until its task invokes the completion it is given, normally once the resolution
+ * is reported to broker. Checks submitted for a transaction that is pending already are dropped, and so are checks
+ * beyond capacity; broker re-issues the command for transactions that remain unresolved.
+ */
+class TransactionCheckExecutor : public std::enable_shared_from_this<TransactionCheckExecutor> {
+public:
+  using Completion = std::function<void(void)>;
+  using Task = std::function<void(const Completion&)>;
+
+  TransactionCheckExecutor(std::uint16_t workers, std::size_t capacity);
+
+  void start();
+
+  void shutdown();
+
+  /**
+   * @return false if the check is dropped, either because one for the same transaction is pending or because the
+   * executor is at capacity.
+   */
+  bool submit(const std::string& transaction_id, Task task) LOCKS_EXCLUDED(mtx_);
+
+  std::size_t pending() const LOCKS_EXCLUDED(mtx_);
+
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+  /**
+   * @brief Report submissions, drops and check latency since last call.
+   */
+  void reportAndReset(std::string& stats);
+
+private:
+  std::unique_ptr<ThreadPoolImpl> pool_;
+  const std::size_t capacity_;
+
+  absl::flat_hash_set<std::string> pending_ GUARDED_BY(mtx_);
+  mutable absl::Mutex mtx_;
+
+  std::atomic<std::uint64_t> accepted_{0};
+  std::atomic<std::uint64_t> deduplicated_{0};
+  std::atomic<std::uint64_t> rejected_{0};
+  std::atomic<std::uint64_t> completed_{0};
+  std::atomic<std::int64_t> max_latency_{0};
+
+  void complete(const std::string& transaction_id, std::chrono::steady_clock::time_point submitted)
+      LOCKS_EXCLUDED(mtx_);
+};
+
+ROCKETMQ_NAMESPACE_END
@@ -47,6 +47,14 @@ public:
 
   MOCK_METHOD(MessageListener*, messageListener, (), (override));
 
+  MOCK_METHOD(std::chrono::milliseconds, invisibleDuration, (), (const override));
+
+  MOCK_METHOD(void, trackInflight, (const std::vector<MQMessageExt>&), (override));
+
+  MOCK_METHOD(void, release, (const std::vector<MQMessageExt>&), (override));
+
+  MOCK_METHOD(absl::Time, invisibleDeadline, (const MQMessageExt&), (override));
+
   MOCK_METHOD(void, setOffsetStore, (std::unique_ptr<OffsetStore>), (override));
 };
 
@@ -31,8 +31,11 @@
 #include "asio/executor_work_guard.hpp"
 #include "asio/io_context.hpp"
 #include "asio/steady_timer.hpp"
+#include "fmt/format.h"
 #include "spdlog/spdlog.h"
 
+#include "ThreadPlacement.h"
+
 ROCKETMQ_NAMESPACE_BEGIN
 
 SchedulerImpl::SchedulerImpl(std::uint32_t worker_num)
@@ -52,7 +55,8 @@ void SchedulerImpl::start() {
   State expected = State::CREATED;
   if (state_.compare_exchange_strong(expected, State::STARTING, std::memory_order_relaxed)) {
     for (std::uint32_t i = 0; i < worker_num_; i++) {
-      auto worker = std::thread([this]() {
+      auto worker = std::thread([this, i]() {
+        ThreadPlacement::apply(ThreadRole::Scheduler, fmt::format("rmq-scheduler-{}", i));
         {
           State expect = State::STARTING;
           if (state_.compare_exchange_strong(expect, State::STARTED, std::memory_order_relaxed)) {
@@ -162,7 +166,7 @@ void SchedulerImpl::execute(const asio::error_code& ec, std::weak_ptr<TimerTask>
     return;
   }
 
-  SPDLOG_INFO("Execute task: {}. Use-count: {}", timer_task->task_name, timer_task.use_count());
+  SPDLOG_DEBUG("Execute task: {}. Use-count: {}", timer_task->task_name, timer_task.use_count());
 
   // Execute the actual callback.
 #ifdef __EXCEPTIONS
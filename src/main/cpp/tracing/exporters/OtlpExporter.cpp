@@ -19,6 +19,7 @@
 #include "InvocationContext.h"
 #include "MixAll.h"
 #include "Signature.h"
+#include "ThreadPlacement.h"
 #include "UtilAll.h"
 #include "absl/strings/str_split.h"
 #include "fmt/format.h"
@@ -122,6 +123,8 @@ void OtlpExporterHandler::syncExportClients() {
 }
 
 void OtlpExporterHandler::poll() {
+  ThreadPlacement::apply(ThreadRole::Exporter, "rmq-otlp-poller");
+
   {
     // Notify main thread that the poller thread has started
     absl::MutexLock lk(&start_mtx_);
@@ -404,11 +407,9 @@ void OtlpExporterHandler::Export(const std::vector<::opencensus::trace::exporter
   auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(3);
   invocation_context->context.set_deadline(deadline);
 
-  absl::flat_hash_map<std::string, std::string> metadata;
+  Metadata metadata;
   Signature::sign(exp->clientConfig(), metadata);
-  for (const auto& entry : metadata) {
-    invocation_context->context.AddMetadata(entry.first, entry.second);
-  }
+  metadata.attach(invocation_context->context);
   auto callback = [](const InvocationContext<collector_trace::ExportTraceServiceResponse>* invocation_context) {
     if (invocation_context->status.ok()) {
       SPDLOG_DEBUG("Export tracing spans OK, target={}", invocation_context->remote_address);
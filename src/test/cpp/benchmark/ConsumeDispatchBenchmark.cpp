@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+
+#include "ConsumeInvoker.h"
+#include "benchmark/benchmark.h"
+#include "rocketmq/MQMessageExt.h"
+#include "rocketmq/MessageListener.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class NoopStandardListener : public StandardMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const std::vector<MQMessageExt>& msgs) override {
+    benchmark::DoNotOptimize(msgs.data());
+    return ConsumeMessageResult::SUCCESS;
+  }
+};
+
+class NoopFifoListener : public FifoMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const MQMessageExt& msg) override {
+    benchmark::DoNotOptimize(&msg);
+    return ConsumeMessageResult::SUCCESS;
+  }
+};
+
+static MQMessageExt sampleMessage() {
+  MQMessageExt message;
+  message.setTopic("TopicTest");
+  message.setTags("TagA");
+  message.setKey("Key-0");
+  message.setBody(std::string(1024, 'x'));
+  return message;
+}
+
+// Dispatch as done previously: inspect listener type, down-cast and wrap the message into a temporary vector.
+static ConsumeMessageResult legacyDispatch(MessageListener* listener, const MQMessageExt& message) {
+  if (MessageListenerType::FIFO == listener->listenerType()) {
+    return dynamic_cast<FifoMessageListener*>(listener)->consumeMessage(message);
+  }
+  return dynamic_cast<StandardMessageListener*>(listener)->consumeMessage({message});
+}
+
+static void BM_LegacyDispatchStandard(benchmark::State& state) {
+  NoopStandardListener listener;
+  MQMessageExt message = sampleMessage();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(legacyDispatch(&listener, message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LegacyDispatchStandard);
+
+static void BM_InvokerDispatchStandard(benchmark::State& state) {
+  NoopStandardListener listener;
+  ConsumeInvoker invoker(&listener);
+  std::vector<MQMessageExt> slot{sampleMessage()};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(invoker(slot));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InvokerDispatchStandard);
+
+static void BM_LegacyDispatchFifo(benchmark::State& state) {
+  NoopFifoListener listener;
+  MQMessageExt message = sampleMessage();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(legacyDispatch(&listener, message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LegacyDispatchFifo);
+
+static void BM_InvokerDispatchFifo(benchmark::State& state) {
+  NoopFifoListener listener;
+  ConsumeInvoker invoker(&listener);
+  std::vector<MQMessageExt> slot{sampleMessage()};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(invoker(slot));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InvokerDispatchFifo);
+
+ROCKETMQ_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+
+#include "FilterExpression.h"
+#include "benchmark/benchmark.h"
+#include "rocketmq/MQMessageExt.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+static MQMessageExt sampleMessage() {
+  MQMessageExt message;
+  message.setTags("TagC");
+  message.setProperty("a", "42");
+  message.setProperty("region", "hz");
+  message.setProperty("vip", "true");
+  message.setProperty("trace", "0af7651916cd43dd8448eb211c80319c");
+  return message;
+}
+
+static void BM_TagFilter(benchmark::State& state) {
+  FilterExpression filter_expression("TagA || TagB || TagC || TagD");
+  MQMessageExt message = sampleMessage();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter_expression.accept(message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TagFilter);
+
+static void BM_Sql92Filter(benchmark::State& state) {
+  FilterExpression filter_expression("a BETWEEN 10 AND 100 AND region IN ('hz', 'sh') AND vip = TRUE",
+                                     ExpressionType::SQL92);
+  MQMessageExt message = sampleMessage();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter_expression.accept(message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sql92Filter);
+
+static void BM_Sql92FilterShortCircuit(benchmark::State& state) {
+  FilterExpression filter_expression("region = 'bj' AND a BETWEEN 10 AND 100 AND vip = TRUE", ExpressionType::SQL92);
+  MQMessageExt message = sampleMessage();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter_expression.accept(message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sql92FilterShortCircuit);
+
+ROCKETMQ_NAMESPACE_END
+
+BENCHMARK_MAIN();
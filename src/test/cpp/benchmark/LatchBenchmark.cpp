@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <limits>
+
+#include "CountdownLatch.h"
+#include "absl/synchronization/mutex.h"
+#include "benchmark/benchmark.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+// The mutex-guarded latch CountdownLatch used to be, kept here as the baseline.
+class MutexLatch {
+public:
+  explicit MutexLatch(int32_t count) : count_(count) {
+  }
+
+  void await() LOCKS_EXCLUDED(mtx_) {
+    absl::MutexLock lock(&mtx_);
+    while (count_ > 0) {
+      cv_.Wait(&mtx_);
+    }
+  }
+
+  void countdown() LOCKS_EXCLUDED(mtx_) {
+    absl::MutexLock lock(&mtx_);
+    if (--count_ <= 0) {
+      cv_.SignalAll();
+    }
+  }
+
+  void increaseCount() LOCKS_EXCLUDED(mtx_) {
+    absl::MutexLock lock(&mtx_);
+    ++count_;
+  }
+
+private:
+  int32_t count_ GUARDED_BY(mtx_);
+  absl::Mutex mtx_;
+  absl::CondVar cv_;
+};
+
+// Many threads hammering one latch, as a batch of in-flight requests completing at once does.
+template <typename Latch>
+static void BM_ContendedCountdown(benchmark::State& state) {
+  static Latch latch(std::numeric_limits<int32_t>::max() / 2);
+  for (auto _ : state) {
+    latch.increaseCount();
+    latch.countdown();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ContendedCountdown, MutexLatch)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_ContendedCountdown, CountdownLatch)->ThreadRange(1, 8);
+
+// One-shot future use: callback completes, then the caller awaits the result.
+template <typename Latch>
+static void BM_OneShot(benchmark::State& state) {
+  for (auto _ : state) {
+    Latch latch(1);
+    latch.countdown();
+    latch.await();
+    benchmark::DoNotOptimize(latch);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_OneShot, MutexLatch);
+BENCHMARK_TEMPLATE(BM_OneShot, CountdownLatch);
+
+ROCKETMQ_NAMESPACE_END
+
+BENCHMARK_MAIN();
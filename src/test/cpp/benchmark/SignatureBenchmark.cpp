@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+
+#include <openssl/hmac.h>
+
+#include "ClientConfigImpl.h"
+#include "MixAll.h"
+#include "OpenSSLCompatible.h"
+#include "Signature.h"
+#include "TlsHelper.h"
+#include "benchmark/benchmark.h"
+#include "rocketmq/CredentialsProvider.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+static std::unique_ptr<ClientConfigImpl> signedClientConfig() {
+  std::unique_ptr<ClientConfigImpl> client_config(new ClientConfigImpl("benchmark-group"));
+  client_config->resourceNamespace("MQ_INST_benchmark");
+  client_config->region("cn-hangzhou");
+  client_config->setCredentialsProvider(std::make_shared<StaticCredentialsProvider>("access-key", "access-secret"));
+  return client_config;
+}
+
+// What TlsHelper::sign used to be, kept here as the baseline: a fresh context and digest buffer per call.
+static std::string freshHmac(const std::string& access_secret, const std::string& content) {
+  HMAC_CTX* ctx = HMAC_CTX_new();
+  HMAC_Init_ex(ctx, access_secret.c_str(), access_secret.length(), EVP_sha1(), nullptr);
+  HMAC_Update(ctx, reinterpret_cast<const unsigned char*>(content.c_str()), content.length());
+  auto result = new unsigned char[EVP_MD_size(EVP_sha1())];
+  unsigned int len;
+  HMAC_Final(ctx, result, &len);
+  HMAC_CTX_free(ctx);
+
+  std::string hex_str = MixAll::hex(result, len);
+  delete[] result;
+  return hex_str;
+}
+
+// What every RPC paid previously: a fresh HMAC over the date-time.
+static void BM_HmacPerRequest(benchmark::State& state) {
+  const std::string content = "20211103T101010Z";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(freshHmac("access-secret", content));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HmacPerRequest)->ThreadRange(1, 8);
+
+// HMAC over a context kept per thread and re-keyed only when the secret changes.
+static void BM_KeyedHmac(benchmark::State& state) {
+  const std::string content = "20211103T101010Z";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TlsHelper::sign("access-secret", content));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeyedHmac)->ThreadRange(1, 8);
+
+// Cost per RPC should stay flat as the rate, emulated by threads signing back to back, rises.
+static void BM_Sign(benchmark::State& state) {
+  static std::unique_ptr<ClientConfigImpl> client_config = signedClientConfig();
+  for (auto _ : state) {
+    absl::flat_hash_map<std::string, std::string> metadata;
+    Signature::sign(client_config.get(), metadata);
+    benchmark::DoNotOptimize(metadata);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sign)->ThreadRange(1, 8);
+
+ROCKETMQ_NAMESPACE_END
+
+BENCHMARK_MAIN();
@@ -56,4 +56,16 @@ TEST_F(HistogramTest, testHistogram) {
   EXPECT_STREQ(result.c_str(), expect.c_str());
 }
 
+TEST_F(HistogramTest, testReport) {
+  histogram_.countIn(1);
+
+  std::string result;
+  histogram_.report(result);
+  EXPECT_EQ("Test:Foo: 0, Bar: 1, Baz: 0", result);
+
+  // Counts are kept.
+  histogram_.report(result);
+  EXPECT_EQ("Test:Foo: 0, Bar: 1, Baz: 0", result);
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LockContention.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/base/internal/cycleclock.h"
+#include "absl/strings/match.h"
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class LockContentionTest : public testing::Test {
+public:
+  void SetUp() override {
+    LockContention::instance().enable();
+    std::string discard;
+    LockContention::instance().report(discard, true);
+  }
+
+  void TearDown() override {
+    LockContention::instance().untrack(&mtx_);
+  }
+
+protected:
+  absl::Mutex mtx_;
+  std::int64_t cycles_per_ms_{static_cast<std::int64_t>(absl::base_internal::CycleClock::Frequency() / 1000)};
+};
+
+TEST_F(LockContentionTest, testAttribution) {
+  auto& profiler = LockContention::instance();
+  profiler.track(&mtx_, "LockContentionTest::mtx_");
+  profiler.onContention(&mtx_, 5 * cycles_per_ms_ - 1);
+
+  absl::Mutex untracked;
+  profiler.onContention(&untracked, 1);
+
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "sites=2"));
+  EXPECT_TRUE(absl::StrContains(report, "LockContentionTest::mtx_: contentions=1, wait=4"));
+  EXPECT_TRUE(absl::StrContains(report, "[1ms~10ms): 1"));
+  EXPECT_TRUE(absl::StrContains(report, "other: contentions=1"));
+
+  // Most waited-on site goes first.
+  EXPECT_LT(report.find("LockContentionTest::mtx_"), report.find("other"));
+
+  profiler.report(report, true);
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "sites=0"));
+}
+
+TEST_F(LockContentionTest, testUntrack) {
+  auto& profiler = LockContention::instance();
+  profiler.track(&mtx_, "LockContentionTest::mtx_");
+  profiler.untrack(&mtx_);
+  profiler.onContention(&mtx_, cycles_per_ms_);
+
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "other: contentions=1"));
+  EXPECT_FALSE(absl::StrContains(report, "LockContentionTest::mtx_"));
+}
+
+TEST_F(LockContentionTest, testDisable) {
+  auto& profiler = LockContention::instance();
+  profiler.disable();
+  profiler.onContention(&mtx_, cycles_per_ms_);
+  profiler.enable();
+
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "sites=0"));
+}
+
+TEST_F(LockContentionTest, testTracer) {
+  auto& profiler = LockContention::instance();
+  profiler.track(&mtx_, "LockContentionTest::mtx_");
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([this]() {
+      for (int j = 0; j < 1000; j++) {
+        absl::MutexLock lk(&mtx_);
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "LockContentionTest::mtx_: contentions="));
+}
+
+TEST_F(LockContentionTest, testTrackOnlyWhenEnabled) {
+  auto& profiler = LockContention::instance();
+  profiler.disable();
+  profiler.track(&mtx_, "LockContentionTest::mtx_");
+  profiler.enable();
+  profiler.onContention(&mtx_, cycles_per_ms_);
+
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "other: contentions=1"));
+  EXPECT_FALSE(absl::StrContains(report, "LockContentionTest::mtx_"));
+}
+
+TEST_F(LockContentionTest, testReclaimTombstones) {
+  auto& profiler = LockContention::instance();
+  const std::size_t count = 4096;
+  std::unique_ptr<absl::Mutex[]> mutexes(new absl::Mutex[count]);
+  for (int round = 0; round < 4; round++) {
+    for (std::size_t i = 0; i < count; i++) {
+      profiler.track(&mutexes[i], "LockContentionTest::mutexes");
+    }
+
+    // Leave every other slot of clusters deleted.
+    for (std::size_t i = 0; i < count; i += 2) {
+      profiler.untrack(&mutexes[i]);
+    }
+    EXPECT_LT(profiler.tombstones(), count / 2);
+
+    for (std::size_t i = 1; i < count; i += 2) {
+      profiler.untrack(&mutexes[i]);
+    }
+    EXPECT_EQ(0U, profiler.tombstones());
+  }
+
+  // Churn leaves room for others.
+  profiler.track(&mtx_, "LockContentionTest::mtx_");
+  profiler.onContention(&mtx_, cycles_per_ms_);
+  std::string report;
+  profiler.report(report, false);
+  EXPECT_TRUE(absl::StrContains(report, "LockContentionTest::mtx_: contentions=1"));
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MemoryQuota.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+TEST(MemoryQuotaTest, testAccounting) {
+  MemoryQuota memory_quota(1000);
+  memory_quota.acquire(300);
+  memory_quota.acquire(200);
+  EXPECT_EQ(500, memory_quota.used());
+  memory_quota.release(300);
+  EXPECT_EQ(200, memory_quota.used());
+
+  // Over-release is clamped rather than wrapped around.
+  memory_quota.release(300);
+  EXPECT_EQ(0, memory_quota.used());
+}
+
+TEST(MemoryQuotaTest, testNearLimit) {
+  MemoryQuota memory_quota(1000);
+  memory_quota.acquire(899);
+  EXPECT_FALSE(memory_quota.nearLimit());
+  memory_quota.acquire(1);
+  EXPECT_TRUE(memory_quota.nearLimit());
+
+  memory_quota.limit(2000);
+  EXPECT_FALSE(memory_quota.nearLimit());
+}
+
+TEST(MemoryQuotaTest, testUnlimited) {
+  MemoryQuota memory_quota(0);
+  memory_quota.acquire(1 << 30);
+  EXPECT_FALSE(memory_quota.nearLimit());
+}
+
+ROCKETMQ_NAMESPACE_END
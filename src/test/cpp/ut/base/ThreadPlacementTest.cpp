@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ThreadPlacement.h"
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rocketmq/RocketMQ.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+TEST(ThreadPlacementTest, testParseCpuList) {
+  std::vector<int> cpus;
+  ASSERT_TRUE(ThreadPlacement::parseCpuList("0-3, 8,10-11,2", cpus));
+  std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+  ASSERT_EQ(expected, cpus);
+
+  cpus.clear();
+  ASSERT_FALSE(ThreadPlacement::parseCpuList("3-1", cpus));
+  cpus.clear();
+  ASSERT_FALSE(ThreadPlacement::parseCpuList("a-b", cpus));
+  cpus.clear();
+  ASSERT_FALSE(ThreadPlacement::parseCpuList("", cpus));
+}
+
+TEST(ThreadPlacementTest, testFallback) {
+  ThreadPlacement::cpuSet(ThreadRole::Consume, {0});
+  ASSERT_EQ(std::vector<int>{0}, ThreadPlacement::cpuSet(ThreadRole::Callback));
+  ASSERT_EQ(std::vector<int>{0}, ThreadPlacement::cpuSet(ThreadRole::CompletionQueue));
+  ASSERT_TRUE(ThreadPlacement::cpuSet(ThreadRole::Scheduler).empty());
+
+  ThreadPlacement::cpuSet(ThreadRole::Callback, {1});
+  ASSERT_EQ(std::vector<int>{1}, ThreadPlacement::cpuSet(ThreadRole::CompletionQueue));
+
+  ThreadPlacement::cpuSet(ThreadRole::Consume, {});
+  ThreadPlacement::cpuSet(ThreadRole::Callback, {});
+}
+
+TEST(ThreadPlacementTest, testClearFallsBackToEnvironment) {
+  setenv("ROCKETMQ_CPUSET_SCHEDULER", "2-3", 1);
+  ThreadPlacement::cpuSet(ThreadRole::Scheduler, {1});
+  ASSERT_EQ(std::vector<int>{1}, ThreadPlacement::cpuSet(ThreadRole::Scheduler));
+
+  ThreadPlacement::cpuSet(ThreadRole::Scheduler, {});
+  ASSERT_EQ((std::vector<int>{2, 3}), ThreadPlacement::cpuSet(ThreadRole::Scheduler));
+  unsetenv("ROCKETMQ_CPUSET_SCHEDULER");
+}
+
+#if defined(__linux__)
+TEST(ThreadPlacementTest, testApply) {
+  ThreadPlacement::cpuSet(ThreadRole::Consume, {0});
+  std::thread worker([]() {
+    ThreadPlacement::apply(ThreadRole::Consume, "rmq-consume-test-0");
+
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    EXPECT_STREQ("rmq-consume-tes", name);
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    EXPECT_EQ(1, CPU_COUNT(&cpu_set));
+    EXPECT_TRUE(CPU_ISSET(0, &cpu_set));
+  });
+  worker.join();
+  ThreadPlacement::cpuSet(ThreadRole::Consume, {});
+}
+#endif
+
+ROCKETMQ_NAMESPACE_END
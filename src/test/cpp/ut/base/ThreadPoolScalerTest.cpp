@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ThreadPoolScaler.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+#include "ThreadPoolImpl.h"
+#include "rocketmq/RocketMQ.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class ThreadPoolScalerTest : public testing::Test {
+public:
+  void SetUp() override {
+    pool_ = absl::make_unique<ThreadPoolImpl>(1, 4);
+    pool_->start();
+    options_.queueing_delay_threshold = std::chrono::milliseconds(10);
+    options_.backlog_per_worker_threshold = 1;
+    options_.scale_up_ticks = 2;
+    options_.scale_down_ticks = 3;
+  }
+
+  void TearDown() override {
+    release_.Notify();
+    pool_->shutdown();
+  }
+
+protected:
+  std::unique_ptr<ThreadPoolImpl> pool_;
+  ThreadPoolScalerOptions options_;
+  absl::Notification release_;
+};
+
+TEST_F(ThreadPoolScalerTest, testResize) {
+  ASSERT_EQ(1, pool_->workers());
+  pool_->resize(3);
+  ASSERT_EQ(3, pool_->workers());
+
+  // Clamped to [min, max]
+  pool_->resize(16);
+  ASSERT_EQ(4, pool_->workers());
+  pool_->resize(0);
+  ASSERT_EQ(1, pool_->workers());
+
+  // Tasks are still executed by the remaining worker.
+  absl::Notification done;
+  pool_->submit([&done]() { done.Notify(); });
+  ASSERT_TRUE(done.WaitForNotificationWithTimeout(absl::Seconds(3)));
+}
+
+TEST_F(ThreadPoolScalerTest, testScaleUpOnBacklog) {
+  ThreadPoolScaler scaler(*pool_, options_);
+  for (int i = 0; i < 8; i++) {
+    pool_->submit([this]() { release_.WaitForNotification(); });
+  }
+
+  // Pressure must be sustained before the pool grows.
+  scaler.tick();
+  ASSERT_EQ(1, pool_->workers());
+  scaler.tick();
+  ASSERT_EQ(2, pool_->workers());
+  ASSERT_EQ(1, scaler.scaleUpCount());
+
+  scaler.tick();
+  scaler.tick();
+  ASSERT_EQ(3, pool_->workers());
+
+  // Never grow beyond max_workers.
+  for (int i = 0; i < 8; i++) {
+    scaler.tick();
+  }
+  ASSERT_EQ(4, pool_->workers());
+}
+
+TEST_F(ThreadPoolScalerTest, testScaleDownWhenIdle) {
+  ThreadPoolScaler scaler(*pool_, options_);
+  pool_->resize(3);
+
+  scaler.tick();
+  scaler.tick();
+  ASSERT_EQ(3, pool_->workers());
+  scaler.tick();
+  ASSERT_EQ(2, pool_->workers());
+  ASSERT_EQ(1, scaler.scaleDownCount());
+
+  for (int i = 0; i < 16; i++) {
+    scaler.tick();
+  }
+  ASSERT_EQ(1, pool_->workers());
+
+  std::string stats;
+  scaler.reportAndReset(stats);
+  ASSERT_FALSE(stats.empty());
+}
+
+ROCKETMQ_NAMESPACE_END
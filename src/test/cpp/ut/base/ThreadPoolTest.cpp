@@ -17,6 +17,7 @@
 #include "ThreadPoolImpl.h"
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "rocketmq/RocketMQ.h"
 #include "gtest/gtest.h"
 #include <atomic>
@@ -73,4 +74,21 @@ TEST_F(ThreadPoolTest, testBasics) {
   }
 }
 
+TEST_F(ThreadPoolTest, testIdle) {
+  ThreadPoolImpl pool(1);
+  pool.start();
+  EXPECT_TRUE(pool.idle());
+
+  absl::Notification proceed;
+  pool.submit([&proceed]() { proceed.WaitForNotification(); });
+  EXPECT_FALSE(pool.idle());
+
+  proceed.Notify();
+  for (int i = 0; i < 100 && !pool.idle(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(pool.idle());
+  pool.shutdown();
+}
+
 ROCKETMQ_NAMESPACE_END
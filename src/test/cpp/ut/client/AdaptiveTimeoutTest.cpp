@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AdaptiveTimeout.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class AdaptiveTimeoutTest : public testing::Test {
+protected:
+  AdaptiveTimeout adaptive_timeout_{0.9, 2.0, absl::Milliseconds(10), 10, 5};
+  std::string endpoint_{"ipv4:10.0.0.1:8081"};
+  absl::Duration ceiling_{absl::Seconds(3)};
+};
+
+TEST_F(AdaptiveTimeoutTest, testCeilingWithoutEnoughSamples) {
+  EXPECT_EQ(ceiling_, adaptive_timeout_.timeout(endpoint_, ceiling_));
+  for (int i = 0; i < 4; i++) {
+    adaptive_timeout_.record(endpoint_, absl::Milliseconds(20));
+  }
+  EXPECT_EQ(ceiling_, adaptive_timeout_.timeout(endpoint_, ceiling_));
+  adaptive_timeout_.record(endpoint_, absl::Milliseconds(20));
+  EXPECT_EQ(absl::Milliseconds(40), adaptive_timeout_.timeout(endpoint_, ceiling_));
+}
+
+TEST_F(AdaptiveTimeoutTest, testPercentile) {
+  for (int i = 1; i <= 10; i++) {
+    adaptive_timeout_.record(endpoint_, absl::Milliseconds(i * 10));
+  }
+  // P90 of 10ms, 20ms, ..., 100ms is 90ms.
+  EXPECT_EQ(absl::Milliseconds(180), adaptive_timeout_.timeout(endpoint_, ceiling_));
+  EXPECT_EQ(absl::Milliseconds(100), adaptive_timeout_.timeout(endpoint_, absl::Milliseconds(100)));
+}
+
+TEST_F(AdaptiveTimeoutTest, testFloor) {
+  for (int i = 0; i < 10; i++) {
+    adaptive_timeout_.record(endpoint_, absl::Milliseconds(1));
+  }
+  EXPECT_EQ(absl::Milliseconds(10), adaptive_timeout_.timeout(endpoint_, ceiling_));
+}
+
+TEST_F(AdaptiveTimeoutTest, testWindowSlides) {
+  for (int i = 0; i < 10; i++) {
+    adaptive_timeout_.record(endpoint_, absl::Milliseconds(500));
+  }
+  for (int i = 0; i < 10; i++) {
+    adaptive_timeout_.record(endpoint_, absl::Milliseconds(50));
+  }
+  EXPECT_EQ(absl::Milliseconds(100), adaptive_timeout_.timeout(endpoint_, ceiling_));
+}
+
+TEST_F(AdaptiveTimeoutTest, testRemove) {
+  adaptive_timeout_.record(endpoint_, absl::Milliseconds(50));
+  EXPECT_EQ(1, adaptive_timeout_.size());
+  adaptive_timeout_.remove({endpoint_});
+  EXPECT_EQ(0, adaptive_timeout_.size());
+}
+
+ROCKETMQ_NAMESPACE_END
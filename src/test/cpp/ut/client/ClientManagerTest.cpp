@@ -18,7 +18,10 @@
 #include "ReceiveMessageCallbackMock.h"
 #include "RpcClientMock.h"
 #include "apache/rocketmq/v1/definition.pb.h"
+#include "google/rpc/code.pb.h"
+#include "rocketmq/ErrorCode.h"
 #include "gtest/gtest.h"
+#include <chrono>
 #include <memory>
 #include <system_error>
 
@@ -59,6 +62,25 @@ TEST_F(ClientManagerTest, testBasic) {
   // Ensure that start/shutdown works well.
 }
 
+TEST_F(ClientManagerTest, testRejectZeroMemoryQuota) {
+  client_manager_->memoryQuota(1024);
+  EXPECT_EQ(1024U, client_manager_->memoryQuota()->limit());
+
+  client_manager_->memoryQuota(0);
+  EXPECT_EQ(1024U, client_manager_->memoryQuota()->limit());
+}
+
+TEST_F(ClientManagerTest, testShutdownWithLiveConnectivityWatch) {
+  // A real channel, whose connectivity state is watched from creation on, with nothing listening on the other end.
+  ASSERT_TRUE(client_manager_->getRpcClient("ipv4:127.0.0.1:1", false));
+
+  auto start = std::chrono::steady_clock::now();
+  client_manager_->shutdown();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Pending watches are cancelled along with their channels, not waited out to their 10s deadline.
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
 TEST_F(ClientManagerTest, testResolveRoute) {
   auto rpc_cb = [](const QueryRouteRequest& request, InvocationContext<QueryRouteResponse>* invocation_context) {
     auto partition = new rmq::Partition();
@@ -255,6 +277,99 @@ TEST_F(ClientManagerTest, testNack) {
   EXPECT_TRUE(callback_invoked);
 }
 
+TEST_F(ClientManagerTest, testChangeInvisibleDuration) {
+  bool completed = false;
+  absl::Mutex mtx;
+  absl::CondVar cv;
+
+  auto mock_change_invisible_duration = [&](const ChangeInvisibleDurationRequest& request,
+                                            InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) {
+    for (const auto& entry : request.entries()) {
+      auto result = invocation_context->response.add_entries();
+      result->set_message_id(entry.message_id());
+      result->set_receipt_handle(entry.receipt_handle() + "-renewed");
+      result->mutable_status()->set_code(google::rpc::Code::OK);
+    }
+    invocation_context->response.mutable_common()->mutable_status()->set_code(google::rpc::Code::OK);
+    absl::MutexLock lk(&mtx);
+    completed = true;
+    cv.SignalAll();
+    invocation_context->onCompletion(true);
+  };
+
+  EXPECT_CALL(*rpc_client_, asyncChangeInvisibleDuration)
+      .Times(testing::AtLeast(1))
+      .WillRepeatedly(testing::Invoke(mock_change_invisible_duration));
+
+  ChangeInvisibleDurationRequest request;
+  for (int i = 0; i < 2; i++) {
+    auto entry = request.add_entries();
+    entry->mutable_topic()->set_name(topic_);
+    entry->set_message_id("msg-" + std::to_string(i));
+    entry->set_receipt_handle("handle-" + std::to_string(i));
+  }
+  request.mutable_invisible_duration()->set_seconds(30);
+
+  bool callback_invoked = false;
+  std::error_code error_code;
+  std::vector<std::string> receipt_handles;
+  auto callback = [&](const std::error_code& ec, const ChangeInvisibleDurationResponse& response) {
+    callback_invoked = true;
+    error_code = ec;
+    for (const auto& entry : response.entries()) {
+      receipt_handles.push_back(entry.receipt_handle());
+    }
+  };
+
+  client_manager_->changeInvisibleDuration(target_host_, metadata_, request, absl::ToChronoMilliseconds(io_timeout_),
+                                           callback);
+
+  {
+    absl::MutexLock lk(&mtx);
+    if (!completed) {
+      cv.WaitWithDeadline(&mtx, absl::Now() + absl::Seconds(3));
+    }
+  }
+  EXPECT_TRUE(completed);
+  EXPECT_TRUE(callback_invoked);
+  EXPECT_FALSE(error_code);
+  ASSERT_EQ(2, receipt_handles.size());
+  EXPECT_EQ("handle-0-renewed", receipt_handles[0]);
+}
+
+TEST_F(ClientManagerTest, testChangeInvisibleDurationNotFound) {
+  auto mock_change_invisible_duration = [&](const ChangeInvisibleDurationRequest& request,
+                                            InvocationContext<ChangeInvisibleDurationResponse>* invocation_context) {
+    invocation_context->response.mutable_common()->mutable_status()->set_code(google::rpc::Code::NOT_FOUND);
+    invocation_context->onCompletion(true);
+  };
+
+  EXPECT_CALL(*rpc_client_, asyncChangeInvisibleDuration)
+      .Times(testing::AtLeast(1))
+      .WillRepeatedly(testing::Invoke(mock_change_invisible_duration));
+
+  ChangeInvisibleDurationRequest request;
+  auto entry = request.add_entries();
+  entry->mutable_topic()->set_name(topic_);
+  entry->set_message_id("msg-0");
+  entry->set_receipt_handle("expired-handle");
+
+  bool callback_invoked = false;
+  std::error_code error_code;
+  auto callback = [&](const std::error_code& ec, const ChangeInvisibleDurationResponse& response) {
+    callback_invoked = true;
+    error_code = ec;
+  };
+
+  client_manager_->changeInvisibleDuration(target_host_, metadata_, request, absl::ToChronoMilliseconds(io_timeout_),
+                                           callback);
+
+  EXPECT_TRUE(callback_invoked);
+  // An expired receipt handle is routine, and must not be mistaken for a broker lacking the RPC.
+  EXPECT_EQ(ErrorCode::NotFound, error_code);
+  EXPECT_NE(ErrorCode::NotImplemented, error_code);
+}
+
 TEST_F(ClientManagerTest, testForwardMessageToDeadLetterQueue) {
   bool completed = false;
   absl::Mutex mtx;
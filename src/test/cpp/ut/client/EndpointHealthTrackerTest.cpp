@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "EndpointHealthTracker.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class EndpointHealthTrackerTest : public testing::Test {
+protected:
+  EndpointHealthTracker tracker_{absl::Seconds(30)};
+  std::string endpoint_{"ipv4:10.0.0.1:8081"};
+  absl::Time now_{absl::Now()};
+};
+
+TEST_F(EndpointHealthTrackerTest, testUnknownWithoutEvidence) {
+  EXPECT_EQ(EndpointHealth::Unknown, tracker_.health(endpoint_, now_));
+}
+
+TEST_F(EndpointHealthTrackerTest, testTransitions) {
+  // First evidence is not a recovery.
+  EXPECT_FALSE(tracker_.onSuccess(endpoint_, now_));
+  EXPECT_EQ(EndpointHealth::Healthy, tracker_.health(endpoint_, now_));
+
+  EXPECT_TRUE(tracker_.onFailure(endpoint_, now_));
+  EXPECT_FALSE(tracker_.onFailure(endpoint_, now_));
+  EXPECT_EQ(EndpointHealth::Unhealthy, tracker_.health(endpoint_, now_));
+
+  EXPECT_TRUE(tracker_.onSuccess(endpoint_, now_));
+  EXPECT_FALSE(tracker_.onSuccess(endpoint_, now_));
+  EXPECT_EQ(EndpointHealth::Healthy, tracker_.health(endpoint_, now_));
+}
+
+TEST_F(EndpointHealthTrackerTest, testStaleEvidence) {
+  tracker_.onFailure(endpoint_, now_);
+  EXPECT_EQ(EndpointHealth::Unhealthy, tracker_.health(endpoint_, now_ + absl::Seconds(30)));
+  EXPECT_EQ(EndpointHealth::Unknown, tracker_.health(endpoint_, now_ + absl::Seconds(31)));
+}
+
+TEST_F(EndpointHealthTrackerTest, testRemove) {
+  tracker_.onSuccess(endpoint_, now_);
+  EXPECT_EQ(1, tracker_.size());
+  tracker_.remove({endpoint_});
+  EXPECT_EQ(0, tracker_.size());
+  EXPECT_EQ(EndpointHealth::Unknown, tracker_.health(endpoint_, now_));
+}
+
+ROCKETMQ_NAMESPACE_END
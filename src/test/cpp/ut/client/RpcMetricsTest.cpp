@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RpcMetrics.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class RpcMetricsTest : public testing::Test {
+protected:
+  std::string endpoint_{"ipv4:10.0.0.1:8081"};
+  std::string method_{"/apache.rocketmq.v1.MessagingService/SendMessage"};
+  RpcMetrics rpc_metrics_{std::vector<std::string>{method_}};
+};
+
+TEST_F(RpcMetricsTest, testEndpoint) {
+  auto metrics = rpc_metrics_.endpoint(endpoint_);
+  EXPECT_EQ(metrics, rpc_metrics_.endpoint(endpoint_));
+  EXPECT_EQ(endpoint_, metrics->endpoint());
+
+  rpc_metrics_.remove({endpoint_});
+  EXPECT_NE(metrics, rpc_metrics_.endpoint(endpoint_));
+}
+
+TEST_F(RpcMetricsTest, testAccounting) {
+  auto metrics = rpc_metrics_.endpoint(endpoint_);
+  metrics->onStart();
+  metrics->onStart();
+  metrics->onSerialized(128, std::chrono::microseconds(3));
+  metrics->onReceived(64);
+  metrics->onComplete(method_, true, std::chrono::milliseconds(2));
+  EXPECT_EQ(1, metrics->inflight());
+
+  std::vector<std::string> stats;
+  rpc_metrics_.reportAndReset(stats);
+  ASSERT_EQ(1, stats.size());
+  EXPECT_TRUE(absl::StartsWith(
+      stats[0], "RPC-Metrics[ipv4:10.0.0.1:8081]: inflight=1, sent=128bytes, received=64bytes, serialization=3us"));
+  EXPECT_TRUE(absl::StrContains(stats[0], method_ + ": calls=1, failures=0, Latency:[0ms~1ms): 0, [1ms~5ms): 1"));
+
+  metrics->onComplete(method_, false, std::chrono::seconds(6));
+  rpc_metrics_.reportAndReset(stats);
+  EXPECT_TRUE(absl::StartsWith(
+      stats[0], "RPC-Metrics[ipv4:10.0.0.1:8081]: inflight=0, sent=0bytes, received=0bytes, serialization=0us"));
+  EXPECT_TRUE(absl::StrContains(stats[0], "calls=1, failures=1"));
+  EXPECT_TRUE(absl::StrContains(stats[0], "[5s~inf): 1"));
+}
+
+TEST_F(RpcMetricsTest, testOtherMethods) {
+  auto metrics = rpc_metrics_.endpoint(endpoint_);
+  metrics->onStart();
+  metrics->onComplete("/apache.rocketmq.v1.MessagingService/Unknown", true, std::chrono::milliseconds(2));
+
+  std::vector<std::string> stats;
+  rpc_metrics_.reportAndReset(stats);
+  ASSERT_EQ(1, stats.size());
+  EXPECT_FALSE(absl::StrContains(stats[0], method_));
+  EXPECT_TRUE(absl::StrContains(stats[0], "others: calls=1, failures=0"));
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Signature.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/time/time.h"
+
+#include "ClientConfigImpl.h"
+#include "MetadataConstants.h"
+#include "Protocol.h"
+#include "TlsHelper.h"
+#include "gtest/gtest.h"
+#include "rocketmq/CredentialsProvider.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class SignatureTest : public testing::Test {
+protected:
+  void SetUp() override {
+    client_config_.resourceNamespace("MQ_INST_test");
+    client_config_.tenantId("tenant-0");
+    client_config_.region("cn-hangzhou");
+    client_config_.serviceName("MQ");
+    client_config_.setCredentialsProvider(std::make_shared<StaticCredentialsProvider>(access_key_, access_secret_));
+  }
+
+  static Metadata::Entries flatten(const Metadata& metadata) {
+    Metadata::Entries headers;
+    metadata.forEach([&headers](const std::string& key, const std::string& value) {
+      EXPECT_TRUE(headers.insert({key, value}).second) << "Duplicated header: " << key;
+    });
+    return headers;
+  }
+
+  // Headers as built by hand, one by one, for every call.
+  Metadata::Entries expectedHeaders(const std::string& date_time) {
+    std::string authorization;
+    authorization.append(MetadataConstants::ALGORITHM_KEY)
+        .append(" ")
+        .append(MetadataConstants::CREDENTIAL_KEY)
+        .append("=")
+        .append(access_key_)
+        .append("/")
+        .append(client_config_.region())
+        .append("/")
+        .append(client_config_.serviceName())
+        .append(", ")
+        .append(MetadataConstants::SIGNED_HEADERS_KEY)
+        .append("=")
+        .append(MetadataConstants::DATE_TIME_KEY)
+        .append(", ")
+        .append(MetadataConstants::SIGNATURE_KEY)
+        .append("=")
+        .append(TlsHelper::sign(access_secret_, date_time));
+    return {
+        {MetadataConstants::LANGUAGE_KEY, "CPP"},
+        {MetadataConstants::CLIENT_VERSION_KEY, ClientConfigImpl::CLIENT_VERSION},
+        {MetadataConstants::PROTOCOL_VERSION_KEY, Protocol::PROTOCOL_VERSION},
+        {MetadataConstants::TENANT_ID_KEY, client_config_.tenantId()},
+        {MetadataConstants::NAMESPACE_KEY, client_config_.resourceNamespace()},
+        {MetadataConstants::DATE_TIME_KEY, date_time},
+        {MetadataConstants::AUTHORIZATION, authorization},
+    };
+  }
+
+  std::string access_key_{"access-key"};
+  std::string access_secret_{"access-secret"};
+  ClientConfigImpl client_config_{"test-group"};
+};
+
+TEST_F(SignatureTest, testHeadersUnchanged) {
+  Metadata metadata;
+  Signature::sign(&client_config_, metadata);
+  auto headers = flatten(metadata);
+  ASSERT_EQ(1, headers.count(MetadataConstants::DATE_TIME_KEY));
+  EXPECT_EQ(expectedHeaders(headers[MetadataConstants::DATE_TIME_KEY]), headers);
+
+  absl::flat_hash_map<std::string, std::string> plain;
+  Signature::sign(&client_config_, plain);
+  EXPECT_EQ(expectedHeaders(plain[MetadataConstants::DATE_TIME_KEY]), plain);
+}
+
+TEST_F(SignatureTest, testCommonHeadersShared) {
+  auto common_headers = client_config_.commonHeaders();
+  EXPECT_EQ(common_headers, client_config_.commonHeaders());
+  EXPECT_EQ(5, common_headers->size());
+
+  client_config_.tenantId("tenant-1");
+  auto rebuilt = client_config_.commonHeaders();
+  EXPECT_NE(common_headers, rebuilt);
+  EXPECT_EQ("tenant-1", rebuilt->at(MetadataConstants::TENANT_ID_KEY));
+
+  Metadata metadata;
+  Signature::sign(&client_config_, metadata);
+  auto headers = flatten(metadata);
+  EXPECT_EQ(expectedHeaders(headers[MetadataConstants::DATE_TIME_KEY]), headers);
+}
+
+TEST_F(SignatureTest, testToString) {
+  Metadata metadata(Metadata::Entries{{"foo", "bar"}});
+  EXPECT_EQ("foo=bar", metadata.toString());
+  EXPECT_FALSE(metadata.empty());
+  EXPECT_TRUE(Metadata().empty());
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -28,4 +28,15 @@ TEST(TlsHelperTest, testSign) {
   EXPECT_STRCASEEQ(expect, signature.c_str());
 }
 
+TEST(TlsHelperTest, testSignWithAlternatingSecrets) {
+  const char* data = "some random data for test purpose only";
+  const char* expect = "567868dc8e81f1e8095f88958edff1e07db4290e";
+  // Re-keying the thread-local context back and forth must not leak state between secrets.
+  for (int i = 0; i < 3; i++) {
+    EXPECT_STRCASEEQ(expect, TlsHelper::sign("arbitrary-access-key", data).c_str());
+    EXPECT_STRCASENE(expect, TlsHelper::sign("another-access-key", data).c_str());
+  }
+  EXPECT_EQ(TlsHelper::sign("another-access-key", data), TlsHelper::sign("another-access-key", data));
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "TopicAssignmentInfo.h"
+#include "DnsResolver.h"
 #include "rocketmq/ConsumeType.h"
 #include "gtest/gtest.h"
 #include <iostream>
@@ -107,4 +108,66 @@ TEST_F(QueryAssignmentInfoTest, testCtor3) {
   EXPECT_TRUE(assignment.assignmentList().empty());
 }
 
+TEST_F(QueryAssignmentInfoTest, testEquality) {
+  QueryAssignmentResponse response;
+  QueryAssignmentResponse reversed;
+  for (int i = 0; i < total_; i++) {
+    for (auto* target : {&response, &reversed}) {
+      auto assignment = target->add_assignments();
+      assignment->mutable_partition()->mutable_topic()->set_resource_namespace(resource_namespace_);
+      assignment->mutable_partition()->mutable_topic()->set_name(topic_);
+      assignment->mutable_partition()->set_id(target == &response ? i : total_ - 1 - i);
+      assignment->mutable_partition()->set_permission(rmq::Permission::READ);
+      auto broker = assignment->mutable_partition()->mutable_broker();
+      broker->set_name(broker_name_);
+      broker->set_id(broker_id_);
+      broker->mutable_endpoints()->set_scheme(rmq::AddressScheme::IPv4);
+      auto address = broker->mutable_endpoints()->add_addresses();
+      address->set_host("10.0.0.1");
+      address->set_port(10911);
+    }
+  }
+
+  TopicAssignment assignment(response);
+  EXPECT_EQ(assignment, TopicAssignment(reversed));
+
+  response.mutable_assignments()->RemoveLast();
+  EXPECT_NE(assignment, TopicAssignment(response));
+
+  EXPECT_NE(std::string::npos, assignment.debugString().find(topic_));
+}
+
+TEST_F(QueryAssignmentInfoTest, testResolveOncePerBroker) {
+  const int brokers = 8;
+  const int partitions = 4096;
+  QueryAssignmentResponse response;
+  for (int i = 0; i < partitions; i++) {
+    auto assignment = response.add_assignments();
+    assignment->mutable_partition()->mutable_topic()->set_resource_namespace(resource_namespace_);
+    assignment->mutable_partition()->mutable_topic()->set_name(topic_);
+    assignment->mutable_partition()->set_id(i / brokers);
+    assignment->mutable_partition()->set_permission(rmq::Permission::READ_WRITE);
+    auto broker = assignment->mutable_partition()->mutable_broker();
+    broker->set_name("broker-" + std::to_string(i % brokers));
+    broker->set_id(broker_id_);
+    broker->mutable_endpoints()->set_scheme(rmq::AddressScheme::IPv4);
+    for (int j = 0; j < 2; j++) {
+      auto address = broker->mutable_endpoints()->add_addresses();
+      address->set_host("10.0." + std::to_string(i % brokers) + "." + std::to_string(j + 1));
+      address->set_port(10911);
+    }
+  }
+
+  std::uint64_t lookups = dnsResolver()->lookups();
+  TopicAssignment assignment(response);
+  EXPECT_EQ(static_cast<std::uint64_t>(brokers), dnsResolver()->lookups() - lookups);
+
+  ASSERT_EQ(static_cast<std::size_t>(partitions), assignment.assignmentList().size());
+  for (const auto& item : assignment.assignmentList()) {
+    const MQMessageQueue& message_queue = item.messageQueue();
+    std::string suffix = message_queue.getBrokerName().substr(std::string("broker-").length());
+    EXPECT_EQ("ipv4:10.0." + suffix + ".1:10911,10.0." + suffix + ".2:10911", message_queue.serviceAddress());
+  }
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -18,7 +18,9 @@
 #include "rocketmq/RocketMQ.h"
 #include "spdlog/spdlog.h"
 #include "gtest/gtest.h"
+#include <atomic>
 #include <thread>
+#include <vector>
 
 ROCKETMQ_NAMESPACE_BEGIN
 
@@ -46,4 +48,63 @@ TEST(CountdownLatchTest, testCountdown) {
   }
 }
 
+TEST(CountdownLatchTest, testAwaitOpened) {
+  CountdownLatch countdown_latch(1);
+  countdown_latch.countdown();
+  countdown_latch.await();
+  EXPECT_EQ(0, countdown_latch.count());
+}
+
+TEST(CountdownLatchTest, testConcurrentCountdown) {
+  const int threads = 8;
+  const int rounds = 10000;
+  for (int i = 0; i < 20; i++) {
+    CountdownLatch countdown_latch(threads * rounds);
+    std::atomic<int> released{0};
+    std::vector<std::thread> waiters;
+    for (int j = 0; j < 3; j++) {
+      waiters.emplace_back([&] {
+        countdown_latch.await();
+        released.fetch_add(1);
+      });
+    }
+
+    std::vector<std::thread> workers;
+    for (int j = 0; j < threads; j++) {
+      workers.emplace_back([&] {
+        for (int k = 0; k < rounds; k++) {
+          countdown_latch.countdown();
+        }
+      });
+    }
+
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    for (auto& waiter : waiters) {
+      waiter.join();
+    }
+    EXPECT_EQ(3, released.load());
+    EXPECT_EQ(0, countdown_latch.count());
+  }
+}
+
+TEST(CountdownLatchTest, testOneShot) {
+  // Result published before countdown() is visible once await() returns.
+  for (int i = 0; i < 1000; i++) {
+    int result = 0;
+    std::thread t;
+    {
+      CountdownLatch countdown_latch(1);
+      t = std::thread([&] {
+        result = i + 1;
+        countdown_latch.countdown();
+      });
+      countdown_latch.await();
+      EXPECT_EQ(i + 1, result);
+      t.join();
+    }
+  }
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -15,8 +15,12 @@
  * limitations under the License.
  */
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <vector>
 
 #include "ClientImpl.h"
 #include "ClientManagerFactory.h"
@@ -24,9 +28,14 @@
 #include "DynamicNameServerResolver.h"
 #include "HttpClientMock.h"
 #include "NameServerResolverMock.h"
+#include "OtlpExporter.h"
+#include "RouteCache.h"
 #include "Scheduler.h"
 #include "SchedulerImpl.h"
 #include "TopAddressing.h"
+#include "TopicRouteData.h"
+#include "rocketmq/CredentialsProvider.h"
+#include "rocketmq/ErrorCode.h"
 #include "rocketmq/RocketMQ.h"
 
 #include "gtest/gtest.h"
@@ -44,6 +53,19 @@ public:
 
   void prepareHeartbeatData(HeartbeatRequest& request) override {
   }
+
+  /**
+   * Wire the client up as start() does, minus the name server resolver and scheduled tasks.
+   */
+  void attach(ClientManagerPtr client_manager) {
+    client_manager_ = std::move(client_manager);
+    exporter_ = std::make_shared<OtlpExporter>(client_manager_, this);
+    state(State::STARTED);
+  }
+
+  void refreshRoutes() {
+    updateRouteInfo();
+  }
 };
 
 class ClientImplTest : public testing::Test {
@@ -123,4 +145,219 @@ TEST_F(ClientImplTest, testBasic) {
   client_->shutdown();
 }
 
+class RouteSharingTest : public testing::Test {
+public:
+  void SetUp() override {
+    client_manager_ = std::make_shared<testing::NiceMock<ClientManagerMock>>();
+    name_server_resolver_ = std::make_shared<testing::NiceMock<NameServerResolverMock>>();
+    ON_CALL(*name_server_resolver_, resolve).WillByDefault(testing::ReturnPointee(&access_point_));
+
+    // RouteCache is process-wide: keep routes of one test apart from those of others.
+    topic_ = testing::UnitTest::GetInstance()->current_test_info()->name();
+    for (std::size_t i = 0; i < CLIENTS; i++) {
+      auto client = std::make_shared<TestClientImpl>(group_);
+      client->resourceNamespace(resource_namespace_);
+      client->withNameServerResolver(name_server_resolver_);
+      client->attach(client_manager_);
+      clients_.push_back(client);
+    }
+  }
+
+  void TearDown() override {
+    for (auto& client : clients_) {
+      if (client->active()) {
+        client->state(State::STOPPING);
+        client->shutdown();
+      }
+    }
+  }
+
+protected:
+  static const std::size_t CLIENTS = 4;
+  std::string access_point_{"ipv4:10.0.0.1:9876"};
+  std::string resource_namespace_{"mq://test"};
+  std::string group_{"Group-0"};
+  std::string topic_;
+  std::shared_ptr<testing::NiceMock<ClientManagerMock>> client_manager_;
+  std::shared_ptr<testing::NiceMock<NameServerResolverMock>> name_server_resolver_;
+  std::vector<std::shared_ptr<TestClientImpl>> clients_;
+
+  using Callback = std::function<void(const std::error_code&, const TopicRouteDataPtr&)>;
+
+  RouteKey keyOf(const std::string& access_point, const std::string& access_key = std::string()) {
+    return RouteKey{access_point, access_key, resource_namespace_, topic_};
+  }
+
+  TopicRouteDataPtr routeOf(const std::string& broker_host) {
+    std::vector<Partition> partitions;
+    Topic topic(resource_namespace_, topic_);
+    std::vector<Address> broker_addresses{Address(broker_host, 10911)};
+    ServiceAddress service_address(AddressScheme::IPv4, broker_addresses);
+    Broker broker("broker-a", 0, service_address);
+    partitions.emplace_back(Partition(topic, 0, Permission::READ_WRITE, broker));
+    return std::make_shared<TopicRouteData>(partitions, std::string());
+  }
+
+  static bool uses(TestClientImpl& client, const TopicRouteDataPtr& route) {
+    absl::flat_hash_set<std::string> endpoints;
+    client.endpointsInUse(endpoints);
+    return endpoints.contains(route->partitions()[0].asMessageQueue().serviceAddress());
+  }
+};
+
+const std::size_t RouteSharingTest::CLIENTS;
+
+TEST_F(RouteSharingTest, testShareRoute) {
+  Callback pending;
+  EXPECT_CALL(*client_manager_, resolveRoute).Times(1).WillOnce(testing::SaveArg<4>(&pending));
+
+  std::size_t completed = 0;
+  for (auto& client : clients_) {
+    client->getRouteFor(topic_, [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
+      EXPECT_FALSE(ec);
+      EXPECT_TRUE(route);
+      completed++;
+    });
+  }
+  EXPECT_EQ(CLIENTS, RouteCache::instance().subscribers(keyOf(access_point_)));
+
+  // One query answers all clients.
+  ASSERT_TRUE(pending);
+  EXPECT_EQ(0U, completed);
+  auto route = routeOf("10.0.0.2");
+  pending(std::error_code(), route);
+  EXPECT_EQ(CLIENTS, completed);
+  for (auto& client : clients_) {
+    EXPECT_TRUE(uses(*client, route));
+  }
+
+  // Route changes fan out to every client.
+  auto changed = routeOf("10.0.0.3");
+  RouteCache::instance().refresh(
+      keyOf(access_point_), [&](const Callback& callback) { callback(std::error_code(), changed); },
+      absl::ZeroDuration(), absl::Seconds(3));
+  for (auto& client : clients_) {
+    EXPECT_TRUE(uses(*client, changed));
+    EXPECT_FALSE(uses(*client, route));
+  }
+}
+
+TEST_F(RouteSharingTest, testUnsubscribeOnShutdown) {
+  Callback pending;
+  EXPECT_CALL(*client_manager_, resolveRoute).Times(1).WillOnce(testing::SaveArg<4>(&pending));
+  for (auto& client : clients_) {
+    client->getRouteFor(topic_, [](const std::error_code&, const TopicRouteDataPtr&) {});
+  }
+  ASSERT_TRUE(pending);
+  pending(std::error_code(), routeOf("10.0.0.2"));
+  ASSERT_TRUE(RouteCache::instance().route(keyOf(access_point_)));
+
+  clients_[0]->state(State::STOPPING);
+  clients_[0]->shutdown();
+  EXPECT_EQ(CLIENTS - 1, RouteCache::instance().subscribers(keyOf(access_point_)));
+
+  for (auto& client : clients_) {
+    if (client->active()) {
+      client->state(State::STOPPING);
+      client->shutdown();
+    }
+  }
+  EXPECT_EQ(0U, RouteCache::instance().subscribers(keyOf(access_point_)));
+  EXPECT_FALSE(RouteCache::instance().route(keyOf(access_point_)));
+}
+
+TEST_F(RouteSharingTest, testRefuseWithoutAccessPoint) {
+  access_point_.clear();
+  EXPECT_CALL(*client_manager_, resolveRoute).Times(0);
+
+  std::size_t failed = 0;
+  for (auto& client : clients_) {
+    client->getRouteFor(topic_, [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
+      EXPECT_EQ(ErrorCode::ServiceUnavailable, ec);
+      EXPECT_FALSE(route);
+      failed++;
+    });
+  }
+  EXPECT_EQ(CLIENTS, failed);
+  EXPECT_EQ(0U, RouteCache::instance().subscribers(keyOf(std::string())));
+}
+
+TEST_F(RouteSharingTest, testRekeyOnAccessPointChange) {
+  std::string previous = access_point_;
+  std::string current{"ipv4:10.0.0.9:9876"};
+  Callback pending;
+  EXPECT_CALL(*client_manager_, resolveRoute(previous, testing::_, testing::_, testing::_, testing::_))
+      .Times(1)
+      .WillOnce(testing::SaveArg<4>(&pending));
+  for (auto& client : clients_) {
+    client->getRouteFor(topic_, [](const std::error_code&, const TopicRouteDataPtr&) {});
+  }
+  ASSERT_TRUE(pending);
+  pending(std::error_code(), routeOf("10.0.0.2"));
+
+  // Name servers are unreachable for a while: stay on the known route.
+  access_point_.clear();
+  for (auto& client : clients_) {
+    client->refreshRoutes();
+  }
+  EXPECT_EQ(CLIENTS, RouteCache::instance().subscribers(keyOf(previous)));
+
+  Callback refreshed;
+  EXPECT_CALL(*client_manager_, resolveRoute(current, testing::_, testing::_, testing::_, testing::_))
+      .Times(1)
+      .WillOnce(testing::SaveArg<4>(&refreshed));
+  access_point_ = current;
+  for (auto& client : clients_) {
+    client->refreshRoutes();
+  }
+  EXPECT_EQ(0U, RouteCache::instance().subscribers(keyOf(previous)));
+  EXPECT_EQ(CLIENTS, RouteCache::instance().subscribers(keyOf(current)));
+
+  ASSERT_TRUE(refreshed);
+  auto route = routeOf("10.0.0.3");
+  refreshed(std::error_code(), route);
+  for (auto& client : clients_) {
+    EXPECT_TRUE(uses(*client, route));
+  }
+}
+
+TEST_F(RouteSharingTest, testIsolateCredentials) {
+  clients_[0]->setCredentialsProvider(std::make_shared<StaticCredentialsProvider>("ak-0", "sk-0"));
+  clients_[1]->setCredentialsProvider(std::make_shared<StaticCredentialsProvider>("ak-1", "sk-1"));
+
+  std::vector<Callback> pending;
+  EXPECT_CALL(*client_manager_, resolveRoute)
+      .Times(2)
+      .WillRepeatedly(
+          testing::Invoke([&](const std::string&, const Metadata&, const QueryRouteRequest&, std::chrono::milliseconds,
+                              const Callback& callback) { pending.push_back(callback); }));
+
+  std::error_code ec0, ec1;
+  TopicRouteDataPtr route0, route1;
+  clients_[0]->getRouteFor(topic_, [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
+    ec0 = ec;
+    route0 = route;
+  });
+  clients_[1]->getRouteFor(topic_, [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
+    ec1 = ec;
+    route1 = route;
+  });
+  ASSERT_EQ(2U, pending.size());
+  EXPECT_EQ(1U, RouteCache::instance().subscribers(keyOf(access_point_, "ak-0")));
+  EXPECT_EQ(1U, RouteCache::instance().subscribers(keyOf(access_point_, "ak-1")));
+
+  // Rejection of one's credentials does not leak to the other.
+  pending[0](ErrorCode::Forbidden, nullptr);
+  EXPECT_EQ(ErrorCode::Forbidden, ec0);
+  EXPECT_FALSE(ec1);
+  EXPECT_FALSE(route1);
+
+  auto route = routeOf("10.0.0.2");
+  pending[1](std::error_code(), route);
+  EXPECT_FALSE(ec1);
+  EXPECT_EQ(route, route1);
+  EXPECT_FALSE(route0);
+  EXPECT_FALSE(uses(*clients_[0], route));
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
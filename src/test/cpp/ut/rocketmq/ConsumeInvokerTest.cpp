@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ConsumeInvoker.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class CountingStandardListener : public StandardMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const std::vector<MQMessageExt>& msgs) override {
+    consumed += msgs.size();
+    return ConsumeMessageResult::SUCCESS;
+  }
+
+  std::size_t consumed{0};
+};
+
+class FailingFifoListener : public FifoMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const MQMessageExt& msg) override {
+    last_topic = msg.getTopic();
+    return ConsumeMessageResult::FAILURE;
+  }
+
+  std::string last_topic;
+};
+
+TEST(ConsumeInvokerTest, testDefault) {
+  ConsumeInvoker invoker;
+  EXPECT_FALSE(invoker);
+  EXPECT_FALSE(invoker.fifo());
+}
+
+TEST(ConsumeInvokerTest, testStandardListener) {
+  CountingStandardListener listener;
+  ConsumeInvoker invoker(&listener);
+  EXPECT_TRUE(invoker);
+  EXPECT_FALSE(invoker.fifo());
+
+  std::vector<MQMessageExt> batch(1);
+  EXPECT_EQ(ConsumeMessageResult::SUCCESS, invoker(batch));
+  EXPECT_EQ(ConsumeMessageResult::SUCCESS, invoker(batch));
+  EXPECT_EQ(2, listener.consumed);
+}
+
+TEST(ConsumeInvokerTest, testFifoListenerConsumesHead) {
+  FailingFifoListener listener;
+  ConsumeInvoker invoker(&listener);
+  EXPECT_TRUE(invoker.fifo());
+
+  std::vector<MQMessageExt> batch(2);
+  batch[0].setTopic("head");
+  batch[1].setTopic("tail");
+  EXPECT_EQ(ConsumeMessageResult::FAILURE, invoker(batch));
+  EXPECT_EQ("head", listener.last_topic);
+}
+
+ROCKETMQ_NAMESPACE_END
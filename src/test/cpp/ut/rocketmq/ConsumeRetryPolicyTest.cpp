@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ConsumeRetryPolicy.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+TEST(ConsumeRetryPolicyTest, testDisabledByDefault) {
+  ConsumeRetryPolicy policy;
+  EXPECT_FALSE(policy.enabled());
+  std::chrono::milliseconds delay(0);
+  EXPECT_FALSE(policy.retryLocally(0, std::chrono::seconds(30), delay));
+}
+
+TEST(ConsumeRetryPolicyTest, testExponentialBackoff) {
+  ConsumeRetryPolicy policy;
+  policy.max_local_attempts = 8;
+  EXPECT_EQ(std::chrono::milliseconds(100), policy.backoff(1));
+  EXPECT_EQ(std::chrono::milliseconds(200), policy.backoff(2));
+  EXPECT_EQ(std::chrono::milliseconds(400), policy.backoff(3));
+  EXPECT_EQ(policy.max_backoff, policy.backoff(10));
+}
+
+TEST(ConsumeRetryPolicyTest, testMaxLocalAttempts) {
+  ConsumeRetryPolicy policy;
+  policy.max_local_attempts = 2;
+  std::chrono::milliseconds delay(0);
+  EXPECT_TRUE(policy.retryLocally(0, std::chrono::seconds(30), delay));
+  EXPECT_EQ(std::chrono::milliseconds(100), delay);
+  EXPECT_TRUE(policy.retryLocally(1, std::chrono::seconds(30), delay));
+  EXPECT_EQ(std::chrono::milliseconds(200), delay);
+  EXPECT_FALSE(policy.retryLocally(2, std::chrono::seconds(30), delay));
+}
+
+TEST(ConsumeRetryPolicyTest, testInvisibleWindow) {
+  ConsumeRetryPolicy policy;
+  policy.max_local_attempts = 3;
+  std::chrono::milliseconds delay(0);
+  // Not enough invisible time left to retry and still nack in time.
+  EXPECT_FALSE(policy.retryLocally(0, policy.reserved_window, delay));
+  EXPECT_TRUE(policy.retryLocally(0, policy.reserved_window + std::chrono::seconds(1), delay));
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,276 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+#include "DelayedSendQueue.h"
+#include "SchedulerImpl.h"
+#include "rocketmq/AsyncCallback.h"
+#include "rocketmq/ErrorCode.h"
+#include "rocketmq/MQMessage.h"
+#include "rocketmq/RocketMQ.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * Time that only moves when told to, such that due-ness of messages is independent of how promptly ticks run.
+ */
+class VirtualClock {
+public:
+  std::chrono::steady_clock::time_point now() const {
+    return base_ + std::chrono::milliseconds(elapsed_.load(std::memory_order_acquire));
+  }
+
+  void advance(std::chrono::milliseconds duration) {
+    elapsed_.fetch_add(duration.count(), std::memory_order_acq_rel);
+  }
+
+private:
+  const std::chrono::steady_clock::time_point base_{std::chrono::steady_clock::now()};
+  std::atomic<std::int64_t> elapsed_{0};
+};
+
+class TestSendCallback : public SendCallback {
+public:
+  void onSuccess(SendResult& send_result) noexcept override {
+  }
+
+  void onFailure(const std::error_code& ec) noexcept override {
+    ec_ = ec;
+  }
+
+  std::error_code ec_;
+};
+
+class DelayedSendQueueTest : public testing::Test {
+public:
+  void SetUp() override {
+    scheduler_ = std::make_shared<SchedulerImpl>(1);
+    scheduler_->start();
+  }
+
+  void TearDown() override {
+    scheduler_->shutdown();
+  }
+
+protected:
+  std::shared_ptr<SchedulerImpl> scheduler_;
+  VirtualClock clock_;
+  std::string topic_{"TestTopic"};
+
+  absl::Mutex mtx_;
+  absl::CondVar cv_;
+  std::vector<std::string> sent_ GUARDED_BY(mtx_);
+
+  /**
+   * A revolution of the wheel spans 160ms.
+   */
+  std::shared_ptr<DelayedSendQueue> queueOf(std::uint64_t memory_budget) {
+    auto dispatcher = [this](const MQMessage& message, SendCallback* callback) {
+      absl::MutexLock lk(&mtx_);
+      sent_.push_back(message.getBody());
+      cv_.SignalAll();
+    };
+    return std::make_shared<DelayedSendQueue>(dispatcher, memory_budget, std::chrono::milliseconds(10), 16,
+                                              [this]() { return clock_.now(); });
+  }
+
+  std::vector<std::string> sent() {
+    absl::MutexLock lk(&mtx_);
+    return sent_;
+  }
+
+  void tick(DelayedSendQueue& queue, std::chrono::milliseconds duration) {
+    clock_.advance(duration);
+    queue.advance();
+  }
+};
+
+TEST_F(DelayedSendQueueTest, testHoldUntilDue) {
+  auto queue = queueOf(1024);
+  std::error_code ec;
+  TestSendCallback callback;
+  ASSERT_TRUE(queue->schedule(MQMessage(topic_, "50ms"), std::chrono::milliseconds(50), &callback, ec));
+  ASSERT_TRUE(queue->schedule(MQMessage(topic_, "25ms"), std::chrono::milliseconds(25), &callback, ec));
+  // Farther out than a revolution.
+  ASSERT_TRUE(queue->schedule(MQMessage(topic_, "1000ms"), std::chrono::milliseconds(1000), &callback, ec));
+  EXPECT_EQ(3U, queue->size());
+  EXPECT_EQ(14U, queue->memoryInUse());
+
+  tick(*queue, std::chrono::milliseconds(20));
+  EXPECT_TRUE(sent().empty());
+
+  // Never handed over early: 25ms is due at the 30ms tick.
+  tick(*queue, std::chrono::milliseconds(5));
+  EXPECT_TRUE(sent().empty());
+  tick(*queue, std::chrono::milliseconds(5));
+  EXPECT_EQ(std::vector<std::string>{"25ms"}, sent());
+
+  tick(*queue, std::chrono::milliseconds(20));
+  EXPECT_EQ((std::vector<std::string>{"25ms", "50ms"}), sent());
+
+  for (int i = 0; i < 94; i++) {
+    tick(*queue, std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(2U, sent().size());
+  tick(*queue, std::chrono::milliseconds(10));
+  EXPECT_EQ((std::vector<std::string>{"25ms", "50ms", "1000ms"}), sent());
+  EXPECT_EQ(0U, queue->size());
+  EXPECT_EQ(0U, queue->memoryInUse());
+  EXPECT_FALSE(callback.ec_);
+
+  std::string stats;
+  queue->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("sent=3"));
+  EXPECT_NE(std::string::npos, stats.find("max-lateness=5ms"));
+  EXPECT_NE(std::string::npos, stats.find("[000ms~010ms): 3"));
+}
+
+TEST_F(DelayedSendQueueTest, testCancel) {
+  auto queue = queueOf(1024);
+  MQMessage message(topic_, "cancelled");
+  TestSendCallback callback;
+  std::error_code ec;
+  ASSERT_TRUE(queue->schedule(message, std::chrono::milliseconds(100), &callback, ec));
+
+  EXPECT_TRUE(queue->cancel(message.getMsgId()));
+  EXPECT_EQ(std::errc::operation_canceled, callback.ec_);
+  EXPECT_EQ(0U, queue->memoryInUse());
+  EXPECT_FALSE(queue->cancel(message.getMsgId()));
+
+  tick(*queue, std::chrono::milliseconds(200));
+  EXPECT_TRUE(sent().empty());
+
+  // Once handed over, a message can no longer be cancelled.
+  MQMessage other(topic_, "sent");
+  ASSERT_TRUE(queue->schedule(other, std::chrono::milliseconds(10), &callback, ec));
+  tick(*queue, std::chrono::milliseconds(10));
+  EXPECT_FALSE(queue->cancel(other.getMsgId()));
+  EXPECT_EQ(std::vector<std::string>{"sent"}, sent());
+
+  std::string stats;
+  queue->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("cancelled=1"));
+}
+
+TEST_F(DelayedSendQueueTest, testReject) {
+  auto queue = queueOf(10);
+  TestSendCallback callback;
+  std::error_code ec;
+  MQMessage message(topic_, "12345678");
+  ASSERT_TRUE(queue->schedule(message, std::chrono::milliseconds(10), &callback, ec));
+
+  EXPECT_FALSE(queue->schedule(message, std::chrono::milliseconds(10), &callback, ec));
+  EXPECT_EQ(ErrorCode::BadRequest, ec);
+
+  EXPECT_FALSE(queue->schedule(MQMessage(topic_, "123"), std::chrono::milliseconds(10), &callback, ec));
+  EXPECT_EQ(ErrorCode::TooManyRequest, ec);
+
+  // Budget is released once messages are handed over.
+  tick(*queue, std::chrono::milliseconds(10));
+  ec.clear();
+  EXPECT_TRUE(queue->schedule(MQMessage(topic_, "123"), std::chrono::milliseconds(10), &callback, ec));
+  EXPECT_FALSE(ec);
+
+  // Messages already due bypass the wheel.
+  EXPECT_TRUE(queue->schedule(MQMessage(topic_, "immediately"), std::chrono::milliseconds(0), &callback, ec));
+  EXPECT_EQ((std::vector<std::string>{"12345678", "immediately"}), sent());
+
+  std::string stats;
+  queue->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("rejected=2"));
+}
+
+TEST_F(DelayedSendQueueTest, testFallBehind) {
+  auto queue = queueOf(1024);
+  TestSendCallback callback;
+  std::error_code ec;
+  for (int i = 9; i >= 0; i--) {
+    ASSERT_TRUE(
+        queue->schedule(MQMessage(topic_, std::to_string(i)), std::chrono::milliseconds(100 * i + 10), &callback, ec));
+  }
+
+  // Ticks stall for several revolutions.
+  tick(*queue, std::chrono::milliseconds(910));
+  EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"}), sent());
+
+  std::string stats;
+  queue->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("max-lateness=900ms"));
+  EXPECT_NE(std::string::npos, stats.find("[000ms~010ms): 1"));
+  EXPECT_NE(std::string::npos, stats.find("[100ms~inf): 9"));
+
+  queue->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("max-lateness=0ms"));
+}
+
+TEST_F(DelayedSendQueueTest, testClear) {
+  auto queue = queueOf(1024);
+  TestSendCallback callback;
+  std::error_code ec;
+  ASSERT_TRUE(queue->schedule(MQMessage(topic_, "dropped"), std::chrono::milliseconds(100), &callback, ec));
+
+  queue->clear(ErrorCode::IllegalState);
+  EXPECT_EQ(ErrorCode::IllegalState, callback.ec_);
+  EXPECT_EQ(0U, queue->size());
+  tick(*queue, std::chrono::milliseconds(100));
+  EXPECT_TRUE(sent().empty());
+}
+
+TEST_F(DelayedSendQueueTest, testTickedByScheduler) {
+  auto queue = queueOf(1024);
+  std::weak_ptr<DelayedSendQueue> ptr(queue);
+  auto functor = [ptr]() {
+    auto queue = ptr.lock();
+    if (queue) {
+      queue->advance();
+    }
+  };
+  std::uint32_t task_id =
+      scheduler_->schedule(functor, "delayed-send-tick", std::chrono::milliseconds(1), std::chrono::milliseconds(1));
+
+  TestSendCallback callback;
+  std::error_code ec;
+  ASSERT_TRUE(queue->schedule(MQMessage(topic_, "due"), std::chrono::milliseconds(100), &callback, ec));
+
+  // Scheduler keeps ticking, yet no virtual time passes.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_TRUE(sent().empty());
+
+  clock_.advance(std::chrono::milliseconds(100));
+  {
+    absl::MutexLock lk(&mtx_);
+    absl::Time deadline = absl::Now() + absl::Seconds(10);
+    while (sent_.empty() && !cv_.WaitWithDeadline(&mtx_, deadline)) {
+    }
+    EXPECT_EQ(std::vector<std::string>{"due"}, sent_);
+  }
+  scheduler_->cancel(task_id);
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DuplicateFilter.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class DuplicateFilterTest : public testing::Test {
+protected:
+  absl::Time now_{absl::Now()};
+};
+
+TEST_F(DuplicateFilterTest, testSeen) {
+  DuplicateFilter filter(absl::Seconds(60), 1024);
+  EXPECT_FALSE(filter.seen("msg-0", now_));
+  filter.record("msg-0", now_);
+  EXPECT_TRUE(filter.seen("msg-0", now_));
+  EXPECT_FALSE(filter.seen("msg-1", now_));
+}
+
+TEST_F(DuplicateFilterTest, testWindow) {
+  DuplicateFilter filter(absl::Seconds(60), 1024);
+  filter.record("msg-0", now_);
+
+  // Retired to the previous generation, still remembered.
+  EXPECT_TRUE(filter.seen("msg-0", now_ + absl::Seconds(40)));
+
+  // Evicted along with the previous generation.
+  EXPECT_FALSE(filter.seen("msg-0", now_ + absl::Seconds(70)));
+  EXPECT_EQ(0, filter.size());
+}
+
+TEST_F(DuplicateFilterTest, testIdleForWholeWindow) {
+  DuplicateFilter filter(absl::Seconds(60), 1024);
+  filter.record("msg-0", now_);
+  EXPECT_FALSE(filter.seen("msg-0", now_ + absl::Seconds(61)));
+}
+
+TEST_F(DuplicateFilterTest, testCapacity) {
+  DuplicateFilter filter(absl::Hours(1), 100);
+  for (int i = 0; i < 1000; i++) {
+    filter.record("msg-" + std::to_string(i), now_);
+  }
+  EXPECT_LE(filter.size(), 100);
+  EXPECT_TRUE(filter.seen("msg-999", now_));
+  EXPECT_FALSE(filter.seen("msg-0", now_));
+}
+
+TEST_F(DuplicateFilterTest, testReportAndReset) {
+  DuplicateFilter filter(absl::Seconds(60), 1024);
+  filter.record("msg-0", now_);
+  filter.seen("msg-0", now_);
+  filter.seen("msg-1", now_);
+  std::string stats;
+  filter.reportAndReset(stats);
+  EXPECT_EQ("Deduplication: lookups=2, hits=1, hit-rate=50.00%, fingerprints=1", stats);
+  filter.reportAndReset(stats);
+  EXPECT_EQ("Deduplication: lookups=0, hits=0, hit-rate=0.00%, fingerprints=1", stats);
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -44,4 +44,31 @@ TEST_F(FilterExpressionTest, testAccept) {
   EXPECT_FALSE(filter_expression_.accept(message2));
 }
 
+TEST_F(FilterExpressionTest, testAcceptTagSet) {
+  FilterExpression filter_expression("TagA || TagB ||TagC");
+  MQMessageExt message;
+  message.setTags("TagB");
+  EXPECT_TRUE(filter_expression.accept(message));
+  message.setTags("TagD");
+  EXPECT_FALSE(filter_expression.accept(message));
+
+  FilterExpression wild_card("*");
+  EXPECT_TRUE(wild_card.accept(message));
+}
+
+TEST_F(FilterExpressionTest, testAcceptSql92) {
+  FilterExpression filter_expression("a > 5 AND region IN ('hz', 'sh')", ExpressionType::SQL92);
+  MQMessageExt message;
+  message.setProperty("a", "6");
+  message.setProperty("region", "hz");
+  EXPECT_TRUE(filter_expression.accept(message));
+
+  message.setProperty("region", "bj");
+  EXPECT_FALSE(filter_expression.accept(message));
+
+  // Malformed expressions are left to server.
+  FilterExpression malformed("a >", ExpressionType::SQL92);
+  EXPECT_TRUE(malformed.accept(message));
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "InflightMessageTable.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class InflightMessageTableTest : public testing::Test {
+protected:
+  InflightMessage inflightMessage(const std::string& endpoint, const std::string& message_id, absl::Time deadline) {
+    InflightMessage message;
+    message.endpoint = endpoint;
+    message.topic = topic_;
+    message.message_id = message_id;
+    message.receipt_handle = message_id + "-handle";
+    message.deadline = deadline;
+    return message;
+  }
+
+  std::string topic_{"TestTopic"};
+  InflightMessageTable table_;
+};
+
+TEST_F(InflightMessageTableTest, testExpiringGroupedByEndpoint) {
+  absl::Time now = absl::Now();
+  table_.add(inflightMessage("ipv4:10.0.0.1:8081", "msg-0", now + absl::Seconds(5)));
+  table_.add(inflightMessage("ipv4:10.0.0.1:8081", "msg-1", now + absl::Seconds(6)));
+  table_.add(inflightMessage("ipv4:10.0.0.2:8081", "msg-2", now + absl::Seconds(7)));
+  table_.add(inflightMessage("ipv4:10.0.0.2:8081", "msg-3", now + absl::Seconds(30)));
+  EXPECT_EQ(4, table_.size());
+
+  auto expiring = table_.expiring(now + absl::Seconds(10));
+  ASSERT_EQ(2, expiring.size());
+  EXPECT_EQ(2, expiring["ipv4:10.0.0.1:8081"].size());
+  EXPECT_EQ(1, expiring["ipv4:10.0.0.2:8081"].size());
+
+  // Messages being renewed are not collected twice.
+  EXPECT_TRUE(table_.expiring(now + absl::Seconds(10)).empty());
+}
+
+TEST_F(InflightMessageTableTest, testRenewed) {
+  absl::Time now = absl::Now();
+  table_.add(inflightMessage("ipv4:10.0.0.1:8081", "msg-0", now + absl::Seconds(5)));
+  auto expiring = table_.expiring(now + absl::Seconds(10));
+  ASSERT_EQ(1, expiring.size());
+
+  table_.renewed("msg-0", "renewed-handle", now + absl::Seconds(35));
+  std::string receipt_handle;
+  ASSERT_TRUE(table_.receiptHandle("msg-0", receipt_handle));
+  EXPECT_EQ("renewed-handle", receipt_handle);
+  absl::Time deadline;
+  ASSERT_TRUE(table_.deadline("msg-0", deadline));
+  EXPECT_EQ(now + absl::Seconds(35), deadline);
+  EXPECT_TRUE(table_.expiring(now + absl::Seconds(10)).empty());
+}
+
+TEST_F(InflightMessageTableTest, testRenewFailed) {
+  absl::Time now = absl::Now();
+  table_.add(inflightMessage("ipv4:10.0.0.1:8081", "msg-0", now + absl::Seconds(5)));
+  ASSERT_EQ(1, table_.expiring(now + absl::Seconds(10)).size());
+  table_.renewFailed("msg-0");
+
+  // Picked up again by the next round.
+  EXPECT_EQ(1, table_.expiring(now + absl::Seconds(10)).size());
+}
+
+TEST_F(InflightMessageTableTest, testRemove) {
+  absl::Time now = absl::Now();
+  table_.add(inflightMessage("ipv4:10.0.0.1:8081", "msg-0", now + absl::Seconds(5)));
+  table_.remove("msg-0");
+  EXPECT_EQ(0, table_.size());
+  std::string receipt_handle;
+  EXPECT_FALSE(table_.receiptHandle("msg-0", receipt_handle));
+
+  // Completion racing with renewal is harmless.
+  table_.renewed("msg-0", "renewed-handle", now + absl::Seconds(35));
+  EXPECT_EQ(0, table_.size());
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "ClientImpl.h"
+#include "ClientManagerMock.h"
+#include "LagSampler.h"
+#include "rocketmq/MQMessageQueue.h"
+#include "rocketmq/RocketMQ.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+/**
+ * Queries end offsets through ClientImpl::queryEndOffset, just as consumers do.
+ */
+class EndOffsetClient : public ClientImpl, public std::enable_shared_from_this<EndOffsetClient> {
+public:
+  explicit EndOffsetClient(ClientManagerPtr client_manager) : ClientImpl("CID_lag") {
+    client_manager_ = std::move(client_manager);
+  }
+
+  std::shared_ptr<ClientImpl> self() override {
+    return shared_from_this();
+  }
+
+  void prepareHeartbeatData(HeartbeatRequest& request) override {
+  }
+};
+
+class LagSamplerTest : public testing::Test {
+public:
+  void SetUp() override {
+    client_manager_ = std::make_shared<testing::NiceMock<ClientManagerMock>>();
+    client_ = std::make_shared<EndOffsetClient>(client_manager_);
+  }
+
+protected:
+  using QueryOffsetCallback = std::function<void(const std::error_code&, const QueryOffsetResponse&)>;
+
+  std::shared_ptr<testing::NiceMock<ClientManagerMock>> client_manager_;
+  std::shared_ptr<EndOffsetClient> client_;
+  std::string broker_a_{"10.0.0.1:10911"};
+  std::string broker_b_{"10.0.0.2:10911"};
+
+  MQMessageQueue queueOf(const std::string& topic, const std::string& broker, int queue_id) {
+    MQMessageQueue message_queue(topic, broker == broker_a_ ? "broker-a" : "broker-b", queue_id);
+    message_queue.serviceAddress(broker);
+    return message_queue;
+  }
+
+  /**
+   * End offsets are served by the (mocked) broker through QueryOffset.
+   */
+  LagSamplerSharedPtr samplerOf(std::size_t max_inflight_per_broker) {
+    std::shared_ptr<EndOffsetClient> client = client_;
+    auto query = [client](const MQMessageQueue& message_queue, const LagSampler::EndOffsetCallback& cb) {
+      client->queryEndOffset(message_queue, cb);
+    };
+    return std::make_shared<LagSampler>(query, max_inflight_per_broker);
+  }
+
+  static QueryOffsetResponse responseOf(std::int64_t offset) {
+    QueryOffsetResponse response;
+    response.set_offset(offset);
+    return response;
+  }
+};
+
+TEST_F(LagSamplerTest, testQueueAndTopicLag) {
+  absl::flat_hash_map<std::string, std::int64_t> end_offsets{
+      {"TopicA_broker-a_0", 100}, {"TopicA_broker-b_0", 50}, {"TopicB_broker-a_0", 10}, {"TopicB_broker-b_0", 5}};
+  EXPECT_CALL(*client_manager_, queryOffset)
+      .Times(4)
+      .WillRepeatedly([&](const std::string& target, const Metadata& metadata, const QueryOffsetRequest& request,
+                          std::chrono::milliseconds timeout, const QueryOffsetCallback& cb) {
+        EXPECT_EQ(rmq::QueryOffsetPolicy::END, request.policy());
+        EXPECT_EQ(request.partition().broker().name() == "broker-a" ? broker_a_ : broker_b_, target);
+        std::string name = request.partition().topic().name() + "_" + request.partition().broker().name() + "_" +
+                           std::to_string(request.partition().id());
+        cb(std::error_code(), responseOf(end_offsets.at(name)));
+      });
+
+  auto sampler = samplerOf(8);
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions{
+      {queueOf("TopicA", broker_a_, 0), 40}, {queueOf("TopicA", broker_b_, 0), 50},
+      {queueOf("TopicB", broker_a_, 0), 12}, {queueOf("TopicB", broker_b_, 0), 0},
+      {queueOf("TopicB", broker_b_, 1), -1}};
+  sampler->sample(positions);
+
+  auto lags = sampler->queueLags();
+  ASSERT_EQ(4U, lags.size());
+  for (const auto& lag : lags) {
+    if (lag.message_queue == queueOf("TopicA", broker_a_, 0)) {
+      EXPECT_EQ(40, lag.consumed_offset);
+      EXPECT_EQ(100, lag.end_offset);
+      EXPECT_EQ(60, lag.lag);
+    }
+    if (lag.message_queue == queueOf("TopicB", broker_a_, 0)) {
+      // Consumed offset may run ahead of a stale end offset.
+      EXPECT_EQ(0, lag.lag);
+    }
+  }
+
+  auto topic_lags = sampler->topicLags();
+  EXPECT_EQ(60, topic_lags["TopicA"]);
+  EXPECT_EQ(5, topic_lags["TopicB"]);
+
+  std::string stats;
+  sampler->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("TopicA[backlog=60, queues=2, max=TopicA_broker-a_0:60]"));
+  EXPECT_NE(std::string::npos, stats.find("queries=4"));
+}
+
+TEST_F(LagSamplerTest, testBatchPerBroker) {
+  std::vector<QueryOffsetCallback> outstanding;
+  EXPECT_CALL(*client_manager_, queryOffset)
+      .Times(5)
+      .WillRepeatedly([&](const std::string& target, const Metadata& metadata, const QueryOffsetRequest& request,
+                          std::chrono::milliseconds timeout,
+                          const QueryOffsetCallback& cb) { outstanding.push_back(cb); });
+
+  auto sampler = samplerOf(2);
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions;
+  for (int i = 0; i < 5; i++) {
+    positions.insert({queueOf("TopicA", broker_a_, i), 0});
+  }
+  sampler->sample(positions);
+
+  std::size_t completed = 0;
+  while (completed < outstanding.size()) {
+    // No more than the window is ever in flight against the broker.
+    EXPECT_LE(outstanding.size() - completed, 2U);
+    EXPECT_TRUE(sampler->queueLags().empty());
+    QueryOffsetCallback cb = outstanding[completed++];
+    cb(std::error_code(), responseOf(10));
+  }
+
+  EXPECT_EQ(5U, completed);
+  EXPECT_EQ(5U, sampler->queueLags().size());
+  EXPECT_EQ(50, sampler->topicLags()["TopicA"]);
+}
+
+TEST_F(LagSamplerTest, testSkipBusyBroker) {
+  std::vector<QueryOffsetCallback> outstanding;
+  EXPECT_CALL(*client_manager_, queryOffset)
+      .Times(3)
+      .WillRepeatedly([&](const std::string& target, const Metadata& metadata, const QueryOffsetRequest& request,
+                          std::chrono::milliseconds timeout, const QueryOffsetCallback& cb) {
+        if (target == broker_a_) {
+          outstanding.push_back(cb);
+          return;
+        }
+        cb(std::error_code(), responseOf(10));
+      });
+
+  auto sampler = samplerOf(8);
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions{{queueOf("TopicA", broker_a_, 0), 0},
+                                                              {queueOf("TopicA", broker_b_, 0), 0}};
+  sampler->sample(positions);
+  // Broker A has yet to answer the previous round, so only broker B is queried again.
+  sampler->sample(positions);
+  ASSERT_EQ(1U, outstanding.size());
+  EXPECT_EQ(1U, sampler->queueLags().size());
+
+  std::string stats;
+  sampler->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("skipped-brokers=1"));
+
+  outstanding[0](std::error_code(), responseOf(20));
+  EXPECT_EQ(30, sampler->topicLags()["TopicA"]);
+}
+
+TEST_F(LagSamplerTest, testFailureKeepsPreviousEstimate) {
+  EXPECT_CALL(*client_manager_, queryOffset)
+      .Times(3)
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), responseOf(10)))
+      .WillOnce(testing::InvokeArgument<4>(std::make_error_code(std::errc::timed_out), responseOf(0)))
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), responseOf(10)));
+
+  auto sampler = samplerOf(8);
+  MQMessageQueue message_queue = queueOf("TopicA", broker_a_, 0);
+  absl::flat_hash_map<MQMessageQueue, std::int64_t> positions{{message_queue, 4}};
+  sampler->sample(positions);
+  sampler->sample(positions);
+  EXPECT_EQ(6, sampler->topicLags()["TopicA"]);
+
+  // Queues no longer consumed are dropped.
+  positions.clear();
+  positions.insert({queueOf("TopicA", broker_a_, 1), 0});
+  sampler->sample(positions);
+  auto lags = sampler->queueLags();
+  ASSERT_EQ(1U, lags.size());
+  EXPECT_EQ(1, lags[0].message_queue.getQueueId());
+}
+
+ROCKETMQ_NAMESPACE_END
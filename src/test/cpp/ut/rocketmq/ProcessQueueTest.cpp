@@ -110,6 +110,23 @@ TEST_F(ProcessQueueTest, testExpired) {
   EXPECT_TRUE(process_queue_->expired());
 }
 
+TEST_F(ProcessQueueTest, testPauseAndResume) {
+  EXPECT_FALSE(process_queue_->park());
+  EXPECT_FALSE(process_queue_->resume());
+
+  process_queue_->pause();
+  EXPECT_TRUE(process_queue_->paused());
+  process_queue_->idle_since_ -= MixAll::PROCESS_QUEUE_EXPIRATION_THRESHOLD_;
+  EXPECT_FALSE(process_queue_->expired());
+
+  // Receive cycle parks once and is handed back exactly once on resume.
+  EXPECT_TRUE(process_queue_->park());
+  EXPECT_TRUE(process_queue_->resume());
+  EXPECT_FALSE(process_queue_->paused());
+  EXPECT_FALSE(process_queue_->resume());
+  EXPECT_FALSE(process_queue_->park());
+}
+
 TEST_F(ProcessQueueTest, testShouldThrottle) {
   EXPECT_CALL(*consumer_, maxCachedMessageQuantity)
       .Times(testing::AtLeast(1))
@@ -352,7 +369,7 @@ TEST_F(ProcessQueueTest, testReceiveMessage_Pull) {
 
   auto pull_message_mock = [&](const std::string& target_host, const Metadata& metadata,
                                const PullMessageRequest& request, std::chrono::milliseconds timeout,
-                               const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) {
+                               const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
     cb(ec, result);
   };
 
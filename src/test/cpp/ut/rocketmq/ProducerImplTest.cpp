@@ -14,8 +14,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <chrono>
 #include <memory>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "ClientManagerFactory.h"
 #include "ClientManagerMock.h"
@@ -25,6 +29,7 @@
 #include "StaticNameServerResolver.h"
 #include "TopicRouteData.h"
 #include "rocketmq/AsyncCallback.h"
+#include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQMessage.h"
 #include "rocketmq/MQSelector.h"
 #include "rocketmq/RocketMQ.h"
@@ -113,7 +118,7 @@ TEST_F(ProducerImplTest, testSend) {
   bool cb_invoked = false;
   SendResult send_result;
   auto mock_send = [&](const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                       SendCallback* cb) {
+                       std::chrono::milliseconds timeout, SendCallback* cb) {
     cb->onSuccess(send_result);
     cb_invoked = true;
     return true;
@@ -146,7 +151,7 @@ TEST_F(ProducerImplTest, testSend_WithMessageGroup) {
   bool cb_invoked = false;
   SendResult send_result;
   auto mock_send = [&](const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                       SendCallback* cb) {
+                       std::chrono::milliseconds timeout, SendCallback* cb) {
     cb->onSuccess(send_result);
     cb_invoked = true;
     return true;
@@ -180,7 +185,7 @@ TEST_F(ProducerImplTest, testSend_WithMessageQueueSelector) {
   bool cb_invoked = false;
   SendResult send_result;
   auto mock_send = [&](const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                       SendCallback* cb) {
+                       std::chrono::milliseconds timeout, SendCallback* cb) {
     cb->onSuccess(send_result);
     cb_invoked = true;
     return true;
@@ -242,7 +247,7 @@ TEST_F(ProducerImplTest, testAsyncSend) {
   bool cb_invoked = false;
   SendResult send_result;
   auto mock_send = [&](const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
-                       SendCallback* cb) {
+                       std::chrono::milliseconds timeout, SendCallback* cb) {
     cb->onSuccess(send_result);
     cb_invoked = true;
     return true;
@@ -270,4 +275,78 @@ TEST_F(ProducerImplTest, testAsyncSend) {
   producer_->shutdown();
 }
 
+/**
+ * Every attempt fails after taking 50ms, leaving plenty of attempts but only a 300ms budget for the whole send.
+ */
+class ProducerImplDeadlineTest : public ProducerImplTest {
+public:
+  void SetUp() override {
+    ProducerImplTest::SetUp();
+    auto mock_resolve_route =
+        [this](const std::string& target_host, const Metadata& metadata, const QueryRouteRequest& request,
+               std::chrono::milliseconds timeout,
+               const std::function<void(const std::error_code& ec, const TopicRouteDataPtr& ptr)>& cb) {
+          std::error_code ec;
+          cb(ec, topic_route_data_);
+        };
+    EXPECT_CALL(*client_manager_, resolveRoute)
+        .Times(testing::AtLeast(1))
+        .WillRepeatedly(testing::Invoke(mock_resolve_route));
+
+    auto mock_send = [this](const std::string& target_host, const Metadata& metadata, SendMessageRequest& request,
+                            std::chrono::milliseconds timeout, SendCallback* cb) {
+      attempts_.emplace_back(std::chrono::steady_clock::now(), timeout);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      std::error_code ec = ErrorCode::ServiceUnavailable;
+      cb->onFailure(ec);
+      return true;
+    };
+    EXPECT_CALL(*client_manager_, send).WillRepeatedly(testing::Invoke(mock_send));
+
+    producer_->setIoTimeout(absl::Milliseconds(300));
+    producer_->maxAttemptTimes(1000);
+    producer_->start();
+  }
+
+  void TearDown() override {
+    producer_->shutdown();
+    ProducerImplTest::TearDown();
+  }
+
+protected:
+  std::vector<std::pair<std::chrono::steady_clock::time_point, std::chrono::milliseconds>> attempts_;
+};
+
+TEST_F(ProducerImplDeadlineTest, testFailOnceDeadlinePasses) {
+  MQMessage message(topic_, tag_, message_body_);
+  std::error_code ec;
+  auto start = std::chrono::steady_clock::now();
+  producer_->send(message, ec);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // Attempts left do not matter once the budget is spent.
+  EXPECT_EQ(ErrorCode::RequestTimeout, ec);
+  EXPECT_GE(attempts_.size(), 2U);
+  EXPECT_LE(attempts_.size(), 7U);
+  EXPECT_GE(elapsed, std::chrono::milliseconds(300));
+  EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST_F(ProducerImplDeadlineTest, testCapAttemptTimeoutAtRemaining) {
+  MQMessage message(topic_, tag_, message_body_);
+  std::error_code ec;
+  auto start = std::chrono::steady_clock::now();
+  producer_->send(message, ec);
+  ASSERT_FALSE(attempts_.empty());
+
+  std::chrono::milliseconds previous(300);
+  for (const auto& attempt : attempts_) {
+    auto remaining = std::chrono::milliseconds(300) -
+                     std::chrono::duration_cast<std::chrono::milliseconds>(attempt.first - start);
+    EXPECT_LE(attempt.second, remaining);
+    EXPECT_LE(attempt.second, previous);
+    previous = attempt.second;
+  }
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
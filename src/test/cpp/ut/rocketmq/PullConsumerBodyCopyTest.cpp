@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "AwaitPullCallback.h"
+#include "ClientManagerFactory.h"
+#include "ClientManagerMock.h"
+#include "PullConsumerImpl.h"
+#include "Scheduler.h"
+#include "StaticNameServerResolver.h"
+#include "rocketmq/AsyncCallback.h"
+#include "rocketmq/MQMessageExt.h"
+#include "rocketmq/RocketMQ.h"
+
+#include "gtest/gtest.h"
+
+// Counts heap allocations large enough to hold a message body while armed. Replacing the global allocation functions
+// affects the whole binary, hence a test target of its own.
+static std::atomic<bool> count_body_allocations{false};
+static std::atomic<int> body_allocations{0};
+static const std::size_t BODY_SIZE = 4096;
+
+void* operator new(std::size_t size) {
+  if (size >= BODY_SIZE && count_body_allocations.load(std::memory_order_relaxed)) {
+    body_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  void* ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class PullConsumerBodyCopyTest : public testing::Test {
+public:
+  void SetUp() override {
+    grpc_init();
+    scheduler_ = std::make_shared<SchedulerImpl>();
+    name_server_resolver_ = std::make_shared<StaticNameServerResolver>(name_server_list_);
+
+    scheduler_->start();
+    client_manager_ = std::make_shared<testing::NiceMock<ClientManagerMock>>();
+    ON_CALL(*client_manager_, getScheduler).WillByDefault(testing::Return(scheduler_));
+    ClientManagerFactory::getInstance().addClientManager(resource_namespace_, client_manager_);
+
+    pull_consumer_ = std::make_shared<PullConsumerImpl>(group_);
+    pull_consumer_->withNameServerResolver(name_server_resolver_);
+    pull_consumer_->resourceNamespace(resource_namespace_);
+
+    {
+      std::vector<Partition> partitions;
+      Topic topic(resource_namespace_, topic_);
+      std::vector<Address> broker_addresses{Address(broker_host_, broker_port_)};
+      ServiceAddress service_address(AddressScheme::IPv4, broker_addresses);
+      Broker broker(broker_name_, broker_id_, service_address);
+      Partition partition(topic, queue_id_, Permission::READ_WRITE, broker);
+      partitions.emplace_back(partition);
+      std::string debug_string;
+      topic_route_data_ = std::make_shared<TopicRouteData>(partitions, debug_string);
+    }
+  }
+
+  void TearDown() override {
+    grpc_shutdown();
+    scheduler_->shutdown();
+  }
+
+protected:
+  std::string resource_namespace_{"mq://test"};
+  std::string name_server_list_{"10.0.0.1:9876"};
+  std::shared_ptr<NameServerResolver> name_server_resolver_;
+  std::string group_{"Group-0"};
+  std::string topic_{"Test"};
+  std::shared_ptr<testing::NiceMock<ClientManagerMock>> client_manager_;
+  std::shared_ptr<PullConsumerImpl> pull_consumer_;
+  SchedulerSharedPtr scheduler_;
+  std::string broker_name_{"broker-a"};
+  int broker_id_{0};
+  std::string broker_host_{"10.0.0.1"};
+  int broker_port_{10911};
+  int queue_id_{1};
+  TopicRouteDataPtr topic_route_data_;
+  int batch_size_{32};
+};
+
+TEST_F(PullConsumerBodyCopyTest, testPullWithoutBodyCopies) {
+  pull_consumer_->start();
+  auto mock_resolve_route =
+      [this](const std::string& target_host, const Metadata& metadata, const QueryRouteRequest& request,
+             std::chrono::milliseconds timeout,
+             const std::function<void(const std::error_code& ec, const TopicRouteDataPtr& ptr)>& cb) {
+        std::error_code ec;
+        cb(ec, topic_route_data_);
+      };
+
+  EXPECT_CALL(*client_manager_, resolveRoute)
+      .Times(testing::AtLeast(1))
+      .WillRepeatedly(testing::Invoke(mock_resolve_route));
+
+  std::error_code ec;
+  ReceiveMessageResult result;
+  std::vector<const char*> bodies;
+  for (int i = 0; i < batch_size_; i++) {
+    MQMessageExt message;
+    message.setTopic(topic_);
+    message.setBody(std::string(BODY_SIZE, 'x'));
+    bodies.push_back(message.getBody().data());
+    result.messages.emplace_back(std::move(message));
+  }
+
+  auto mock_pull_message = [&](const std::string& target_host, const Metadata& metadata,
+                               const PullMessageRequest& request, std::chrono::milliseconds timeout,
+                               const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
+    cb(ec, result);
+  };
+
+  EXPECT_CALL(*client_manager_, pullMessage).Times(1).WillOnce(testing::Invoke(mock_pull_message));
+
+  std::future<std::vector<MQMessageQueue>> future = pull_consumer_->queuesFor(topic_);
+  auto queues = future.get();
+  EXPECT_FALSE(queues.empty());
+
+  PullMessageQuery query;
+  query.message_queue = *queues.begin();
+  query.offset = 0;
+  query.await_time = std::chrono::seconds(3);
+
+  std::vector<MQMessageExt> messages;
+  PullResult pull_result(0, 0, 0, messages);
+  AwaitPullCallback callback(pull_result);
+
+  body_allocations.store(0);
+  count_body_allocations.store(true);
+  pull_consumer_->pull(query, &callback);
+  EXPECT_TRUE(callback.await());
+  count_body_allocations.store(false);
+
+  EXPECT_EQ(0, body_allocations.load());
+  ASSERT_EQ(static_cast<std::size_t>(batch_size_), pull_result.messages().size());
+  for (int i = 0; i < batch_size_; i++) {
+    EXPECT_EQ(bodies[i], pull_result.messages()[i].getBody().data());
+  }
+
+  pull_consumer_->shutdown();
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -122,6 +122,9 @@ class TestPullCallback : public PullCallback {
 public:
   TestPullCallback(bool& success, bool& failure) : success_(success), failure_(failure) {
   }
+
+  using PullCallback::onSuccess;
+
   void onSuccess(const PullResult& pull_result) noexcept override {
     success_ = true;
     failure_ = false;
@@ -164,7 +167,7 @@ TEST_F(PullConsumerImplTest, testPull) {
 
   auto mock_pull_message = [&](const std::string& target_host, const Metadata& metadata,
                                const PullMessageRequest& request, std::chrono::milliseconds timeout,
-                               const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) {
+                               const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
     cb(ec, result);
   };
 
@@ -211,7 +214,7 @@ TEST_F(PullConsumerImplTest, testPull_gRPC_error) {
   ReceiveMessageResult result;
   auto mock_pull_message = [&](const std::string& target_host, const Metadata& metadata,
                                const PullMessageRequest& request, std::chrono::milliseconds timeout,
-                               const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) {
+                               const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
     ec = ErrorCode::BadRequest;
     cb(ec, result);
   };
@@ -260,7 +263,7 @@ TEST_F(PullConsumerImplTest, testPull_biz_error) {
 
   auto mock_pull_message = [&](const std::string& target_host, const Metadata& metadata,
                                const PullMessageRequest& request, std::chrono::milliseconds timeout,
-                               const std::function<void(const std::error_code&, const ReceiveMessageResult&)>& cb) {
+                               const std::function<void(const std::error_code&, ReceiveMessageResult&)>& cb) {
     ec = ErrorCode::BadRequest;
     cb(ec, result);
   };
@@ -14,19 +14,32 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 #include <system_error>
 
 #include "ClientManagerFactory.h"
 #include "ClientManagerMock.h"
+#include "FilterExpression.h"
 #include "InvocationContext.h"
 #include "MessageAccessor.h"
+#include "ProcessQueueImpl.h"
 #include "PushConsumerImpl.h"
+#include "ReceiveMessageCallback.h"
+#include "ReceiveMessageResult.h"
 #include "Scheduler.h"
 #include "StaticNameServerResolver.h"
 #include "grpc/grpc.h"
+#include "rocketmq/DuplicateAction.h"
+#include "rocketmq/ErrorCode.h"
 #include "rocketmq/MQMessageExt.h"
 #include "rocketmq/MessageListener.h"
 
@@ -39,6 +52,76 @@ public:
   }
 };
 
+/**
+ * Holds the first message in the listener until told to proceed.
+ */
+class BlockingMessageListener : public StandardMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const std::vector<MQMessageExt>& msgs) override {
+    for (const auto& message : msgs) {
+      absl::MutexLock lk(&mtx_);
+      consumed_.push_back(message.getMsgId());
+    }
+    if (!entered_.HasBeenNotified()) {
+      entered_.Notify();
+    }
+    proceed_.WaitForNotification();
+    return ConsumeMessageResult::SUCCESS;
+  }
+
+  std::vector<std::string> consumed() {
+    absl::MutexLock lk(&mtx_);
+    return consumed_;
+  }
+
+  absl::Notification entered_;
+  absl::Notification proceed_;
+
+private:
+  absl::Mutex mtx_;
+  std::vector<std::string> consumed_ GUARDED_BY(mtx_);
+};
+
+/**
+ * Records messages consumed, along with whether they are flagged as duplicates.
+ */
+class RecordingMessageListener : public StandardMessageListener {
+public:
+  ConsumeMessageResult consumeMessage(const std::vector<MQMessageExt>& msgs) override {
+    absl::MutexLock lk(&mtx_);
+    for (const auto& message : msgs) {
+      consumed_.push_back(message.getMsgId());
+      flagged_.push_back(message.getProperty(DUPLICATE_PROPERTY_KEY) == "true");
+    }
+    cv_.SignalAll();
+    return ConsumeMessageResult::SUCCESS;
+  }
+
+  bool await(std::size_t count) {
+    absl::MutexLock lk(&mtx_);
+    absl::Time deadline = absl::Now() + absl::Seconds(10);
+    while (consumed_.size() < count && !cv_.WaitWithDeadline(&mtx_, deadline)) {
+    }
+    return consumed_.size() >= count;
+  }
+
+  std::vector<std::string> consumed() {
+    absl::MutexLock lk(&mtx_);
+    return consumed_;
+  }
+
+  std::vector<bool> flagged() {
+    absl::MutexLock lk(&mtx_);
+    return flagged_;
+  }
+
+private:
+  absl::Mutex mtx_;
+  absl::CondVar cv_;
+  std::vector<std::string> consumed_ GUARDED_BY(mtx_);
+  std::vector<bool> flagged_ GUARDED_BY(mtx_);
+};
+
 class PushConsumerImplTest : public testing::Test {
 public:
   PushConsumerImplTest() : message_listener_(absl::make_unique<TestStandardMessageListener>()) {
@@ -79,6 +162,21 @@ protected:
   std::unique_ptr<MessageListener> message_listener_;
   std::shared_ptr<PushConsumerImpl> push_consumer_;
   const std::string target_endpoint_{"localhost:10911"};
+
+  MQMessageExt messageOf(const std::string& message_id) {
+    MQMessageExt message;
+    message.setTopic(topic_);
+    message.setBody(message_body_);
+    MessageAccessor::setMessageId(message, message_id);
+    MessageAccessor::setReceiptHandle(message, "handle-" + message_id);
+    MessageAccessor::setTargetEndpoint(message, target_endpoint_);
+    return message;
+  }
+
+  std::shared_ptr<ProcessQueueImpl> processQueue() {
+    MQMessageQueue message_queue(topic_, "broker-a", 0);
+    return std::make_shared<ProcessQueueImpl>(message_queue, FilterExpression(tag_), push_consumer_, client_manager_);
+  }
 };
 
 TEST_F(PushConsumerImplTest, testAck) {
@@ -202,4 +300,353 @@ TEST_F(PushConsumerImplTest, testForward) {
   push_consumer_->shutdown();
 }
 
+TEST_F(PushConsumerImplTest, testRenewalSurvivesNotFound) {
+  int renewals = 0;
+  std::error_code reply = ErrorCode::NotFound;
+  auto change_invisible_duration_cb =
+      [&](const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+          std::chrono::milliseconds timeout,
+          const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) {
+        renewals++;
+        ChangeInvisibleDurationResponse response;
+        cb(reply, response);
+      };
+  EXPECT_CALL(*client_manager_, changeInvisibleDuration)
+      .WillRepeatedly(testing::Invoke(change_invisible_duration_cb));
+
+  push_consumer_->start();
+
+  MQMessageExt message;
+  message.setTopic(topic_);
+  MessageAccessor::setMessageId(message, "msg-0");
+  MessageAccessor::setReceiptHandle(message, "expired-handle");
+  MessageAccessor::setTargetEndpoint(message, target_endpoint_);
+  // Decoded long ago, so the message is due for renewal right away.
+  MessageAccessor::setDecodedTimestamp(message, absl::Now() - absl::Hours(1));
+  push_consumer_->trackInflight({message});
+
+  // A stale receipt handle drops its batch only; renewal stays enabled.
+  push_consumer_->renewInvisibleDuration();
+  EXPECT_EQ(1, renewals);
+  EXPECT_EQ(0U, push_consumer_->inflightMessages());
+
+  // A broker lacking the RPC turns renewal off.
+  reply = ErrorCode::NotImplemented;
+  MessageAccessor::setMessageId(message, "msg-1");
+  push_consumer_->trackInflight({message});
+  push_consumer_->renewInvisibleDuration();
+  push_consumer_->renewInvisibleDuration();
+  EXPECT_EQ(2, renewals);
+
+  push_consumer_->shutdown();
+}
+
+TEST_F(PushConsumerImplTest, testRenewalBoundedOnNotFound) {
+  int renewals = 0;
+  auto change_invisible_duration_cb =
+      [&](const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+          std::chrono::milliseconds timeout,
+          const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) {
+        renewals++;
+        std::error_code ec = ErrorCode::NotFound;
+        ChangeInvisibleDurationResponse response;
+        cb(ec, response);
+      };
+  EXPECT_CALL(*client_manager_, changeInvisibleDuration)
+      .WillRepeatedly(testing::Invoke(change_invisible_duration_cb));
+
+  push_consumer_->start();
+
+  std::vector<MQMessageExt> messages;
+  for (int i = 0; i < 3; i++) {
+    MQMessageExt message;
+    message.setTopic(topic_);
+    MessageAccessor::setMessageId(message, "msg-" + std::to_string(i));
+    MessageAccessor::setReceiptHandle(message, i ? "handle" : "expired-handle");
+    MessageAccessor::setTargetEndpoint(message, target_endpoint_);
+    MessageAccessor::setDecodedTimestamp(message, absl::Now() - absl::Hours(1));
+    messages.push_back(message);
+  }
+  push_consumer_->trackInflight(messages);
+  EXPECT_EQ(3U, push_consumer_->inflightMessages());
+
+  for (int i = 0; i < 5; i++) {
+    push_consumer_->renewInvisibleDuration();
+  }
+  // All messages of the failed batch are dropped at once rather than renewed over and over.
+  EXPECT_EQ(1, renewals);
+  EXPECT_EQ(0U, push_consumer_->inflightMessages());
+
+  push_consumer_->shutdown();
+}
+
+TEST_F(PushConsumerImplTest, testDrain) {
+  BlockingMessageListener listener;
+  push_consumer_->registerMessageListener(&listener);
+  push_consumer_->drainTimeout(std::chrono::seconds(10));
+
+  std::atomic<int> acks{0};
+  auto ack_cb = [&](const std::string& target_host, const Metadata& metadata, const AckMessageRequest& request,
+                    std::chrono::milliseconds timeout, const std::function<void(const std::error_code&)>& cb) {
+    acks++;
+    std::error_code ec;
+    cb(ec);
+  };
+  EXPECT_CALL(*client_manager_, ack).WillRepeatedly(testing::Invoke(ack_cb));
+
+  absl::Mutex mtx;
+  std::vector<std::string> released;
+  auto change_invisible_duration_cb =
+      [&](const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+          std::chrono::milliseconds timeout,
+          const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) {
+        if (!request.invisible_duration().seconds() && !request.invisible_duration().nanos()) {
+          absl::MutexLock lk(&mtx);
+          for (const auto& entry : request.entries()) {
+            released.push_back(entry.message_id());
+          }
+        }
+        std::error_code ec;
+        ChangeInvisibleDurationResponse response;
+        cb(ec, response);
+      };
+  EXPECT_CALL(*client_manager_, changeInvisibleDuration)
+      .WillRepeatedly(testing::Invoke(change_invisible_duration_cb));
+
+  push_consumer_->start();
+  auto process_queue = processQueue();
+  auto service = push_consumer_->getConsumeMessageService();
+  service->dispatch(process_queue, {messageOf("msg-0")});
+  ASSERT_TRUE(listener.entered_.WaitForNotificationWithTimeout(absl::Seconds(10)));
+
+  std::atomic<bool> stopped{false};
+  std::thread shutdown([&]() {
+    push_consumer_->shutdown();
+    stopped = true;
+  });
+
+  absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (!service->draining() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  ASSERT_TRUE(service->draining());
+
+  // Messages arriving while draining are handed back to broker rather than consumed.
+  service->dispatch(process_queue, {messageOf("msg-1")});
+  {
+    absl::MutexLock lk(&mtx);
+    EXPECT_EQ(std::vector<std::string>{"msg-1"}, released);
+  }
+
+  // Shutdown waits for the listener call in progress.
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_FALSE(stopped);
+  EXPECT_EQ(0, acks);
+
+  listener.proceed_.Notify();
+  shutdown.join();
+  EXPECT_EQ(1, acks);
+  EXPECT_EQ(std::vector<std::string>{"msg-0"}, listener.consumed());
+}
+
+TEST_F(PushConsumerImplTest, testDrainTimeout) {
+  BlockingMessageListener listener;
+  push_consumer_->registerMessageListener(&listener);
+  push_consumer_->drainTimeout(std::chrono::milliseconds(200));
+
+  auto ack_cb = [](const std::string& target_host, const Metadata& metadata, const AckMessageRequest& request,
+                   std::chrono::milliseconds timeout, const std::function<void(const std::error_code&)>& cb) {
+    std::error_code ec;
+    cb(ec);
+  };
+  EXPECT_CALL(*client_manager_, ack).WillRepeatedly(testing::Invoke(ack_cb));
+
+  // Release requests never complete.
+  std::atomic<int> releases{0};
+  auto change_invisible_duration_cb =
+      [&](const std::string& target_host, const Metadata& metadata, const ChangeInvisibleDurationRequest& request,
+          std::chrono::milliseconds timeout,
+          const std::function<void(const std::error_code&, const ChangeInvisibleDurationResponse&)>& cb) {
+        releases++;
+      };
+  EXPECT_CALL(*client_manager_, changeInvisibleDuration)
+      .WillRepeatedly(testing::Invoke(change_invisible_duration_cb));
+
+  push_consumer_->start();
+  auto process_queue = processQueue();
+  auto service = push_consumer_->getConsumeMessageService();
+  service->dispatch(process_queue, {messageOf("msg-0")});
+  ASSERT_TRUE(listener.entered_.WaitForNotificationWithTimeout(absl::Seconds(10)));
+
+  auto begin = std::chrono::steady_clock::now();
+  std::thread shutdown([&]() { push_consumer_->shutdown(); });
+
+  absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (!service->draining() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  ASSERT_TRUE(service->draining());
+  service->dispatch(process_queue, {messageOf("msg-1")});
+  EXPECT_EQ(1, releases);
+  listener.proceed_.Notify();
+
+  shutdown.join();
+  auto elapsed = std::chrono::steady_clock::now() - begin;
+  EXPECT_GE(elapsed, std::chrono::milliseconds(200));
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST_F(PushConsumerImplTest, testSampleLagInClustering) {
+  std::vector<std::string> targets;
+  auto query_offset_cb = [&](const std::string& target_host, const Metadata& metadata,
+                             const QueryOffsetRequest& request, std::chrono::milliseconds timeout,
+                             const std::function<void(const std::error_code&, const QueryOffsetResponse&)>& cb) {
+    targets.push_back(target_host);
+    EXPECT_EQ(rmq::QueryOffsetPolicy::END, request.policy());
+    QueryOffsetResponse response;
+    response.set_offset(100);
+    cb(std::error_code(), response);
+  };
+  EXPECT_CALL(*client_manager_, queryOffset).WillRepeatedly(testing::Invoke(query_offset_cb));
+
+  push_consumer_->start();
+  MQMessageQueue message_queue(topic_, "broker-a", 0);
+  message_queue.serviceAddress(target_endpoint_);
+  auto process_queue = push_consumer_->getOrCreateProcessQueue(message_queue, FilterExpression(tag_));
+  ASSERT_TRUE(process_queue);
+
+  std::vector<MQMessageExt> messages;
+  for (int i = 40; i < 43; i++) {
+    MQMessageExt message = messageOf("msg-" + std::to_string(i));
+    MessageAccessor::setQueueOffset(message, i);
+    messages.push_back(message);
+  }
+  process_queue->accountCache(messages);
+  // One of the received messages is consumed, two remain cached.
+  process_queue->release(message_body_.size());
+
+  push_consumer_->sampleLag();
+  EXPECT_EQ(std::vector<std::string>{target_endpoint_}, targets);
+  auto lags = push_consumer_->queueLags();
+  ASSERT_EQ(1U, lags.size());
+  EXPECT_EQ(message_queue, lags[0].message_queue);
+  EXPECT_EQ(41, lags[0].consumed_offset);
+  EXPECT_EQ(100, lags[0].end_offset);
+  EXPECT_EQ(59, lags[0].lag);
+
+  push_consumer_->shutdown();
+}
+
+TEST_F(PushConsumerImplTest, testDropDuplicate) {
+  RecordingMessageListener listener;
+  push_consumer_->registerMessageListener(&listener);
+  push_consumer_->deduplication(std::chrono::seconds(60), 1024, DuplicateAction::DROP);
+
+  std::atomic<int> acks{0};
+  auto ack_cb = [&](const std::string& target_host, const Metadata& metadata, const AckMessageRequest& request,
+                    std::chrono::milliseconds timeout, const std::function<void(const std::error_code&)>& cb) {
+    acks++;
+    std::error_code ec;
+    cb(ec);
+  };
+  EXPECT_CALL(*client_manager_, ack).WillRepeatedly(testing::Invoke(ack_cb));
+
+  push_consumer_->start();
+  auto process_queue = processQueue();
+  auto service = push_consumer_->getConsumeMessageService();
+  service->dispatch(process_queue, {messageOf("msg-0"), messageOf("msg-1")});
+  ASSERT_TRUE(listener.await(2));
+
+  // Both messages of the batch are remembered once consumed; their redeliveries are acked without being consumed.
+  absl::SleepFor(absl::Milliseconds(100));
+  service->dispatch(process_queue, {messageOf("msg-1"), messageOf("msg-0"), messageOf("msg-2")});
+  ASSERT_TRUE(listener.await(3));
+  absl::SleepFor(absl::Milliseconds(100));
+  auto consumed = listener.consumed();
+  std::sort(consumed.begin(), consumed.end());
+  EXPECT_EQ((std::vector<std::string>{"msg-0", "msg-1", "msg-2"}), consumed);
+  EXPECT_EQ(5, acks);
+
+  push_consumer_->shutdown();
+}
+
+TEST_F(PushConsumerImplTest, testFlagDuplicate) {
+  RecordingMessageListener listener;
+  push_consumer_->registerMessageListener(&listener);
+  push_consumer_->deduplication(std::chrono::seconds(60), 1024, DuplicateAction::FLAG);
+
+  std::atomic<int> acks{0};
+  auto ack_cb = [&](const std::string& target_host, const Metadata& metadata, const AckMessageRequest& request,
+                    std::chrono::milliseconds timeout, const std::function<void(const std::error_code&)>& cb) {
+    acks++;
+    std::error_code ec;
+    cb(ec);
+  };
+  EXPECT_CALL(*client_manager_, ack).WillRepeatedly(testing::Invoke(ack_cb));
+
+  push_consumer_->start();
+  auto process_queue = processQueue();
+  auto service = push_consumer_->getConsumeMessageService();
+  service->dispatch(process_queue, {messageOf("msg-0")});
+  ASSERT_TRUE(listener.await(1));
+  absl::SleepFor(absl::Milliseconds(100));
+
+  // The redelivery still reaches the listener, flagged as a duplicate.
+  service->dispatch(process_queue, {messageOf("msg-0")});
+  ASSERT_TRUE(listener.await(2));
+  EXPECT_EQ((std::vector<std::string>{"msg-0", "msg-0"}), listener.consumed());
+  EXPECT_EQ((std::vector<bool>{false, true}), listener.flagged());
+
+  push_consumer_->shutdown();
+  EXPECT_EQ(2, acks);
+}
+
+TEST_F(PushConsumerImplTest, testPauseAndResumeReceiving) {
+  int receives = 0;
+  std::shared_ptr<ReceiveMessageCallback> pending;
+  auto receive_message_cb = [&](const std::string& target_host, const Metadata& metadata,
+                                const ReceiveMessageRequest& request, std::chrono::milliseconds timeout,
+                                const std::shared_ptr<ReceiveMessageCallback>& cb) {
+    receives++;
+    pending = cb;
+  };
+  EXPECT_CALL(*client_manager_, receiveMessage).WillRepeatedly(testing::Invoke(receive_message_cb));
+
+  // Completes the long poll in flight with no messages, which the receive cycle follows with the next request.
+  auto complete = [&]() {
+    ASSERT_TRUE(pending);
+    std::shared_ptr<ReceiveMessageCallback> cb;
+    cb.swap(pending);
+    cb->onCompletion(std::error_code(), ReceiveMessageResult());
+  };
+
+  push_consumer_->start();
+  MQMessageQueue message_queue(topic_, "broker-a", 0);
+  message_queue.serviceAddress(target_endpoint_);
+  ASSERT_TRUE(push_consumer_->receiveMessage(message_queue, FilterExpression(tag_)));
+  EXPECT_EQ(1, receives);
+  complete();
+  EXPECT_EQ(2, receives);
+
+  // Once the topic is paused, the receive cycle stops after the request in flight.
+  push_consumer_->pause(topic_);
+  complete();
+  EXPECT_EQ(2, receives);
+  ASSERT_TRUE(push_consumer_->receiveMessage(message_queue, FilterExpression(tag_)));
+  EXPECT_EQ(2, receives);
+
+  push_consumer_->resume(topic_);
+  EXPECT_EQ(3, receives);
+
+  // The same goes for a single queue.
+  push_consumer_->pause(message_queue);
+  complete();
+  EXPECT_EQ(3, receives);
+
+  push_consumer_->resume(message_queue);
+  EXPECT_EQ(4, receives);
+
+  push_consumer_->shutdown();
+}
+
 ROCKETMQ_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "ClientManagerMock.h"
+#include "RouteCache.h"
+#include "TopicRouteData.h"
+#include "rocketmq/RocketMQ.h"
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class RouteCacheTest : public testing::Test {
+public:
+  void SetUp() override {
+    client_manager_ = std::make_shared<testing::NiceMock<ClientManagerMock>>();
+    key_ = RouteKey{name_server_, access_key_, resource_namespace_, topic_};
+    route_ = routeOf(0);
+  }
+
+protected:
+  std::shared_ptr<testing::NiceMock<ClientManagerMock>> client_manager_;
+  RouteCache cache_;
+  std::string name_server_{"ipv4:10.0.0.1:9876"};
+  std::string access_key_{"ak"};
+  std::string resource_namespace_{"mq://test"};
+  std::string topic_{"TestTopic"};
+  RouteKey key_;
+  TopicRouteDataPtr route_;
+
+  TopicRouteDataPtr routeOf(int queue_id) {
+    std::vector<Partition> partitions;
+    Topic topic(resource_namespace_, topic_);
+    std::vector<Address> broker_addresses{Address("10.0.0.2", 10911)};
+    ServiceAddress service_address(AddressScheme::IPv4, broker_addresses);
+    Broker broker("broker-a", 0, service_address);
+    partitions.emplace_back(Partition(topic, queue_id, Permission::READ_WRITE, broker));
+    return std::make_shared<TopicRouteData>(partitions, std::string());
+  }
+
+  /**
+   * Each client queries route from the (mocked) name server through its own fetcher.
+   */
+  RouteCache::Fetcher fetcher() {
+    return [this](const RouteCache::Callback& cb) {
+      Metadata metadata;
+      QueryRouteRequest request;
+      request.mutable_topic()->set_resource_namespace(resource_namespace_);
+      request.mutable_topic()->set_name(topic_);
+      client_manager_->resolveRoute(name_server_, metadata, request, std::chrono::seconds(3), cb);
+    };
+  }
+};
+
+TEST_F(RouteCacheTest, testSingleFlightAcrossClients) {
+  RouteCache::Callback pending;
+  EXPECT_CALL(*client_manager_, resolveRoute).Times(1).WillOnce(testing::SaveArg<4>(&pending));
+
+  const int clients = 16;
+  std::atomic<int> notified{0};
+  std::atomic<int> completed{0};
+  for (int i = 0; i < clients; i++) {
+    cache_.subscribe(key_, [&](const TopicRouteDataPtr& route) { notified++; });
+  }
+  EXPECT_EQ(static_cast<std::size_t>(clients), cache_.subscribers(key_));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < clients; i++) {
+    threads.emplace_back([&]() {
+      cache_.getRoute(
+          key_, fetcher(),
+          [&](const std::error_code& ec, const TopicRouteDataPtr& route) {
+            EXPECT_FALSE(ec);
+            EXPECT_EQ(route_, route);
+            completed++;
+          },
+          absl::Seconds(3));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_TRUE(pending);
+  EXPECT_EQ(0, completed.load());
+  std::error_code ec;
+  pending(ec, route_);
+  EXPECT_EQ(clients, completed.load());
+  EXPECT_EQ(clients, notified.load());
+
+  // Periodic refreshes of every client are served by the query just completed.
+  for (int i = 0; i < clients; i++) {
+    cache_.refresh(key_, fetcher(), absl::Seconds(25), absl::Seconds(3));
+  }
+  EXPECT_EQ(route_, cache_.route(key_));
+}
+
+TEST_F(RouteCacheTest, testFanOutChangedRoute) {
+  TopicRouteDataPtr changed = routeOf(1);
+  EXPECT_CALL(*client_manager_, resolveRoute)
+      .Times(3)
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), route_))
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), changed))
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), routeOf(1)));
+
+  std::vector<TopicRouteDataPtr> updates;
+  cache_.subscribe(key_, [&](const TopicRouteDataPtr& route) { updates.push_back(route); });
+
+  bool completed = false;
+  cache_.getRoute(
+      key_, fetcher(), [&](const std::error_code& ec, const TopicRouteDataPtr& route) { completed = true; },
+      absl::Seconds(3));
+  EXPECT_TRUE(completed);
+
+  cache_.refresh(key_, fetcher(), absl::ZeroDuration(), absl::Seconds(3));
+  // An equivalent route is not fanned out again.
+  cache_.refresh(key_, fetcher(), absl::ZeroDuration(), absl::Seconds(3));
+
+  ASSERT_EQ(2U, updates.size());
+  EXPECT_EQ(route_, updates[0]);
+  EXPECT_EQ(changed, updates[1]);
+  EXPECT_EQ(changed, cache_.route(key_));
+}
+
+TEST_F(RouteCacheTest, testFailedQueryIsNotCached) {
+  EXPECT_CALL(*client_manager_, resolveRoute)
+      .Times(2)
+      .WillOnce(testing::InvokeArgument<4>(std::make_error_code(std::errc::timed_out), nullptr))
+      .WillOnce(testing::InvokeArgument<4>(std::error_code(), route_));
+
+  cache_.subscribe(key_, [](const TopicRouteDataPtr& route) {});
+
+  std::error_code failure;
+  cache_.getRoute(
+      key_, fetcher(), [&](const std::error_code& ec, const TopicRouteDataPtr& route) { failure = ec; },
+      absl::Seconds(3));
+  EXPECT_TRUE(failure);
+  EXPECT_FALSE(cache_.route(key_));
+
+  cache_.getRoute(
+      key_, fetcher(), [&](const std::error_code& ec, const TopicRouteDataPtr& route) { EXPECT_FALSE(ec); },
+      absl::Seconds(3));
+  EXPECT_EQ(route_, cache_.route(key_));
+}
+
+TEST_F(RouteCacheTest, testEvictOnLastUnsubscribe) {
+  EXPECT_CALL(*client_manager_, resolveRoute).WillOnce(testing::InvokeArgument<4>(std::error_code(), route_));
+
+  std::uint64_t first = cache_.subscribe(key_, [](const TopicRouteDataPtr& route) {});
+  std::uint64_t second = cache_.subscribe(key_, [](const TopicRouteDataPtr& route) {});
+  cache_.getRoute(
+      key_, fetcher(), [](const std::error_code& ec, const TopicRouteDataPtr& route) {}, absl::Seconds(3));
+
+  cache_.unsubscribe(key_, first);
+  EXPECT_EQ(1U, cache_.subscribers(key_));
+  EXPECT_EQ(route_, cache_.route(key_));
+
+  cache_.unsubscribe(key_, second);
+  EXPECT_EQ(0U, cache_.subscribers(key_));
+  EXPECT_FALSE(cache_.route(key_));
+}
+
+ROCKETMQ_NAMESPACE_END
@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Sql92Filter.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class Sql92FilterTest : public testing::Test {
+public:
+  void SetUp() override {
+    message_.setTags("TagA");
+    message_.setProperty("a", "10");
+    message_.setProperty("b", "2.5");
+    message_.setProperty("region", "hz");
+    message_.setProperty("vip", "true");
+  }
+
+protected:
+  MQMessageExt message_;
+
+  bool accept(const std::string& expression) {
+    std::string error;
+    auto filter = Sql92Filter::compile(expression, error);
+    EXPECT_TRUE(filter) << expression << ": " << error;
+    return filter && filter->accept(message_);
+  }
+
+  bool malformed(const std::string& expression) {
+    std::string error;
+    auto filter = Sql92Filter::compile(expression, error);
+    return !filter && !error.empty();
+  }
+};
+
+TEST_F(Sql92FilterTest, testComparison) {
+  EXPECT_TRUE(accept("a = 10"));
+  EXPECT_TRUE(accept("a <> 11"));
+  EXPECT_TRUE(accept("a > 9 AND a >= 10 AND a < 11 AND a <= 10"));
+  EXPECT_FALSE(accept("a > 10"));
+  EXPECT_TRUE(accept("b > 2"));
+  EXPECT_TRUE(accept("b < 2.6"));
+  EXPECT_TRUE(accept("a > -1"));
+  EXPECT_TRUE(accept("region = 'hz'"));
+  EXPECT_FALSE(accept("region <> 'hz'"));
+  EXPECT_TRUE(accept("vip = TRUE"));
+  EXPECT_TRUE(accept("TAGS = 'TagA'"));
+}
+
+TEST_F(Sql92FilterTest, testLogical) {
+  EXPECT_TRUE(accept("a = 10 OR a = 11"));
+  EXPECT_TRUE(accept("a = 11 OR region = 'hz'"));
+  EXPECT_FALSE(accept("a = 11 AND region = 'hz'"));
+  EXPECT_TRUE(accept("NOT a = 11"));
+  EXPECT_TRUE(accept("(a = 11 OR a = 10) AND (region = 'hz')"));
+  EXPECT_TRUE(accept("a = 10 and region = 'hz'"));
+}
+
+TEST_F(Sql92FilterTest, testNull) {
+  EXPECT_TRUE(accept("c IS NULL"));
+  EXPECT_TRUE(accept("a IS NOT NULL"));
+
+  // Comparisons against missing properties are NULL, which is neither TRUE nor FALSE.
+  EXPECT_FALSE(accept("c = 1"));
+  EXPECT_FALSE(accept("NOT c = 1"));
+  EXPECT_TRUE(accept("c = 1 OR a = 10"));
+  EXPECT_FALSE(accept("c = 1 AND a = 10"));
+}
+
+TEST_F(Sql92FilterTest, testBetweenAndIn) {
+  EXPECT_TRUE(accept("a BETWEEN 1 AND 10"));
+  EXPECT_FALSE(accept("a BETWEEN 11 AND 20"));
+  EXPECT_TRUE(accept("a NOT BETWEEN 11 AND 20"));
+  EXPECT_TRUE(accept("region IN ('hz', 'sh')"));
+  EXPECT_FALSE(accept("region IN ('bj', 'sh')"));
+  EXPECT_TRUE(accept("region NOT IN ('bj', 'sh')"));
+  EXPECT_TRUE(accept("a BETWEEN 1 AND 10 AND region IN ('hz')"));
+}
+
+TEST_F(Sql92FilterTest, testStringLiteral) {
+  message_.setProperty("name", "O'Neil");
+  EXPECT_TRUE(accept("name = 'O''Neil'"));
+}
+
+TEST_F(Sql92FilterTest, testTypeMismatch) {
+  // Non-numeric property compared with number.
+  EXPECT_FALSE(accept("region > 1"));
+  // Strings only support equality.
+  EXPECT_FALSE(accept("region > 'a'"));
+}
+
+TEST_F(Sql92FilterTest, testMalformed) {
+  EXPECT_TRUE(malformed(""));
+  EXPECT_TRUE(malformed("a >"));
+  EXPECT_TRUE(malformed("a = 'unterminated"));
+  EXPECT_TRUE(malformed("(a = 1"));
+  EXPECT_TRUE(malformed("a IN (1, 2)"));
+  EXPECT_TRUE(malformed("a IS 1"));
+  EXPECT_TRUE(malformed("a = 1 b = 2"));
+  EXPECT_TRUE(malformed("a # 1"));
+}
+
+TEST_F(Sql92FilterTest, testShortCircuit) {
+  std::string error;
+  auto filter = Sql92Filter::compile("a = 11 AND region = 'hz'", error);
+  ASSERT_TRUE(filter);
+  const auto& instructions = filter->instructions();
+  ASSERT_FALSE(instructions.empty());
+  EXPECT_EQ(Sql92Filter::OpCode::JumpIfFalse, instructions[3].op_code);
+  EXPECT_EQ(instructions.size(), instructions[3].operand);
+}
+
+ROCKETMQ_NAMESPACE_END
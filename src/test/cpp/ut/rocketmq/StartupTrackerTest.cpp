@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StartupTracker.h"
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class StartupTrackerTest : public testing::Test {
+protected:
+  absl::Time start_{absl::Now()};
+  std::vector<std::string> topics_{"T0", "T1"};
+};
+
+TEST_F(StartupTrackerTest, testNoTopic) {
+  StartupTracker tracker({}, start_);
+  EXPECT_TRUE(tracker.ready());
+  EXPECT_EQ(std::future_status::ready, tracker.readiness().wait_for(std::chrono::seconds(0)));
+}
+
+TEST_F(StartupTrackerTest, testReadiness) {
+  StartupTracker tracker(topics_, start_);
+  std::future<void> readiness = tracker.readiness();
+
+  tracker.routeFetched("T0", true, start_ + absl::Milliseconds(30));
+  tracker.routeFetched("T1", true, start_ + absl::Milliseconds(50));
+  tracker.assigned("T1", true, start_ + absl::Milliseconds(60));
+  EXPECT_FALSE(tracker.ready());
+  EXPECT_EQ(std::future_status::timeout, readiness.wait_for(std::chrono::seconds(0)));
+
+  tracker.assigned("T0", true, start_ + absl::Milliseconds(70));
+  EXPECT_TRUE(tracker.ready());
+  EXPECT_EQ(std::future_status::ready, readiness.wait_for(std::chrono::seconds(0)));
+
+  std::string stats;
+  tracker.report(stats);
+  EXPECT_EQ("Start latency breakdown: topics=2, failed=0, routes=50ms, assignments=40ms, ready=70ms", stats);
+}
+
+TEST_F(StartupTrackerTest, testFailure) {
+  StartupTracker tracker(topics_, start_);
+  tracker.routeFetched("T0", false, start_ + absl::Milliseconds(10));
+  tracker.routeFetched("T1", true, start_ + absl::Milliseconds(10));
+  tracker.assigned("T1", false, start_ + absl::Milliseconds(20));
+  EXPECT_TRUE(tracker.ready());
+
+  // Late or repeated notifications are ignored.
+  tracker.assigned("T0", true, start_ + absl::Milliseconds(90));
+
+  std::string stats;
+  tracker.report(stats);
+  EXPECT_EQ("Start latency breakdown: topics=2, failed=2, routes=10ms, assignments=10ms, ready=20ms", stats);
+}
+
+TEST_F(StartupTrackerTest, testPendingStages) {
+  StartupTracker tracker(topics_, start_);
+  std::string stages;
+  tracker.pendingStages(stages);
+  EXPECT_EQ("route of T0, route of T1", stages);
+
+  tracker.routeFetched("T1", true, start_ + absl::Milliseconds(10));
+  tracker.pendingStages(stages);
+  EXPECT_EQ("assignment of T1, route of T0", stages);
+
+  tracker.routeFetched("T0", false, start_ + absl::Milliseconds(20));
+  tracker.assigned("T1", true, start_ + absl::Milliseconds(30));
+  tracker.pendingStages(stages);
+  EXPECT_TRUE(stages.empty());
+}
+
+TEST_F(StartupTrackerTest, testFirstContact) {
+  StartupTracker tracker(topics_, start_);
+  absl::flat_hash_set<std::string> hosts{"10.0.0.1:8081", "10.0.0.2:8081"};
+  tracker.firstContact(hosts);
+  EXPECT_EQ(2, hosts.size());
+
+  hosts = {"10.0.0.2:8081", "10.0.0.3:8081"};
+  tracker.firstContact(hosts);
+  EXPECT_EQ(1, hosts.size());
+  EXPECT_TRUE(hosts.contains("10.0.0.3:8081"));
+}
+
+ROCKETMQ_NAMESPACE_END
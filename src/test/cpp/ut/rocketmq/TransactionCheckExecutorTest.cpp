@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "CountdownLatch.h"
+#include "TransactionCheckExecutor.h"
+#include "rocketmq/LocalTransactionStateChecker.h"
+#include "rocketmq/MQMessageExt.h"
+#include "gtest/gtest.h"
+
+ROCKETMQ_NAMESPACE_BEGIN
+
+class SleepingChecker : public LocalTransactionStateChecker {
+public:
+  explicit SleepingChecker(std::chrono::milliseconds delay) : delay_(delay) {
+  }
+
+  TransactionState checkLocalTransactionState(const MQMessageExt& message) override {
+    std::this_thread::sleep_for(delay_);
+    checks_.fetch_add(1);
+    return TransactionState::COMMIT;
+  }
+
+  int checks() const {
+    return checks_.load();
+  }
+
+private:
+  std::chrono::milliseconds delay_;
+  std::atomic<int> checks_{0};
+};
+
+class TransactionCheckExecutorTest : public testing::Test {
+public:
+  void SetUp() override {
+    executor_ = std::make_shared<TransactionCheckExecutor>(2, 4);
+    executor_->start();
+  }
+
+  void TearDown() override {
+    executor_->shutdown();
+  }
+
+protected:
+  std::shared_ptr<TransactionCheckExecutor> executor_;
+  SleepingChecker checker_{std::chrono::milliseconds(200)};
+  MQMessageExt message_;
+
+  TransactionCheckExecutor::Task check(CountdownLatch& latch) {
+    return [this, &latch](const TransactionCheckExecutor::Completion& completion) {
+      checker_.checkLocalTransactionState(message_);
+      completion();
+      latch.countdown();
+    };
+  }
+};
+
+TEST_F(TransactionCheckExecutorTest, testSubmitDoesNotBlock) {
+  CountdownLatch latch(4);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(executor_->submit("txn-" + std::to_string(i), check(latch)));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(100));
+
+  latch.await();
+  EXPECT_EQ(4, checker_.checks());
+  EXPECT_EQ(0U, executor_->pending());
+}
+
+TEST_F(TransactionCheckExecutorTest, testDeduplicate) {
+  CountdownLatch latch(2);
+  EXPECT_TRUE(executor_->submit("txn-0", check(latch)));
+  EXPECT_FALSE(executor_->submit("txn-0", check(latch)));
+  EXPECT_EQ(1U, executor_->pending());
+
+  while (executor_->pending()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(executor_->submit("txn-0", check(latch)));
+  latch.await();
+  EXPECT_EQ(2, checker_.checks());
+}
+
+TEST_F(TransactionCheckExecutorTest, testCapacity) {
+  CountdownLatch latch(4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(executor_->submit("txn-" + std::to_string(i), check(latch)));
+  }
+  EXPECT_FALSE(executor_->submit("txn-4", check(latch)));
+
+  latch.await();
+  std::string stats;
+  executor_->reportAndReset(stats);
+  EXPECT_NE(std::string::npos, stats.find("accepted=4"));
+  EXPECT_NE(std::string::npos, stats.find("rejected=1"));
+}
+
+TEST_F(TransactionCheckExecutorTest, testCompletionOutlivesCheck) {
+  CountdownLatch latch(1);
+  TransactionCheckExecutor::Completion report;
+  EXPECT_TRUE(executor_->submit("txn-0", [&](const TransactionCheckExecutor::Completion& completion) {
+    report = completion;
+    latch.countdown();
+  }));
+  latch.await();
+
+  // The check stays pending until its resolution is reported.
+  EXPECT_EQ(1U, executor_->pending());
+  EXPECT_FALSE(executor_->submit("txn-0", [](const TransactionCheckExecutor::Completion& completion) {}));
+  report();
+  EXPECT_EQ(0U, executor_->pending());
+}
+
+ROCKETMQ_NAMESPACE_END